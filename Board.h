@@ -78,6 +78,9 @@ extern "C" {
 #define Board_UART_wifi             nbox_UARTA0
 #define Board_UART_debug            nbox_UARTA1
 
+#define Board_uart_tx_pin           nbox_uart_tx_pin
+#define Board_wifi_sense_edge       nbox_wifi_sense_edge
+
 
 #define Board_WATCHDOG0             nbox_WATCHDOG
 
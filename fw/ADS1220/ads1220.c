@@ -32,6 +32,7 @@
 #include "../../Board.h"
 
 #include "../load_cell.h"
+#include "../trace.h"
 
 extern Semaphore_Handle semLoadCellDRDY;
 
@@ -173,17 +174,10 @@ void ads1220_read(struct Ads1220 *ads)
 
 void ads1220_convert_temperature(struct Ads1220 *ads)
 {
+	// 14 bit two's complement, left justified in the 24 bit result. data is already sign extended
+	// by ads1220_event(), so an arithmetic shift leaves the temperature in 1/32 degC (0.03125 degC/LSB)
 	ads->data = (ads->data)>>10;
-	if(ads->rx_buf[0] & 0x80) //negative number!
-	{
-		ads->data = ads->data - 1;
-		ads->data = ~(ads->data);
-		ads->temperature = (float)(ads->data) * (-0.03125);
-	}
-	else
-	{
-		ads->temperature = (float)(ads->data) * (0.03125);
-	}
+	ads->temperature = (int16_t)(ads->data);
 }
 
 // Check end of transaction
@@ -199,6 +193,8 @@ void ads1220_event(struct Ads1220 *ads)
     		{
    			ads->data = ads->data | 0xFF000000; //account for the two's complement minus sign.
     		}
+		if(ads->config.temp_sensor == ADS1220_TEMPERATURE_DISABLED)
+			trace_loadcell_sample(ads->data);
 		ads->data_available = true;
 		ads->spi_trans.status = SPITransDone;
     }
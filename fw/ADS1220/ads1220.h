@@ -81,8 +81,8 @@ enum Ads1220Gain {
 };
 
 // Real gain table
-static const float Ads1220GainTable[] = {
-  1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f, 128.0f
+static const uint8_t Ads1220GainTable[] = {
+  1, 2, 4, 8, 16, 32, 64, 128
 };
 
 // Data sample in normal mode
@@ -191,7 +191,7 @@ struct Ads1220 {
   int32_t data;                                ///< raw ADC value
   int32_t stable_weight;
   int32_t tolerance;
-  float temperature;
+  int16_t temperature;                        ///< in 1/32 degC
   volatile bool data_available;               ///< data ready flag
 };
 
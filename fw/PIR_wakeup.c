@@ -16,6 +16,7 @@
 #include "PIR_wakeup.h"
 #include "load_cell.h"
 #include "logger.h"
+#include "service_loop.h"
 #include "../Board.h"
 
 #include <ti/sysbios/hal/Hwi.h>
@@ -28,26 +29,33 @@
 
 unsigned int int_pin = 0;
 
-void PIR_wakeup_Task()
+void PIR_wakeup_start()
 {
 	GPIO_enableInt(nbox_pir_in1);
     GPIO_enableInt(nbox_pir_in2);
+}
 
+void PIR_wakeup_handle()
+{
+	//Send out data on serial port
+	log_write_new_entry('I', int_pin);
+
+    GPIO_enableInt(nbox_pir_in1);
+    GPIO_enableInt(nbox_pir_in2);
+}
+
+void PIR_wakeup_Task()
+{
+	PIR_wakeup_start();
 
 	while(1)
 	{
 		Semaphore_pend((Semaphore_Handle)semPIRwakeup, BIOS_WAIT_FOREVER);
 
-		//Send out data on serial port
-		log_write_new_entry('I', int_pin);
-
-
 //		Task_sleep(10); //avoid too many subsequent memory readouts
         Semaphore_reset((Semaphore_Handle)semPIRwakeup,0);
 
-        GPIO_enableInt(nbox_pir_in1);
-        GPIO_enableInt(nbox_pir_in2);
-
+        PIR_wakeup_handle();
 	}
 }
 
@@ -59,7 +67,11 @@ void PIR_wakeup_isr(unsigned int index)
     GPIO_disableInt(nbox_pir_in2);
     int_pin = index;
 	//check interrupt source
+#if USE_EVENT_LOOP
+	service_post(SERVICE_EVT_PIR);
+#else
 	Semaphore_post((Semaphore_Handle)semPIRwakeup);
+#endif
 }
 
 #endif
@@ -10,6 +10,10 @@
 
 void PIR_wakeup_Task();
 
+// for the service loop (service_loop.c): enable the interrupts once, handle every SERVICE_EVT_PIR
+void PIR_wakeup_start();
+void PIR_wakeup_handle();
+
 void PIR_wakeup_isr(unsigned int index);
 
 #endif /* FW_PIR_WAKEUP_H_ */
@@ -12,6 +12,10 @@
 #include "logger.h"
 #include "rtc.h"
 #include "user_button.h"
+#include "params.h"
+#include "energy.h"
+#include "periodic.h"
+#include "deep_pause.h"
 #include <xdc/cfg/global.h> //needed for semaphore
 #include <ti/sysbios/knl/Semaphore.h>
 
@@ -33,7 +37,6 @@ volatile uint8_t ADC_summing = 0;
 #define BAT_FS		(BAT_FULL_16-BAT_EMPTY_16)
 
 #define BAT_N_MEAS_BELOW_THRESHOLD		6	// if measured N times a voltage below threshold, turn off everything!
-#define BAT_TEST_INTERVAL				30000 //milliseconds
 
 //enum adc_status_{
 //	IDLE, 	//not in use, and not to be triggered
@@ -90,8 +93,8 @@ void ADC_update()
 
 void store_result()
 {
-	float vbat = ADC_val;
-	vbat = vbat * 0.1047; // (1000/2^12*2.5*(82+47)/47/16) --> mV;
+	uint32_t vbat = ADC_val;
+	vbat = (vbat * 1047UL) / 10000; // *0.1047 = (1000/2^12*2.5*(82+47)/47/16) --> mV;
 
 	last_vbat = (uint16_t)vbat;
 	log_write_new_entry('P', last_vbat);
@@ -146,69 +149,109 @@ void goto_deepsleep()
 	__bis_SR_register(LPM4_bits);        // Enter LPM4 with interrupts
 }
 
-void battery_Task()
-{
-	Task_sleep(2000);
+static uint8_t below_threshold_counter = 0;
 
-    log_write_new_entry('E', 111); // startup symbol
+static void battery_measure()
+{
+	//Test battery status every 5 minutes
+	GPIO_write(nbox_vbat_test_enable,1);
+	//100 us turn-on time max
+	ADC_update();
+	GPIO_write(nbox_vbat_test_enable,0);
+	store_result();
+
+	if(ADC_val < BAT_EMPTY_16)
+		below_threshold_counter++;
+	else
+		below_threshold_counter=0;
 
-	ADC_init();
-	uint8_t counter=0;
+	if(below_threshold_counter > BAT_N_MEAS_BELOW_THRESHOLD)
+		goto_deepsleep();
+}
 
-	while(1)
+static void battery_check_pause()
+{
+	// Check RTC for system pause schedule:
+	int rtc_state = rtc_is_it_time_to_pause();
+	if(rtc_state && !user_wifi_enabled() && !log_sd_card_busy())
 	{
-		//Test battery status every 5 minutes
-		GPIO_write(nbox_vbat_test_enable,1);
-		//100 us turn-on time max
-		ADC_update();
-		GPIO_write(nbox_vbat_test_enable,0);
-		store_result();
-
-		if(ADC_val < BAT_EMPTY_16)
-			counter++;
-		else
-			counter=0;
-
-		if(counter > BAT_N_MEAS_BELOW_THRESHOLD)
-			goto_deepsleep();
-
-
-		Task_sleep(BAT_TEST_INTERVAL); //300000
-
-		// Check RTC for system pause schedule:
-		int rtc_state = rtc_is_it_time_to_pause();
-		if(rtc_state && !user_wifi_enabled() && !log_sd_card_busy())
-		{
-		    // shut down system for the day:
-		    //write stored data to flash before power down
-		    log_write_new_entry('E', 0);
-
-		    if(rtc_state == 2) //means that this is the end of the nightshift.
-		        log_restart();
+	    // shut down system for the day:
+	    //write stored data to flash before power down
+	    log_write_new_entry('E', 0);
+
+	    if(rtc_state == 2) //means that this is the end of the nightshift.
+	        log_restart();
+
+        // power off all modules
+        GPIO_write(nbox_vbat_test_enable, 0);
+        GPIO_write(nbox_sdcard_enable_n, 1);
+        GPIO_write(nbox_5v_enable, 0);
+        energy_off(ENERGY_SD_CARD);
+        energy_off(ENERGY_5V);
+        load_cell_power_down();
+        GPIO_write(Board_led_data, Board_LED_OFF);
+        GPIO_write(Board_led_status, Board_LED_OFF);
+
+//        GPIO_write(nbox_loadcell_ldo_enable, 0); // LDO UNUSED; BECAUSE WHEN OFF, THIS DRAWS TOO MUCH CURRENT!!
+
+#if USE_DEEP_PAUSE
+        // RAM is lost, the RTC alarm or the user button restart the system (deep_pause_init)
+        deep_pause_enter();
+#else
+        // Stop tick and wait for RTC calendar alarm or user button to wake up the system.
+        energy_on(ENERGY_PAUSE);
+        rtc_pause_system();
+
+        Semaphore_reset((Semaphore_Handle)semSystemPause, 0);
+        Semaphore_pend((Semaphore_Handle)semSystemPause, BIOS_WAIT_FOREVER);
+
+        rtc_resume_system();
+        energy_off(ENERGY_PAUSE); // after the system time was updated from the RTC
+
+        // power on modules again:
+//        GPIO_write(nbox_loadcell_ldo_enable, 1);
+        log_write_new_entry('E', 1);
+#endif
+	}
+}
 
-            // power off all modules
-            GPIO_write(nbox_vbat_test_enable, 0);
-            GPIO_write(nbox_sdcard_enable_n, 1);
-            GPIO_write(nbox_5v_enable, 0);
-            load_cell_power_down();
-            GPIO_write(Board_led_data, Board_LED_OFF);
-            GPIO_write(Board_led_status, Board_LED_OFF);
+void battery_start()
+{
+    if(deep_pause_warm_boot())
+    {
+        log_write_new_entry('E', 1); // same as the resume from a normal pause
+    }
+    else
+    {
+        if(!USE_EVENT_LOOP && !deep_pause_fast_start())
+            Task_sleep(2000); // log_Task starts the log meanwhile (service_Task did it already)
+        log_write_new_entry('E', 111); // startup symbol
+        energy_reset(); // after a deep pause, log_startup() continues the counters
+    }
 
-//            GPIO_write(nbox_loadcell_ldo_enable, 0); // LDO UNUSED; BECAUSE WHEN OFF, THIS DRAWS TOO MUCH CURRENT!!
+	ADC_init();
+	below_threshold_counter = 0;
 
-            // Stop tick and wait for RTC calendar alarm or user button to wake up the system.
-            rtc_pause_system();
+	battery_measure();
+}
 
-            Semaphore_reset((Semaphore_Handle)semSystemPause, 0);
-	        Semaphore_pend((Semaphore_Handle)semSystemPause, BIOS_WAIT_FOREVER);
+void battery_step()
+{
+	battery_check_pause();
+	battery_measure();
+}
 
-	        rtc_resume_system();
+void battery_Task()
+{
+	periodic_t period;
 
-	        // power on modules again:
-//            GPIO_write(nbox_loadcell_ldo_enable, 1);
-            log_write_new_entry('E', 1);
-		}
+	battery_start();
+	periodic_start(&period, params_get(PARAM_BAT_TEST_INTERVAL));
 
+	while(1)
+	{
+		periodic_sleep(&period, params_get(PARAM_BAT_TEST_INTERVAL));
+		battery_step();
 	}
 }
 
@@ -11,6 +11,11 @@
 
 
 void battery_Task();
+
+// the battery task split up for the service loop (service_loop.c): start once, then step every PARAM_BAT_TEST_INTERVAL
+void battery_start();
+void battery_step();
+
 void ADC_ISR();
 unsigned int battery_get_vbat();
 
@@ -0,0 +1,83 @@
+/*
+ * clock_policy.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  CPU clock scaling: MCLK is divided down from the 16 MHz DCO while only the slow
+ *  periodic work runs (load cell polling, battery check) and raised for RFID decoding,
+ *  SD flush and wifi. Only the MCLK divider changes: SMCLK (UART, SPI, capture timer,
+ *  ADC) and ACLK (SYS/BIOS tick and time stamps) keep their frequency, so no baud rate,
+ *  prescaler or tick has to be reconfigured. Below 8 MHz the FRAM needs no wait state.
+ */
+
+#include "clock_policy.h"
+
+#include <msp430.h>
+#include <inc/hw_memmap.h>
+#include <cs.h>
+#include <framctl.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#define MCLK_SLOW_DIVIDER       CS_CLOCK_DIVIDER_4  // CLOCK_MCLK_FAST_HZ / CLOCK_MCLK_SLOW_HZ
+
+static uint8_t fast_users = 0;
+static uint8_t fast = 1;    // Boot.configureDCO starts with the full speed
+
+static void clock_set(uint8_t new_fast)
+{
+    Types_FreqHz freq;
+
+    if(new_fast == fast)
+        return;
+
+    if(new_fast)
+    {
+        // wait state first, then the higher frequency
+        FRAMCtl_configureWaitStateControl(FRAMCTL_ACCESS_TIME_CYCLES_1);
+        CS_initClockSignal(CS_MCLK, CS_DCOCLK_SELECT, CS_CLOCK_DIVIDER_1);
+    }
+    else
+    {
+        CS_initClockSignal(CS_MCLK, CS_DCOCLK_SELECT, MCLK_SLOW_DIVIDER);
+        FRAMCtl_configureWaitStateControl(FRAMCTL_ACCESS_TIME_CYCLES_0);
+    }
+    fast = new_fast;
+
+    // keep BIOS_getCpuFreq() right for the code that converts CPU cycles
+    freq.hi = 0;
+    freq.lo = clock_get_mclk();
+    BIOS_setCpuFreq(&freq);
+}
+
+void clock_policy_init()
+{
+    unsigned int key = Hwi_disable();
+    clock_set(fast_users != 0);
+    Hwi_restore(key);
+}
+
+void clock_request_fast(uint8_t user)
+{
+    unsigned int key = Hwi_disable();
+    fast_users |= user;
+    clock_set(1);
+    Hwi_restore(key);
+}
+
+void clock_release_fast(uint8_t user)
+{
+    unsigned int key = Hwi_disable();
+    fast_users &= ~user;
+    clock_set(fast_users != 0);
+    Hwi_restore(key);
+}
+
+uint32_t clock_get_mclk()
+{
+    return fast ? CLOCK_MCLK_FAST_HZ : CLOCK_MCLK_SLOW_HZ;
+}
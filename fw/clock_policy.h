@@ -0,0 +1,30 @@
+/*
+ * clock_policy.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_CLOCK_POLICY_H_
+#define FW_CLOCK_POLICY_H_
+
+#include <stdint.h>
+
+#define CLOCK_MCLK_FAST_HZ      16000000    // DCO, ti_sysbios_BIOS.cpuFreq in nestbox_rtos.cfg
+#define CLOCK_MCLK_SLOW_HZ      4000000     // MCLK = DCO/4 while nobody needs the full speed
+
+// users that need the fast MCLK (bit mask)
+#define CLOCK_USER_RFID         0x01    // tag decoding from the capture ISR
+#define CLOCK_USER_SD_CARD      0x02    // log flush to the SD logger
+#define CLOCK_USER_WIFI         0x04    // MIN transfers at high baud rates
+
+// called once from main(): start with the slow MCLK
+void clock_policy_init();
+
+// MCLK runs at CLOCK_MCLK_FAST_HZ while at least one user requested it
+void clock_request_fast(uint8_t user);
+void clock_release_fast(uint8_t user);
+
+uint32_t clock_get_mclk();
+
+#endif /* FW_CLOCK_POLICY_H_ */
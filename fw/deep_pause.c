@@ -0,0 +1,111 @@
+/*
+ * deep_pause.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Daytime pause in LPM3.5 (USE_DEEP_PAUSE): only the RTC keeps running, RAM and the
+ *  RTOS are switched off. The state needed afterwards is kept in FRAM anyway (log write
+ *  and read positions, pause times, parameters, the tare backup of the load cell); the
+ *  energy counters are saved when the pause starts, and a marker in FRAM tells that the
+ *  pause was entered on purpose. The RTC alarm or the user button
+ *  wake the device up with a reset, and this warm boot continues where the pause started.
+ *
+ *  Any other reset than a power up (watchdog, reset pin, software) is a fast start as
+ *  well: the tare from FRAM is used and the start up delays are skipped.
+ */
+
+#include "deep_pause.h"
+#include "logger.h"
+#include "rtc.h"
+#include "energy.h"
+
+#include <msp430.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#define DEEP_PAUSE_MAGIC        0xD5A7
+
+#pragma PERSISTENT(pause_magic)
+static uint16_t pause_magic = 0;
+
+static int warm_boot = 0;
+static int alarm_wake = 0;
+static int fast_start = 0;
+static uint16_t resume_ms = 0;
+
+void deep_pause_init()
+{
+    if(PMMIFG & PMMLPM5IFG)
+    {
+        warm_boot = (pause_magic == DEEP_PAUSE_MAGIC);
+
+        // wake up source, before BIOS_start() enables the interrupts: rtc_isr would
+        // clear RTCAIFG and the resume alarm would look like a user button wake up.
+        alarm_wake = (RTCCTL01 & RTCAIFG) ? 1 : 0;
+        RTCCTL01 &= ~(RTCAIE | RTCAIFG);
+    }
+
+    // highest priority reset cause first; brown out = power up
+    fast_start = warm_boot || (SYSRSTIV != SYSRSTIV_BOR);
+
+    // the marker is used once
+    pause_magic = 0;
+
+    PMMCTL0_H = PMMPW_H;
+    PMMIFG &= ~PMMLPM5IFG;
+    PMMCTL0_H = 0;
+}
+
+int deep_pause_warm_boot()
+{
+    return warm_boot;
+}
+
+int deep_pause_alarm_wake()
+{
+    return alarm_wake;
+}
+
+int deep_pause_fast_start()
+{
+    return fast_start;
+}
+
+void deep_pause_enter()
+{
+    energy_save();
+    pause_magic = DEEP_PAUSE_MAGIC;
+
+    rtc_pause_system(); // alarm at the resume time
+
+    Hwi_disable();
+    PMMCTL0_H = PMMPW_H;
+    PMMCTL0_L |= PMMREGOFF;     // LPM3.5 instead of LPM3
+    PMMCTL0_H = 0;
+    __bis_SR_register(LPM3_bits | GIE);
+    __no_operation();
+
+    // only reached if LPM3.5 was not entered (pending interrupt): restart instead of
+    // hanging without watchdog. Not a warm boot, the pause is taken again after the start.
+    PMMCTL0 = PMMPW | PMMSWBOR;
+    while(1);
+}
+
+void deep_pause_resume_done()
+{
+    uint32_t ms;
+
+    if(!fast_start || resume_ms != 0)
+        return;
+
+    // ticks since BIOS_start(); the boot code before adds a few ms
+    ms = Clock_getTicks();
+    resume_ms = ms > 0xffff ? 0xffff : (ms == 0 ? 1 : ms);
+    log_write_new_entry('Y', resume_ms);
+}
+
+uint16_t deep_pause_get_resume_ms()
+{
+    return resume_ms;
+}
@@ -0,0 +1,33 @@
+/*
+ * deep_pause.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_DEEP_PAUSE_H_
+#define FW_DEEP_PAUSE_H_
+
+#include <stdint.h>
+
+// called once from main() after the board init: detects a wake up from LPM3.5 and the reset cause
+void deep_pause_init();
+
+// 1 if this boot is a resume from the daytime pause with a valid snapshot
+int deep_pause_warm_boot();
+
+// 1 if the RTC resume alarm ended the pause, 0 for the user button (read before BIOS_start)
+int deep_pause_alarm_wake();
+
+// 1 unless the device was just powered up: saved calibration is used and the start up delays are skipped
+int deep_pause_fast_start();
+
+// save the energy counters, mark the pause in FRAM (the other state is persistent already) and
+// power down until the RTC alarm or the user button (does not return)
+void deep_pause_enter();
+
+// the load cell task is ready for detections again: log the time since the restart ('Y', ms)
+void deep_pause_resume_done();
+uint16_t deep_pause_get_resume_ms();
+
+#endif /* FW_DEEP_PAUSE_H_ */
@@ -0,0 +1,206 @@
+/*
+ * energy.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Energy accounting: the time spent in each power state is measured on the device and
+ *  multiplied with a current model, which gives the charge per night and a battery life
+ *  projection ('E' command). The currents are estimates; replace them with measurements
+ *  of the actual hardware. Configurations are compared over a whole season on the host
+ *  (host/bench_energy.c, current model in host/platform/power_sim.c).
+ */
+
+#include "energy.h"
+
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Seconds.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#define ENERGY_BASE_UA          120     // uA, MCU (mostly LPM3), sensors idle
+#define ENERGY_BATTERY_MAH      2000    // 4 x AA NiMH
+#define ENERGY_SNAPSHOT_VALID   0xE5A7
+
+// uA on top of the base current while a state is active (ENERGY_PAUSE: instead of the base current)
+static const uint32_t energy_current_ua[ENERGY_STATE_COUNT] = {
+    25000,  // ENERGY_5V
+    3800,   // ENERGY_LOADCELL: 350 Ohm bridge at 1.2V reference + ADS1220 normal mode
+    20000,  // ENERGY_SD_CARD
+    80000,  // ENERGY_WIFI
+    15,     // ENERGY_PAUSE: LPM4 + RTC
+};
+
+static uint32_t state_ms[ENERGY_STATE_COUNT];
+static uint32_t state_since[ENERGY_STATE_COUNT];
+static uint8_t state_active = 0;   // bit mask
+static uint32_t reset_time = 0;    // Seconds_get() at the last reset
+static uint32_t wakeups = 0;       // idle loop passes (= returns to low power mode) since the last reset
+
+// the counters over a deep pause (LPM3.5 loses the RAM), see energy_save()
+struct energy_snapshot {
+    uint16_t valid;
+    uint32_t state_ms[ENERGY_STATE_COUNT];
+    uint32_t reset_time;
+    uint32_t wakeups;
+    uint32_t pause_since;   // Seconds_get(), the RTC keeps running
+};
+#pragma PERSISTENT(snapshot)
+static struct energy_snapshot snapshot = {0,};
+
+// the tick is stopped during a pause, only the RTC seconds run
+static uint32_t energy_now(uint8_t state)
+{
+    if(state == ENERGY_PAUSE)
+        return Seconds_get();
+    return Clock_getTicks();
+}
+
+static uint32_t energy_to_ms(uint8_t state, uint32_t duration)
+{
+    if(state == ENERGY_PAUSE)
+        return duration*1000;
+    return duration;
+}
+
+void energy_on(uint8_t state)
+{
+    unsigned int key = Hwi_disable();
+    if(!(state_active & (1 << state)))
+    {
+        state_active |= 1 << state;
+        state_since[state] = energy_now(state);
+    }
+    Hwi_restore(key);
+}
+
+void energy_off(uint8_t state)
+{
+    unsigned int key = Hwi_disable();
+    if(state_active & (1 << state))
+    {
+        state_active &= ~(1 << state);
+        state_ms[state] += energy_to_ms(state, energy_now(state) - state_since[state]);
+    }
+    Hwi_restore(key);
+}
+
+void energy_reset()
+{
+    uint8_t i;
+    unsigned int key = Hwi_disable();
+    for(i = 0; i < ENERGY_STATE_COUNT; i++)
+    {
+        state_ms[i] = 0;
+        state_since[i] = energy_now(i);
+    }
+    reset_time = Seconds_get();
+    wakeups = 0;
+    Hwi_restore(key);
+}
+
+// before a deep pause: the running periods end, the pause starts
+void energy_save()
+{
+    uint8_t i;
+    unsigned int key = Hwi_disable();
+    for(i = 0; i < ENERGY_STATE_COUNT; i++)
+        snapshot.state_ms[i] = energy_get_ms(i);
+    snapshot.reset_time = reset_time;
+    snapshot.wakeups = wakeups;
+    snapshot.pause_since = Seconds_get();
+    snapshot.valid = ENERGY_SNAPSHOT_VALID;
+    Hwi_restore(key);
+}
+
+// warm boot after a deep pause, once the time is restored from the RTC; returns 0 (and
+// keeps the counters) without a snapshot
+int energy_restore()
+{
+    uint8_t i;
+    unsigned int key;
+
+    if(snapshot.valid != ENERGY_SNAPSHOT_VALID)
+        return 0;
+
+    key = Hwi_disable();
+    for(i = 0; i < ENERGY_STATE_COUNT; i++)
+    {
+        state_ms[i] = snapshot.state_ms[i];
+        state_since[i] = energy_now(i);
+    }
+    state_ms[ENERGY_PAUSE] += energy_to_ms(ENERGY_PAUSE, Seconds_get() - snapshot.pause_since);
+    state_active = 0;
+    reset_time = snapshot.reset_time;
+    wakeups = snapshot.wakeups;
+    snapshot.valid = 0; // used once
+    Hwi_restore(key);
+    return 1;
+}
+
+Void energy_idle()
+{
+    wakeups++;
+}
+
+uint32_t energy_get_wakeups_per_hour()
+{
+    uint32_t elapsed = energy_get_elapsed();
+    if(elapsed == 0)
+        return 0;
+    return (uint32_t)(((uint64_t)wakeups * 3600) / elapsed);
+}
+
+uint32_t energy_get_ms(uint8_t state)
+{
+    uint32_t ms;
+    unsigned int key = Hwi_disable();
+    ms = state_ms[state];
+    if(state_active & (1 << state))
+        ms += energy_to_ms(state, energy_now(state) - state_since[state]);
+    Hwi_restore(key);
+    return ms;
+}
+
+uint32_t energy_get_elapsed()
+{
+    return Seconds_get() - reset_time;
+}
+
+// uA * ms
+static uint64_t energy_get_charge()
+{
+    uint8_t i;
+    uint64_t elapsed_ms = (uint64_t)energy_get_elapsed()*1000;
+    uint64_t pause_ms = energy_get_ms(ENERGY_PAUSE);
+    uint64_t charge;
+
+    if(pause_ms > elapsed_ms)
+        pause_ms = elapsed_ms;
+    charge = (elapsed_ms - pause_ms) * ENERGY_BASE_UA;
+
+    for(i = 0; i < ENERGY_STATE_COUNT; i++)
+        charge += (uint64_t)energy_get_ms(i) * energy_current_ua[i];
+
+    return charge;
+}
+
+uint32_t energy_get_charge_uah()
+{
+    return (uint32_t)(energy_get_charge() / 3600000UL);
+}
+
+uint32_t energy_get_average_ua()
+{
+    uint32_t elapsed = energy_get_elapsed();
+    if(elapsed == 0)
+        return 0;
+    return (uint32_t)(energy_get_charge() / ((uint64_t)elapsed*1000));
+}
+
+uint32_t energy_get_projected_hours()
+{
+    uint32_t average = energy_get_average_ua();
+    if(average == 0)
+        return 0;
+    return (ENERGY_BATTERY_MAH * 1000UL) / average;
+}
@@ -0,0 +1,50 @@
+/*
+ * energy.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_ENERGY_H_
+#define FW_ENERGY_H_
+
+#include <stdint.h>
+#include <xdc/std.h>
+
+// power states with their own supply current (see energy_current_ua in energy.c)
+enum energy_state {
+    ENERGY_5V = 0,          // 5V rail: RFID reader
+    ENERGY_LOADCELL,        // ADS1220 in continuous conversion, bridge excited
+    ENERGY_SD_CARD,         // SD logger powered
+    ENERGY_WIFI,            // ESP module on, wifi UART open
+    ENERGY_PAUSE,           // system paused until the RTC alarm (tick stopped)
+    ENERGY_STATE_COUNT
+};
+
+void energy_on(uint8_t state);
+void energy_off(uint8_t state);
+
+// restart the accounting
+void energy_reset();
+
+// keep the counters in FRAM over a deep pause (deep_pause.c), and continue them after it
+void energy_save();
+int energy_restore();
+
+// ms spent in the state since the last reset (including a running period)
+uint32_t energy_get_ms(uint8_t state);
+// seconds since the last reset
+uint32_t energy_get_elapsed();
+// estimated charge drawn since the last reset in uAh
+uint32_t energy_get_charge_uah();
+// estimated average current in uA
+uint32_t energy_get_average_ua();
+// hours a full battery lasts at the average current
+uint32_t energy_get_projected_hours();
+
+// idle function (nestbox_rtos.cfg): runs once each time the CPU goes back to low power mode
+Void energy_idle();
+// MCU wake ups per hour since the last reset
+uint32_t energy_get_wakeups_per_hour();
+
+#endif /* FW_ENERGY_H_ */
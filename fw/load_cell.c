@@ -7,6 +7,13 @@
 
 #include "load_cell.h"
 #include "ADS1220/ads1220.h"
+#include "load_cell_thermal.h"
+#include "load_cell_segment.h"
+#include "telemetry.h"
+#include "params.h"
+#include "energy.h"
+#include "periodic.h"
+#include "deep_pause.h"
 
 #include "../Board.h"
 
@@ -14,14 +21,13 @@
 #include "logger.h"
 
 #include <ti/sysbios/hal/Seconds.h>
+#include <ti/sysbios/knl/Clock.h>
 
 #include <xdc/cfg/global.h> //needed for semaphore
 #include <ti/sysbios/knl/Semaphore.h>
 #include <xdc/runtime/Error.h>
 #include <xdc/runtime/System.h>
 
-#define WEIGHT_THRESHOLD 50000 // raw ADC units --> ADC_VAL = 1098.9 * GRAMS + OFFSET; R^2 = 0.99999
-
 #ifdef USE_HX
 	#define SAMPLE_RATE		HX_SAMPLE_RATE //Hz
 #endif
@@ -31,31 +37,57 @@
 
 #define MIN_EVENT_TIME 	    10 //seconds
 #define MIN_ABSENCE_TIME    10 //cycles ~ seconds
-#define N_AVERAGES		    10
+#define N_AVERAGES		    10 // default of PARAM_N_AVERAGES, only used for the buffer size here
 #define EVENT_BUF_SIZE	SAMPLE_RATE*MIN_EVENT_TIME/N_AVERAGES //need to account for 10 averaging window already in place!
 
 #define PLUS_SIGN 		' '
 #define MINUS_SIGN		'-'
 
-#define RFID_TIMEOUT		200 	//ms
-#define T_RFID_RETRY		1000 	//ms
-#define T_LOADCELL_POLL	1000 	//ms
 
 #define TARE_TOLERANCE      6000    // maximum variation to get a new tare value
-#define SAMPLE_TOLERANCE 	1000		// maximum variation of the sampled values within N_AVERAGES samples
+                                    // also: maximum baseline drift before a full tare is run
 #define WEIGHT_TOLERANCE 	50 	// maximum deviation from average value within one measurement series
 //#define WEIGHT_MAX_CHANGE	100	// maximum change within one "event"
 
 //#define RAW_THRESHOLD       1000
 // TODO: above values should be in %FS
 
+#define OFFSET_CHECK_INTERVAL   3600    // polls between two zero offset checks (ca. 1 hour)
+#define BASELINE_FILTER_SHIFT   6       // baseline follows idle polls with a weight of 1/2^6
+#define BASELINE_GATE           3000    // idle polls further away from the baseline are ignored
+#define BASELINE_MAX_OUTLIERS   600     // consecutive ignored polls (ca. 10 min) that force a full tare
+#define SAVED_TARE_CHECK        (4 << BASELINE_FILTER_SHIFT) // idle polls until a restored tare is checked
+#define SAVED_TARE_VALID        0x7A5E
+
 Semaphore_Handle semLoadCellDRDY;
 
 static int32_t last_stored_weight = 0;
 static int32_t last_measured_offset = 0;
 static int32_t last_measured_threshold = 0;
+static int16_t last_tare_temperature = 0;
+
+// last accepted zero offsets, restored on a fast start instead of the tare series
+struct saved_tare {
+    uint16_t valid;
+    int32_t cont_offset;
+    int32_t periodic_offset;
+    int32_t cont_threshold;
+    int32_t periodic_threshold;
+    uint32_t time;          // Seconds_get() of the tare or offset update
+    int16_t temperature;    // 1/32 degC, reference of the thermal model
+};
+#pragma PERSISTENT(tare_backup)
+static struct saved_tare tare_backup = {0,};
+
 static int tare_request = 0;
+static int threshold_update_request = 0;
 static int threshold_bypass_request = 0;
+static uint32_t event_start_ticks = 0; // start of the continuous conversion phase
+
+// zero offset tracked from idle polls (single shot mode), scaled by 2^BASELINE_FILTER_SHIFT
+static int32_t baseline_acc = 0;
+static unsigned int baseline_outliers = 0;
+static int tare_unconfirmed = 0; // restored tare, no offset check has agreed with it yet
 
 int32_t get_last_stored_weight()
 {
@@ -70,9 +102,13 @@ int32_t get_weight_threshold()
     return last_measured_threshold;
     // todo
 }
-void set_weight_threshold(int32_t new_th)
+// new threshold above the zero offset (raw ADC units), applied at the next poll
+int set_weight_threshold(int32_t new_th)
 {
-    //todo
+    if(!params_set(PARAM_WEIGHT_THRESHOLD, new_th))
+        return 0;
+    threshold_update_request = 1;
+    return 1;
 }
 
 void load_cell_bypass_threshold(int status)
@@ -95,6 +131,57 @@ typedef enum weightResultStatus_
 } weightResultStatus;
 
 
+// Takes one averaged sample of the running event.
+// returns 1 for a valid sample, 0 if it has to be skipped and -1 if the event is over (*end set).
+static int load_cell_take_sample(struct Ads1220 *ads, uint8_t *type, int32_t *sample, int32_t *deviation, weightResultStatus *end)
+{
+    static unsigned int threshold_cnt = 0;
+
+#ifdef USE_HX
+    *sample = hx711_get_units(params_get(PARAM_N_AVERAGES), deviation);
+#endif
+#ifdef USE_ADS
+    *sample = ads1220_read_average(params_get(PARAM_N_AVERAGES), deviation, ads);
+#endif
+    log_write_new_weight_entry(*type, *sample, 0x0000ffff & *deviation);
+    telemetry_add_sample(*type, *sample);
+    last_stored_weight = *sample;
+
+    if(*sample < ads->cont_threshold || tare_request)
+    {
+        threshold_cnt = threshold_cnt+1;
+
+        if(threshold_cnt>100 || tare_request) // measure zero value 100 times!
+        {
+            threshold_cnt = 0;
+            *end = OWL_LEFT;
+            return -1;
+        }
+        else if(threshold_cnt > MIN_ABSENCE_TIME)
+        {
+            *type = 'O';
+        }
+        return 0;
+    }
+    else
+    {
+        if(*type == 'O') // the owl clearly left and potentially another came back --> re-start the series!
+        {
+            threshold_cnt = 0;
+            *end = OWL_CAME_BACK;
+            return -1;
+        }
+        //else:
+        threshold_cnt = 0;
+    }
+
+    if(*deviation > params_get(PARAM_SAMPLE_TOLERANCE))
+        return 0;
+
+    segment_add_sample(*sample);
+    return 1;
+}
+
 weightResultStatus load_cell_get_stable(struct Ads1220 *ads, uint8_t type) //type = 'X' for owl or 'O' for offset measurement
 {
 	static int32_t meas_buf[EVENT_BUF_SIZE] = {0,};
@@ -105,51 +192,19 @@ weightResultStatus load_cell_get_stable(struct Ads1220 *ads, uint8_t type) //typ
 	int tmp = first_valid;
 	int values_recorded = 0;
 	int32_t deviation = 0;
-
-    static unsigned int threshold_cnt = 0;
+	weightResultStatus end;
 
 	// fill circular buffer with new measurements
 	while(values_recorded < EVENT_BUF_SIZE)
 	{
-#ifdef USE_HX
-		meas_buf[tmp] = hx711_get_units(N_AVERAGES, &deviation);
-#endif
-#ifdef USE_ADS
-		meas_buf[tmp] = ads1220_read_average(N_AVERAGES, &deviation, ads);
-#endif
-		log_write_new_weight_entry(type, meas_buf[tmp], 0x0000ffff & deviation);
-		last_stored_weight = meas_buf[tmp];
-
-		if(meas_buf[tmp] < ads->cont_threshold || tare_request)
-		{
-		    threshold_cnt = threshold_cnt+1;
-
-		    if(threshold_cnt>100 || tare_request) // measure zero value 100 times!
-		    {
-                first_valid = 0;
-                threshold_cnt = 0;
-    //			first_invalid = 0;
-                return OWL_LEFT;
-		    }
-		    else if(threshold_cnt > MIN_ABSENCE_TIME)
-		    {
-		        type = 'O';
-		    }
-		    continue;
-		}
-		else
+		int ret = load_cell_take_sample(ads, &type, &meas_buf[tmp], &deviation, &end);
+		if(ret < 0)
 		{
-		    if(type == 'O') // the owl clearly left and potentially another came back --> re-start the series!
-		    {
-	            threshold_cnt = 0;
-		        return OWL_CAME_BACK;
-		    }
-		    //else:
-            threshold_cnt = 0;
+			if(end == OWL_LEFT)
+				first_valid = 0;
+			return end;
 		}
-
-
-		if(deviation > SAMPLE_TOLERANCE)
+		if(ret == 0)
 			continue;
 
 		tmp = tmp + 1;
@@ -212,6 +267,112 @@ weightResultStatus load_cell_get_stable(struct Ads1220 *ads, uint8_t type) //typ
 	}
 }
 
+#ifdef USE_KALMAN_ESTIMATOR
+
+#define KALMAN_Q            100     // process noise (raw ADC units^2 per sample), the bird moves a bit
+#define KALMAN_R_MIN        16      // measurement noise floor (raw ADC units^2)
+#define KALMAN_GATE         16      // innovation^2 > GATE*(P+R) (4 sigma) --> weight changed, restart
+#define KALMAN_MIN_SAMPLES  4       // never decide on fewer samples
+
+static uint32_t isqrt(uint32_t x)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while(bit > x)
+        bit >>= 2;
+    while(bit)
+    {
+        if(x >= res + bit)
+        {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else
+            res >>= 1;
+        bit >>= 2;
+    }
+    return res;
+}
+
+// Scalar Kalman filter on the averaged samples: stops as soon as the posterior standard
+// deviation is below WEIGHT_TOLERANCE instead of always waiting for EVENT_BUF_SIZE samples.
+weightResultStatus load_cell_get_stable_kalman(struct Ads1220 *ads, uint8_t type) //type = 'X' for owl or 'O' for offset measurement
+{
+    int32_t sample = 0;
+    int32_t deviation = 0;
+    weightResultStatus end;
+
+    int32_t w = 0;      // weight estimate
+    int64_t p = 0;      // estimate variance
+    int n = 0;          // samples since the last (re-)start
+    int values_recorded = 0;
+
+    while(values_recorded < EVENT_BUF_SIZE)
+    {
+        int ret = load_cell_take_sample(ads, &type, &sample, &deviation, &end);
+        if(ret < 0)
+            return end;
+        if(ret == 0)
+            continue;
+
+        values_recorded = values_recorded+1;
+
+        // deviation is max-min over N_AVERAGES samples: sigma ~ dev/3.1, variance of the mean ~ dev^2/95
+        int64_t r = ((int64_t)deviation * deviation) / 95;
+        if(r < KALMAN_R_MIN)
+            r = KALMAN_R_MIN;
+
+        int64_t innovation = sample - w;
+
+        if(n == 0 || innovation*innovation > KALMAN_GATE*(p + r))
+        {
+            w = sample;
+            p = r;
+            n = 1;
+            continue;
+        }
+
+        p = p + KALMAN_Q;
+        w = w + (int32_t)((innovation * p) / (p + r));
+        p = (p * r) / (p + r);
+        n = n + 1;
+
+        if(n >= KALMAN_MIN_SAMPLES && p < (int64_t)WEIGHT_TOLERANCE*WEIGHT_TOLERANCE)
+            break;
+    }
+
+    int32_t tol = isqrt((uint32_t)p);
+    if(tol < ads->tolerance)
+    {
+        ads->stable_weight = w;
+        ads->tolerance = tol;
+        GPIO_write(Board_led_status,1);
+        Task_sleep(200);
+        GPIO_write(Board_led_status,0);
+    }
+
+    if(n >= KALMAN_MIN_SAMPLES && tol < WEIGHT_TOLERANCE)
+    {
+        log_write_new_weight_entry('S', w, tol);
+
+        GPIO_write(Board_led_status,1);
+        Task_sleep(2000);
+        GPIO_write(Board_led_status,0);
+        return STABLE;
+    }
+    else
+    {
+        log_write_new_weight_entry('A', w, tol);
+        return UNSTABLE;
+    }
+}
+
+#define load_cell_get_weight    load_cell_get_stable_kalman
+#else
+#define load_cell_get_weight    load_cell_get_stable
+#endif
+
 void ads1220_set_init_loadcell_config(struct Ads1220 *ads){
 	ads->config.mux = ADS1220_MUX_AIN1_AIN2;
 	ads->config.gain = ADS1220_GAIN_128;
@@ -230,9 +391,168 @@ void ads1220_set_init_loadcell_config(struct Ads1220 *ads){
 
 struct Ads1220 ads;
 
+// single temperature conversion; the ADC is left in the given mode with the temperature sensor off.
+static int16_t load_cell_measure_temperature(enum Ads1220SampleRate rate, enum Ads1220ConvMode mode)
+{
+    ads1220_change_mode(&ads, ADS1220_RATE_20_HZ, ADS1220_CONTINIOUS_CONVERSION, ADS1220_TEMPERATURE_ENABLED);
+    GPIO_enableInt(nbox_loadcell_data_ready);
+
+    Semaphore_reset((Semaphore_Handle)semLoadCellDRDY, 0);
+    ads1220_start_conversion(&ads);
+    Semaphore_pend((Semaphore_Handle)semLoadCellDRDY, 100); // timeout 100 ms in case DRDY pin is not connected
+
+    ads1220_read(&ads);
+    ads1220_event(&ads);
+    ads1220_convert_temperature(&ads);
+
+    ads1220_change_mode(&ads, rate, mode, ADS1220_TEMPERATURE_DISABLED);
+    return ads.temperature;
+}
+
+static uint16_t load_cell_temperature_to_decikelvin(int16_t temperature)
+{
+    // 1/32 degC --> 0.1 K; 273.15 K * 320 = 87408
+    return (uint16_t)(((int32_t)temperature * 10 + 87408 + 16) / 32);
+}
+
+static void load_cell_baseline_reset(int32_t periodic_offset)
+{
+    baseline_acc = periodic_offset * (1L << BASELINE_FILTER_SHIFT);
+    baseline_outliers = 0;
+}
+
+static int32_t load_cell_baseline()
+{
+    return baseline_acc >> BASELINE_FILTER_SHIFT;
+}
+
+// slow exponential filter on the idle polls; readings far off the baseline
+// (somebody on the perch below threshold, spikes) are not taken into account.
+static void load_cell_baseline_update(int32_t sample)
+{
+    int32_t diff = sample - load_cell_baseline();
+
+    if(diff > BASELINE_GATE || diff < -BASELINE_GATE)
+    {
+        if(baseline_outliers < 0xffff)
+            baseline_outliers++;
+        return;
+    }
+
+    baseline_outliers = 0;
+    baseline_acc += diff;
+}
+
+// called after every accepted tare, offset update or new threshold
+static void load_cell_save_tare()
+{
+    tare_backup.valid = 0; // not valid while it is written
+    tare_backup.cont_offset = ads.cont_offset;
+    tare_backup.periodic_offset = ads.periodic_offset;
+    tare_backup.cont_threshold = ads.cont_threshold;
+    tare_backup.periodic_threshold = ads.periodic_threshold;
+    tare_backup.time = Seconds_get();
+    tare_backup.temperature = last_tare_temperature;
+    tare_backup.valid = SAVED_TARE_VALID;
+}
+
+// full tare series; returns 1 if the offsets were accepted.
+static int load_cell_tare(int32_t tolerance, int32_t* deviation)
+{
+    int32_t max_cont_deviation = 0;
+    int32_t max_periodic_deviation = 0;
+
+    ads1220_tare(20, &max_cont_deviation, &max_periodic_deviation, &ads);
+    *deviation = max_cont_deviation + max_periodic_deviation;
+    if(*deviation < tolerance)
+    {
+        ads1220_set_thresholds(&ads, params_get(PARAM_WEIGHT_THRESHOLD));
+        last_measured_offset = ads.cont_offset;
+        last_measured_threshold = ads.periodic_threshold;
+        load_cell_baseline_reset(ads.periodic_offset);
+        last_tare_temperature = load_cell_measure_temperature(ADS1220_RATE_1000_HZ, ADS1220_SINGLE_SHOT);
+        thermal_set_reference(last_tare_temperature);
+        ads1220_powerdown(&ads);
+        load_cell_save_tare();
+        return 1;
+    }
+    return 0;
+}
+
+// offsets from before the reset instead of a new tare series; returns 0 if there are none.
+// Holding the user button at start up forces a new tare (same as the log reset).
+static int load_cell_restore_tare()
+{
+    uint32_t age;
+
+    if(!deep_pause_fast_start() || tare_backup.valid != SAVED_TARE_VALID || GPIO_read(Board_button)==0)
+        return 0;
+
+    ads.cont_offset = tare_backup.cont_offset;
+    ads.periodic_offset = tare_backup.periodic_offset;
+    ads.cont_threshold = tare_backup.cont_threshold;
+    ads.periodic_threshold = tare_backup.periodic_threshold;
+    last_measured_offset = ads.cont_offset;
+    last_measured_threshold = ads.periodic_threshold;
+    load_cell_baseline_reset(ads.periodic_offset);
+    last_tare_temperature = tare_backup.temperature;
+    thermal_set_reference(last_tare_temperature);
+
+    age = (Seconds_get() - tare_backup.time) / 3600; // hours
+    log_write_new_weight_entry('o', ads.cont_offset, age > 0xffff ? 0xffff : age);
+    tare_unconfirmed = 1;
+    return 1;
+}
+
+// Compare the tracked baseline to the zero offset. Small drifts and drifts explained by
+// the temperature model are applied to both offsets directly, only a larger disagreement
+// costs a full tare series. A restored tare gets no outliers at all: if it is off by more
+// than BASELINE_GATE, every idle poll is an outlier and the baseline never moves away from it.
+static void load_cell_check_offset()
+{
+    int32_t drift = load_cell_baseline() - ads.periodic_offset;
+    int32_t deviation = 0;
+    unsigned int max_outliers = tare_unconfirmed ? 0 : BASELINE_MAX_OUTLIERS;
+    int16_t temperature = load_cell_measure_temperature(ADS1220_RATE_1000_HZ, ADS1220_SINGLE_SHOT);
+    ads1220_powerdown(&ads);
+
+    int32_t unexplained = drift - thermal_offset_drift(temperature);
+
+    if(baseline_outliers == 0)
+        thermal_add_idle_point(temperature, load_cell_baseline());
+
+    if(unexplained > TARE_TOLERANCE || unexplained < -TARE_TOLERANCE || baseline_outliers > max_outliers)
+    {
+        if(load_cell_tare(TARE_TOLERANCE, &deviation))
+        {
+            tare_unconfirmed = 0;
+            log_write_new_weight_entry('O', ads.cont_offset, 0x0000ffff & deviation);
+        }
+        else
+            load_cell_baseline_reset(ads.periodic_offset); // keep the old offsets, try again next time
+    }
+    else
+    {
+        tare_unconfirmed = 0;
+        ads.cont_offset += drift;
+        ads.periodic_offset += drift;
+        ads1220_set_thresholds(&ads, params_get(PARAM_WEIGHT_THRESHOLD));
+        last_measured_offset = ads.cont_offset;
+        last_measured_threshold = ads.periodic_threshold;
+        last_tare_temperature = temperature;
+        thermal_set_reference(temperature);
+        load_cell_save_tare();
+
+        if(drift < 0)
+            drift = -drift;
+        log_write_new_weight_entry('O', ads.cont_offset, 0x0000ffff & drift);
+    }
+}
+
 void load_cell_Task()
 {
-	Task_sleep(1000); //wait until things are settled...
+    if(!deep_pause_fast_start())
+        Task_sleep(1000); //wait until things are settled...
 
 	//storage for measurement series
 	char event_ongoing = 0;
@@ -264,24 +584,18 @@ void load_cell_Task()
 
     Task_sleep(100);
 
-	int32_t max_cont_deviation = 0;
-    int32_t max_periodic_deviation = 0;
-
+    int32_t tare_deviation = 0;
 
     // Try to find the zero offset
-    while(1)
+    if(load_cell_restore_tare())
+        offset_counter = OFFSET_CHECK_INTERVAL - SAVED_TARE_CHECK; // check it once the baseline has settled
+    else while(1)
     {
         int i = 1;
         for(i=1; i<20; i++)
         {
-            ads1220_tare(20, &max_cont_deviation, &max_periodic_deviation, &ads);
-            if((max_cont_deviation + max_periodic_deviation) < i*TARE_TOLERANCE)
-            {
-                ads1220_set_thresholds(&ads, WEIGHT_THRESHOLD);
-                last_measured_offset = ads.cont_offset;
-                last_measured_threshold = ads.periodic_threshold;
+            if(load_cell_tare(i*TARE_TOLERANCE, &tare_deviation))
                 break;
-            }
         }
         if(i<20)
             break;
@@ -295,6 +609,11 @@ void load_cell_Task()
 	Semaphore_pend((Semaphore_Handle)semLoadCellDRDY, 100); // timeout 100 ms in case DRDY pin is not connected
     Task_sleep(100);
 
+    periodic_t poll_period;
+    periodic_start(&poll_period, params_get(PARAM_T_LOADCELL_POLL));
+
+    deep_pause_resume_done();
+
 	while(1)
 	{
 		// currently no event detected & reader was off
@@ -308,20 +627,22 @@ void load_cell_Task()
             ads1220_periodic(&ads);
             ads1220_event(&ads);
             ads1220_powerdown(&ads);
+            telemetry_add_sample(TELEMETRY_PHASE_POLL, ads.data);
+
+            if(threshold_update_request) // user set a new threshold
+            {
+                threshold_update_request = 0;
+                ads1220_set_thresholds(&ads, params_get(PARAM_WEIGHT_THRESHOLD));
+                last_measured_threshold = ads.periodic_threshold;
+                load_cell_save_tare();
+            }
 
             if(tare_request) // user requested new tare
             {
                 tare_request = 0;
                 event_ongoing = 0;
                 series_completed = 0;
-                ads1220_tare(20, &max_cont_deviation, &max_periodic_deviation, &ads);
-                if((max_cont_deviation + max_periodic_deviation) < TARE_TOLERANCE)
-                {
-                    ads1220_set_thresholds(&ads, WEIGHT_THRESHOLD);
-                    last_measured_offset = ads.cont_offset;
-                    last_measured_threshold = ads.periodic_threshold;
-                }
-                else
+                if(!load_cell_tare(TARE_TOLERANCE, &tare_deviation))
                 {
                     GPIO_write(Board_led_status,1);
                     Task_sleep(200);
@@ -342,7 +663,7 @@ void load_cell_Task()
 				if(event_ongoing==0)
 				{
 				    rfid_start_detection();
-                    Semaphore_pend((Semaphore_Handle)semLoadCell,RFID_TIMEOUT);
+                    Semaphore_pend((Semaphore_Handle)semLoadCell,params_get(PARAM_RFID_TIMEOUT));
                     rfid_stop_detection();
 
 					rfid_type = rfid_get_id(&owl_ID);
@@ -355,41 +676,40 @@ void load_cell_Task()
 					    GPIO_disableInt(nbox_loadcell_data_ready);
 
 						ads1220_change_mode(&ads, ADS1220_RATE_20_HZ, ADS1220_CONTINIOUS_CONVERSION, ADS1220_TEMPERATURE_DISABLED);
+						energy_on(ENERGY_LOADCELL);
 						ads.stable_weight = 0;
-						ads.tolerance = SAMPLE_TOLERANCE;
+						ads.tolerance = params_get(PARAM_SAMPLE_TOLERANCE);
+						segment_reset();
+						event_start_ticks = Clock_getTicks();
 
 						event_ongoing ='X';
 						series_completed = 0;
 					}
 					else
-						Task_sleep(T_RFID_RETRY);
+						Task_sleep(params_get(PARAM_T_RFID_RETRY));
 				}
 			}
-			else
-			{
-				// periodically measure tare offset again
-				if(offset_counter >= 3600 || event_ongoing == 'S') // ca. every 1 hour AND after a finished event that got a stable result
-				{
-				    event_ongoing = 'O'; //start a new offset measurement!
-				    series_completed = 0;
-                    // change to slow = exact mode
-                    GPIO_disableInt(nbox_loadcell_data_ready);
-
-                    ads1220_change_mode(&ads, ADS1220_RATE_20_HZ, ADS1220_CONTINIOUS_CONVERSION, ADS1220_TEMPERATURE_DISABLED);
+            else
+            {
+                // nobody on the perch: track the zero offset
+                load_cell_baseline_update(ads.data);
 
-				    offset_counter = 0;
-				}
-				else
-				{
-				    rfid_reset_detection_counts();
-                    event_ongoing = 0;
+                // periodically check the tare offset again
+                if(offset_counter >= OFFSET_CHECK_INTERVAL || event_ongoing == 'S') // ca. every 1 hour AND after a finished event that got a stable result
+                {
+                    load_cell_check_offset();
+                    offset_counter = 0;
+                }
+                else
+                {
                     offset_counter += 1;
-				}
-
-			}
+                }
+                rfid_reset_detection_counts();
+                event_ongoing = 0;
+            }
 
-			// polling delay...
-			Task_sleep(T_LOADCELL_POLL);
+			// polling delay, on the same grid as the other periodic tasks
+			periodic_sleep(&poll_period, params_get(PARAM_T_LOADCELL_POLL));
 		}
 
 		if(event_ongoing>0 && series_completed==0)
@@ -398,32 +718,28 @@ void load_cell_Task()
 
 			//measure weight again with 10 averages:
 
-			weightResultStatus res = load_cell_get_stable(&ads, event_ongoing);
+			weightResultStatus res = load_cell_get_weight(&ads, event_ongoing);
 
 			// measure temperature
-			ads1220_change_mode(&ads, ADS1220_RATE_20_HZ, ADS1220_CONTINIOUS_CONVERSION, ADS1220_TEMPERATURE_ENABLED);
-            GPIO_enableInt(nbox_loadcell_data_ready);
-
-			Semaphore_reset((Semaphore_Handle)semLoadCellDRDY, 0);
-	        ads1220_start_conversion(&ads);
-
-			Semaphore_pend((Semaphore_Handle)semLoadCellDRDY, 100); // timeout 100 ms in case DRDY pin is not connected
-
-			ads1220_read(&ads);
-			ads1220_event(&ads);
-
-			ads1220_convert_temperature(&ads);
+			int16_t temperature = load_cell_measure_temperature(ADS1220_RATE_20_HZ, ADS1220_CONTINIOUS_CONVERSION);
+            GPIO_disableInt(nbox_loadcell_data_ready);
 
-			uint16_t temp = (uint16_t)((ads.temperature+273.15) * 10); //deci kelvins
-            log_write_new_entry('T', temp);
+            log_write_new_entry('T', load_cell_temperature_to_decikelvin(temperature));
 
-            GPIO_disableInt(nbox_loadcell_data_ready);
-			ads1220_change_mode(&ads, ADS1220_RATE_20_HZ, ADS1220_CONTINIOUS_CONVERSION, ADS1220_TEMPERATURE_DISABLED);
+            if(res == STABLE) // temperature compensated weight above the zero offset
+            {
+                log_write_new_weight_entry('W', thermal_compensate(ads.stable_weight, ads.cont_offset, temperature),
+                                           (uint16_t)temperature);
+            }
 
 			if(res == STABLE || res == OWL_LEFT || res == OWL_CAME_BACK)
 			{
 				//stable event!! + mark series completed, but keep event ongoing (in order to not count it twice)!
 				series_completed = 1;
+				segment_flush();
+
+				// visit statistics: ADC time in continuous mode (ms; = time to stable for res == STABLE) and result
+				log_write_new_weight_entry('V', Clock_getTicks() - event_start_ticks, res);
 
 	            if(res == OWL_CAME_BACK || res == OWL_LEFT)
 	            {
@@ -439,9 +755,11 @@ void load_cell_Task()
 	            // change to fast = inexact mode
 				ads1220_change_mode(&ads, ADS1220_RATE_1000_HZ, ADS1220_SINGLE_SHOT, ADS1220_TEMPERATURE_DISABLED);
 	            ads1220_powerdown(&ads); //very important!
+	            energy_off(ENERGY_LOADCELL);
 
 				GPIO_enableInt(nbox_loadcell_data_ready);
-                Task_sleep(T_LOADCELL_POLL); // VERY IMPORTANT TO HAVE THIS, to get the ADC input discharged!
+                Task_sleep(params_get(PARAM_T_LOADCELL_POLL)); // VERY IMPORTANT TO HAVE THIS, to get the ADC input discharged!
+                periodic_start(&poll_period, params_get(PARAM_T_LOADCELL_POLL)); // the event is not a missed poll
 			}
 
 //			else if(res == OWL_LEFT)
@@ -460,7 +778,7 @@ void load_cell_Task()
 			    uint64_t dummy_owl_ID;
 			    // re-check if bird is still here.
 			    rfid_start_detection();
-                Semaphore_pend((Semaphore_Handle)semLoadCell,RFID_TIMEOUT);
+                Semaphore_pend((Semaphore_Handle)semLoadCell,params_get(PARAM_RFID_TIMEOUT));
                 rfid_stop_detection();
 
                 if(!rfid_get_id(&dummy_owl_ID))
@@ -468,7 +786,7 @@ void load_cell_Task()
                     log_write_new_entry('U', (uint16_t)owl_ID); //un-detected RFID
                 }
 
-				Task_sleep(T_LOADCELL_POLL);
+				Task_sleep(params_get(PARAM_T_LOADCELL_POLL));
 			}
 		}
 	}
@@ -11,6 +11,8 @@
 //#define USE_HX
 #define USE_ADS
 
+//#define USE_KALMAN_ESTIMATOR // stop the weight series as soon as the estimate has converged
+
 #include <xdc/cfg/global.h> //needed for semaphore
 #include <ti/sysbios/knl/Semaphore.h>
 
@@ -18,7 +20,7 @@
 int32_t get_last_stored_weight();
 int32_t get_last_measured_tare();
 int32_t get_weight_threshold();
-void set_weight_threshold(int32_t new_th);
+int set_weight_threshold(int32_t new_th); // returns 1 if accepted
 void load_cell_trigger_tare();
 void load_cell_bypass_threshold(int status);
 
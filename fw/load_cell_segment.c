@@ -0,0 +1,86 @@
+/*
+ * load_cell_segment.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Splits the averaged weight samples of one perch event into segments of constant
+ *  weight (two-sided CUSUM). A second bird landing or a hop off and back shows up as
+ *  a step; every segment that lasted long enough is logged as 'G' (mean, spread).
+ */
+
+#include "load_cell_segment.h"
+#include "logger.h"
+
+#define SEGMENT_DRIFT       500     // raw ADC units, deviations below this do not accumulate
+#define SEGMENT_THRESHOLD   5000    // raw ADC units, accumulated deviation that marks a step
+#define SEGMENT_MIN_LEN     4       // samples (~2 s), shorter segments are not logged
+
+static int64_t seg_sum = 0;
+static int32_t seg_min = 0;
+static int32_t seg_max = 0;
+static unsigned int seg_len = 0;
+static int32_t cusum_pos = 0;
+static int32_t cusum_neg = 0;
+
+static void segment_start(int32_t sample)
+{
+    seg_sum = sample;
+    seg_min = sample;
+    seg_max = sample;
+    seg_len = 1;
+    cusum_pos = 0;
+    cusum_neg = 0;
+}
+
+void segment_reset()
+{
+    seg_len = 0;
+    cusum_pos = 0;
+    cusum_neg = 0;
+}
+
+void segment_flush()
+{
+    if(seg_len >= SEGMENT_MIN_LEN)
+    {
+        int32_t spread = seg_max - seg_min;
+        if(spread > 0xffff)
+            spread = 0xffff;
+        log_write_new_weight_entry('G', (int32_t)(seg_sum / seg_len), spread);
+    }
+    segment_reset();
+}
+
+void segment_add_sample(int32_t sample)
+{
+    if(seg_len == 0)
+    {
+        segment_start(sample);
+        return;
+    }
+
+    int32_t diff = sample - (int32_t)(seg_sum / seg_len);
+
+    cusum_pos = cusum_pos + diff - SEGMENT_DRIFT;
+    if(cusum_pos < 0)
+        cusum_pos = 0;
+    cusum_neg = cusum_neg - diff - SEGMENT_DRIFT;
+    if(cusum_neg < 0)
+        cusum_neg = 0;
+
+    if(cusum_pos > SEGMENT_THRESHOLD || cusum_neg > SEGMENT_THRESHOLD)
+    {
+        // step: the current sample belongs to the new segment
+        segment_flush();
+        segment_start(sample);
+        return;
+    }
+
+    seg_sum += sample;
+    seg_len = seg_len + 1;
+    if(sample < seg_min)
+        seg_min = sample;
+    if(sample > seg_max)
+        seg_max = sample;
+}
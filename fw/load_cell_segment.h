@@ -0,0 +1,22 @@
+/*
+ * load_cell_segment.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_LOAD_CELL_SEGMENT_H_
+#define FW_LOAD_CELL_SEGMENT_H_
+
+#include <stdint.h>
+
+// start a new perch event
+void segment_reset();
+
+// feed one averaged weight sample; closes the running segment if a step was detected
+void segment_add_sample(int32_t sample);
+
+// close the running segment at the end of an event
+void segment_flush();
+
+#endif /* FW_LOAD_CELL_SEGMENT_H_ */
@@ -0,0 +1,99 @@
+/*
+ * load_cell_thermal.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Zero offset drift of the load cell vs. temperature. Every offset check on an empty
+ *  perch gives one (temperature, baseline) pair; a least squares line through these
+ *  pairs gives the offset slope. Integer only, no float library needed.
+ */
+
+#include "load_cell_thermal.h"
+
+#define SLOPE_SHIFT         8       // slope is stored in 1/2^8 ADC counts per 1/32 degC
+#define MIN_POINTS          8       // points needed before the slope is used
+#define MIN_STDEV           18      // minimum standard deviation of the point temperatures (~2 degC range)
+#define MAX_POINTS          64      // sums are halved when reaching this -> old points fade out
+#define MAX_SLOPE           (2000L << SLOPE_SHIFT) // plausibility limit, counts per 1/32 degC
+
+static int16_t reference_temperature = 0;
+static int32_t b_origin = 0;    // first baseline, keeps the sums small
+static int32_t slope = 0;
+
+static int32_t n = 0;
+static int64_t sum_t = 0;
+static int64_t sum_b = 0;
+static int64_t sum_tt = 0;
+static int64_t sum_tb = 0;
+
+void thermal_set_reference(int16_t temperature)
+{
+    reference_temperature = temperature;
+}
+
+static void thermal_fit()
+{
+    int64_t den = n*sum_tt - sum_t*sum_t; // n^2 * variance of the temperatures in the fit
+    int64_t num = n*sum_tb - sum_t*sum_b;
+
+    // the spread is taken from the sums, so it fades out together with the old points
+    if(n < MIN_POINTS || den < n*n*MIN_STDEV*MIN_STDEV)
+        return;
+
+    num = (num * (1L << SLOPE_SHIFT)) / den;
+    if(num > MAX_SLOPE || num < -MAX_SLOPE)
+        return; // something else than temperature moved the offset, keep the last slope
+
+    slope = (int32_t)num;
+}
+
+void thermal_add_idle_point(int16_t temperature, int32_t baseline)
+{
+    int32_t b;
+
+    if(n == 0)
+        b_origin = baseline;
+    b = baseline - b_origin;
+
+    if(n >= MAX_POINTS)
+    {
+        n = n/2;
+        sum_t = sum_t/2;
+        sum_b = sum_b/2;
+        sum_tt = sum_tt/2;
+        sum_tb = sum_tb/2;
+    }
+
+    n = n + 1;
+    sum_t += temperature;
+    sum_b += b;
+    sum_tt += (int32_t)temperature * temperature;
+    sum_tb += (int64_t)temperature * b;
+
+    thermal_fit();
+}
+
+int32_t thermal_offset_drift(int16_t temperature)
+{
+    int32_t dt = (int32_t)temperature - reference_temperature;
+    return (int32_t)(((int64_t)slope * dt) >> SLOPE_SHIFT);
+}
+
+int32_t thermal_compensate(int32_t raw, int32_t offset, int16_t temperature)
+{
+    int32_t net = raw - offset - thermal_offset_drift(temperature);
+
+#if LOAD_CELL_GAIN_TC_PPM
+    // net * (1 - TC * dT), dT in 1/32 degC
+    int32_t dt = (int32_t)temperature - reference_temperature;
+    net = net - (int32_t)(((int64_t)net * LOAD_CELL_GAIN_TC_PPM * dt) / (32 * 1000000L));
+#endif
+
+    return net;
+}
+
+int32_t thermal_get_offset_slope()
+{
+    return slope;
+}
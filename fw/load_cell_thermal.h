@@ -0,0 +1,34 @@
+/*
+ * load_cell_thermal.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_LOAD_CELL_THERMAL_H_
+#define FW_LOAD_CELL_THERMAL_H_
+
+#include <stdint.h>
+
+// all temperatures in ADS1220 units: 1/32 degC (see ads1220_convert_temperature)
+
+// span (gain) drift of the load cell in ppm/degC. This can not be seen on an empty perch,
+// so it is a per-box constant from the data sheet / a calibration run with a known weight.
+#define LOAD_CELL_GAIN_TC_PPM   0
+
+// the tare offsets were (re-)measured at this temperature:
+void thermal_set_reference(int16_t temperature);
+
+// feed one idle (empty perch) pair of temperature and zero offset to the drift model:
+void thermal_add_idle_point(int16_t temperature, int32_t baseline);
+
+// expected change of the zero offset between the reference temperature and the given one:
+int32_t thermal_offset_drift(int16_t temperature);
+
+// raw ADC value minus offset, corrected for offset and gain drift:
+int32_t thermal_compensate(int32_t raw, int32_t offset, int16_t temperature);
+
+// fitted offset drift in 1/256 ADC counts per 1/32 degC, 0 as long as there is not enough data
+int32_t thermal_get_offset_slope();
+
+#endif /* FW_LOAD_CELL_THERMAL_H_ */
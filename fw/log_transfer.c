@@ -0,0 +1,108 @@
+/*
+ * log_transfer.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Streams the raw FRAM log over the wifi MIN link using the reliable T-MIN transport
+ *  (min_queue_frame). Every data frame carries its byte offset into the log, so an
+ *  interrupted download is resumed by simply requesting the range again from the last
+ *  offset received ('G' command).
+ *
+ *  data frame: 'g', offset (16bit, big endian), log bytes (up to LOG_TRANSFER_CHUNK)
+ *  compressed: 'z', offset (16bit, big endian), number of log bytes, LZSS data (see lzss.c)
+ *  a 'g' frame without log bytes marks the end of the requested range.
+ *  Chunks are compressed independently, so resuming works the same way. A chunk that
+ *  does not get smaller is sent as 'g' frame.
+ *  'g' frames are not copied into the T-MIN FIFO: the log bytes are sent (and re-sent)
+ *  straight from FRAM, only the 3 byte header is queued.
+ */
+
+#include "log_transfer.h"
+#include "logger.h"
+#include "lzss.h"
+
+#define LOG_TRANSFER_MIN_ID     0x33U
+
+static int transfer_active = 0;
+static int transfer_compressed = 0;
+static uint16_t next_offset = 0;
+static uint16_t end_offset = 0;
+
+static uint8_t chunk_buf[LOG_TRANSFER_CHUNK + 3];
+
+void log_transfer_start(struct min_context *ctx, uint16_t start, uint16_t end, int compressed)
+{
+    uint16_t write_offset = log_get_write_offset();
+
+    if(end == 0 || end > write_offset)
+        end = write_offset;
+    if(start > end)
+        start = end;
+
+    // drop whatever is left from an earlier (interrupted) transfer
+    min_transport_reset(ctx, 1);
+
+    next_offset = start;
+    end_offset = end;
+    transfer_compressed = compressed;
+    transfer_active = 1;
+}
+
+void log_transfer_stop()
+{
+    transfer_active = 0;
+}
+
+int log_transfer_active()
+{
+    return transfer_active;
+}
+
+void log_transfer_poll(struct min_context *ctx)
+{
+    if(!transfer_active && ctx->transport_fifo.n_frames == 0)
+        return;
+
+    while(transfer_active)
+    {
+        uint16_t n = end_offset - next_offset;
+        if(n > LOG_TRANSFER_CHUNK)
+            n = LOG_TRANSFER_CHUNK;
+
+        if(!min_queue_has_space_for_frame(ctx, transfer_compressed ? n + 3 : 3))
+            break; // continue when the other side acknowledged some frames
+
+        chunk_buf[1] = next_offset >> 8;
+        chunk_buf[2] = next_offset;
+
+        if(transfer_compressed && n > 0)
+        {
+            const uint8_t *src = log_get_bytes(next_offset, &n);
+            uint16_t n_z = lzss_compress(src, n, &chunk_buf[4], n - 1);
+
+            if(n_z > 0)
+            {
+                chunk_buf[0] = 'z';
+                chunk_buf[3] = n;
+                min_queue_frame(ctx, LOG_TRANSFER_MIN_ID, chunk_buf, n_z + 4);
+                next_offset += n;
+                continue;
+            }
+        }
+
+        chunk_buf[0] = 'g';
+        const uint8_t *data = log_get_bytes(next_offset, &n);
+
+        min_queue_frame_ref(ctx, LOG_TRANSFER_MIN_ID, chunk_buf, 3, data, n);
+
+        if(n == 0) // end marker queued
+            transfer_active = 0;
+        next_offset += n;
+    }
+
+    // one more frame on the wire (min_poll() sends at most one per call). UART writes are
+    // blocking: more frames per call would keep the wifi task from reading the RX ring
+    // (and the ACKs in it) for seconds at low baud rates.
+    min_poll(ctx, 0, 0);
+}
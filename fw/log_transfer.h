@@ -0,0 +1,25 @@
+/*
+ * log_transfer.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_LOG_TRANSFER_H_
+#define FW_LOG_TRANSFER_H_
+
+#include <stdint.h>
+#include "min/min.h"
+
+#define LOG_TRANSFER_CHUNK      252 // log bytes per frame: 'g' + 16bit offset + data = 255 bytes payload
+
+// (re-)start streaming the log bytes [start, end) to the other side; end = 0 --> up to the current write position
+// compressed: send LZSS compressed 'z' frames where this saves bytes
+void log_transfer_start(struct min_context *ctx, uint16_t start, uint16_t end, int compressed);
+void log_transfer_stop();
+int log_transfer_active();
+
+// must be called regularly while wifi is on: queues the next chunks and drives the T-MIN window
+void log_transfer_poll(struct min_context *ctx);
+
+#endif /* FW_LOG_TRANSFER_H_ */
@@ -13,6 +13,13 @@
 #include <msp430.h>
 #include "rfid_reader.h"
 #include "rtc.h"
+#include "energy.h"
+#include "periodic.h"
+#include "trace.h"
+#include "clock_policy.h"
+#include "deep_pause.h"
+#include "params.h"
+#include "lzss.h"
 
 #include "ADS1220/spi.h"
 #include "ff13b/source/ff.h"
@@ -25,7 +32,7 @@
 #define LOG_POS_VALID_PW		0x1234 	// write this value to the LOG_NEXT_POS_VALID space in memory
 									// at the first time we make a log entry to this FRAM
 
-#define LOG_BACKUP_PERIOD	2		// seconds between two time stamp back-ups
+#define LOG_BACKUP_PERIOD	(T_LOG_FLUSH_CHECK/1000)	// max. seconds between two time stamp back-ups
 
 #define LOG_NEXT_POS_VALID	0x12FFC // store the 16bit "password" (type unsigned int == uint16_t)
 #define LOG_NEXT_POS_OFS		0x12FFE // store the 16bit offset (type unsigned int == uint16_t)
@@ -73,25 +80,49 @@
 // variable used to write next log entry
 uint16_t* FRAM_offset_ptr;
 
-// variables used to read out the log buffer:
-uint16_t* FRAM_read_ptr;
-uint16_t FRAM_read_end_ptr_value;
+// variables used to read out the log buffer; persistent like the write offset, so the
+// flush continues where it was after a deep pause (LPM3.5 loses the RAM):
+#pragma PERSISTENT(FRAM_read_ptr)
+uint16_t* FRAM_read_ptr = 0;
+#pragma PERSISTENT(FRAM_read_end_ptr_value)
+uint16_t FRAM_read_end_ptr_value = 0;
 
 // in which half of the storage region will the next flush out happen?
 enum log_partitions {FIRST = 1, SECOND = 2};
+#pragma PERSISTENT(current_log_partition)
 enum log_partitions current_log_partition = FIRST;
 
 
 unsigned int log_initialized = 0;
 //const unsigned int phase_two = 0;
 
-int log_send_data_via_uart(unsigned int* FRAM_read_end_ptr);
+int log_send_data_via_uart(uint16_t* FRAM_read_end_ptr);
+
+// back up the time stamp; done together with other FRAM writes instead of from an own timer
+static void log_backup_timestamp()
+{
+	if(log_initialized)
+		(*(uint32_t*)LOG_TIMESTAMP) = Seconds_get();
+}
 
 void log_startup()
 {
-	FRAM_offset_ptr = (unsigned int*)LOG_NEXT_POS_OFS;
+	FRAM_offset_ptr = (uint16_t*)LOG_NEXT_POS_OFS;
+
+	uint16_t* FRAM_pw = (uint16_t*)LOG_NEXT_POS_VALID;
+	if(deep_pause_warm_boot() && (*FRAM_pw) == LOG_POS_VALID_PW)
+	{
+		// the RTC kept the time during the pause (the user button may have woken us up)
+		rtc_set_pause_times_compact (*(uint32_t*)LOG_RTC_ALARM_TIMES);
+		rtc_deep_resume(deep_pause_alarm_wake());
+		if(!energy_restore()) // the pause ends now that the RTC time is back
+			energy_reset();
+		log_initialized = 1;
+		return;
+	}
 
-	unsigned int* FRAM_pw = (unsigned int*)LOG_NEXT_POS_VALID;
+	FRAM_read_ptr = (uint16_t*)LOG_START_POS; // points to start of logged data.
+	current_log_partition = FIRST;
 	if(((*FRAM_pw) != LOG_POS_VALID_PW) || (GPIO_read(Board_button)==0))
 	{
 		// new initialization
@@ -140,7 +171,7 @@ int log_restart()
     *FRAM_offset_ptr = 0x0000;
 
     // store correct password
-    unsigned int* FRAM_pw = (unsigned int*)LOG_NEXT_POS_VALID;
+    uint16_t* FRAM_pw = (uint16_t*)LOG_NEXT_POS_VALID;
     (*FRAM_pw) = LOG_POS_VALID_PW;
 
     (*(uint32_t*)LOG_TIMESTAMP) = Seconds_get();
@@ -148,6 +179,39 @@ int log_restart()
     return retval;
 }
 
+uint16_t log_get_write_offset()
+{
+    return *FRAM_offset_ptr;
+}
+
+uint16_t log_get_capacity()
+{
+    return LOG_END_OFS;
+}
+
+// direct (read only) access to the log bytes in FRAM, *n is limited to the bytes written so far
+const uint8_t* log_get_bytes(uint16_t offset, uint16_t* n)
+{
+    if(offset >= *FRAM_offset_ptr)
+        *n = 0;
+    else if(*n > *FRAM_offset_ptr - offset)
+        *n = *FRAM_offset_ptr - offset;
+
+    return (const uint8_t*)LOG_START_POS + offset;
+}
+
+// copy raw log bytes (byte offset from the start of the log region), returns the number of bytes copied
+uint16_t log_read_bytes(uint16_t offset, uint8_t* buf, uint16_t n)
+{
+    uint16_t i;
+    const uint8_t* src = log_get_bytes(offset, &n);
+
+    for(i=0; i<n; i++)
+        buf[i] = src[i];
+
+    return n;
+}
+
 void log_check_pointer_position()
 {
     // Make sure we are not going to exceed the reserved memory region. If we do we
@@ -186,7 +250,8 @@ void quick_print(long value, char log_symbol)
 int log_write_new_entry(uint8_t logchar, uint16_t value)
 {
     log_check_pointer_position();
-	unsigned int* FRAM_write_ptr = (unsigned int*)(LOG_START_POS + *FRAM_offset_ptr); // = base address plus *FRAM_offset_ptr
+    log_backup_timestamp();
+	uint16_t* FRAM_write_ptr = (uint16_t*)(LOG_START_POS + *FRAM_offset_ptr); // = base address plus *FRAM_offset_ptr
 
 #if(LOG_VERBOSE)
     quick_print(value, logchar);
@@ -216,7 +281,8 @@ int log_write_new_rfid_entry(uint64_t uid)
     uint32_t timestamp = Seconds_get();
 
     log_check_pointer_position();
-    unsigned int* FRAM_write_ptr = (unsigned int*)(LOG_START_POS + *FRAM_offset_ptr); // = base address plus *FRAM_offset_ptr
+    log_backup_timestamp();
+    uint16_t* FRAM_write_ptr = (uint16_t*)(LOG_START_POS + *FRAM_offset_ptr); // = base address plus *FRAM_offset_ptr
 
 #if(LOG_VERBOSE)
     quick_print(uid, 'R');
@@ -245,7 +311,8 @@ int log_write_new_weight_entry( uint8_t logchar, uint32_t weight, uint16_t stdev
     uint32_t timestamp = Seconds_get();
 
     log_check_pointer_position();
-    unsigned int* FRAM_write_ptr = (unsigned int*)(LOG_START_POS + *FRAM_offset_ptr); // = base address plus *FRAM_offset_ptr
+    log_backup_timestamp();
+    uint16_t* FRAM_write_ptr = (uint16_t*)(LOG_START_POS + *FRAM_offset_ptr); // = base address plus *FRAM_offset_ptr
 
 #if(LOG_VERBOSE)
     quick_print(weight, logchar);
@@ -270,73 +337,154 @@ const uint8_t end_string[] = "#========== end FRAM logs ===========\n";
 
 static int sd_card_busy = 0;
 
+#define TRACE_LINE_BYTES    32 // capture trace bytes per line on the SD card
+static const uint8_t hex_digit[] = "0123456789ABCDEF";
+
 int log_sd_card_busy()
 {
     return sd_card_busy;
 }
 
-int log_send_data_via_uart(uint16_t* FRAM_read_end_ptr)
+// switches the SD logger on and waits for its prompt; returns 1 on successful SD card detection.
+static int sd_logger_open()
 {
-    int retval = 0; //returns 1 on successful SD card detection.
+    int retval = 0;
 
-    if(!sd_card_busy)
-    {
-        sd_card_busy = 1;
-
-    #if LOG_VERBOSE
-        GPIO_write(nbox_spi_cs_n, 0); //turn on SD card
+    clock_request_fast(CLOCK_USER_SD_CARD);
 
-        uart_stop_debug_prints();
-        uart_serial_write(&debug_uart, start_string, sizeof(start_string));
-        //  uart_serial_write(&debug_uart, title_row, sizeof(title_row));
-    #else
-        char sd_rx;
-        unsigned int sd_retry = 0;
+#if LOG_VERBOSE
+    GPIO_write(nbox_spi_cs_n, 0); //turn on SD card
+    energy_on(ENERGY_SD_CARD);
 
-        for(sd_retry = 0; sd_retry <= MAX_SD_RETRY; sd_retry++){
-            uart_debug_open();
-            GPIO_write(nbox_spi_cs_n, 0); //turn on SD card
+    uart_stop_debug_prints();
+    uart_serial_write(&debug_uart, start_string, sizeof(start_string));
+    //  uart_serial_write(&debug_uart, title_row, sizeof(title_row));
+#else
+    char sd_rx;
+    unsigned int sd_retry = 0;
+
+    for(sd_retry = 0; sd_retry <= MAX_SD_RETRY; sd_retry++){
+        // PARAM_SD_BAUDRATE first; the second half of the retries (and rates the clock
+        // tree cannot generate) fall back to UART_DEFAULT_BAUDRATE, for loggers still at 9600
+        if(sd_retry >= MAX_SD_RETRY/2 || !uart_debug_set_baudrate(params_get(PARAM_SD_BAUDRATE)))
+            uart_debug_set_baudrate(UART_DEFAULT_BAUDRATE);
+        uart_debug_open();
+        GPIO_write(nbox_spi_cs_n, 0); //turn on SD card
+        energy_on(ENERGY_SD_CARD);
 
-            unsigned int sd_delay = 0;
+        unsigned int sd_delay = 0;
+        for(sd_delay = 0; sd_delay < 20; sd_delay++)
+        {
+            sd_rx=uart_serial_getc(&debug_uart); //read timeout is 100ms
+            if(sd_rx == '1' || sd_rx == '2' || sd_rx == '<')
+                break;
+        }
+        if(sd_rx == '1')
+        {
             for(sd_delay = 0; sd_delay < 20; sd_delay++)
             {
-                sd_rx=uart_serial_getc(&debug_uart); //read timeout is 100ms
-                if(sd_rx == '1' || sd_rx == '2' || sd_rx == '<')
+                sd_rx=uart_serial_getc(&debug_uart);
+                if(sd_rx == '2' || sd_rx == '<')
                     break;
             }
-            if(sd_rx == '1')
-            {
-                for(sd_delay = 0; sd_delay < 20; sd_delay++)
-                {
-                    sd_rx=uart_serial_getc(&debug_uart);
-                    if(sd_rx == '2' || sd_rx == '<')
-                        break;
-                }
-            }
-            if(sd_rx == '2')
+        }
+        if(sd_rx == '2')
+        {
+            for(sd_delay = 0; sd_delay < 20; sd_delay++)
             {
-                for(sd_delay = 0; sd_delay < 20; sd_delay++)
+                sd_rx=uart_serial_getc(&debug_uart);
+                if(sd_rx == '<')
                 {
-                    sd_rx=uart_serial_getc(&debug_uart);
-                    if(sd_rx == '<')
-                    {
-                        retval = 1;
-                        break;
-                    }
+                    retval = 1;
+                    break;
                 }
             }
+        }
 
-            if(sd_rx == '<' || sd_retry == MAX_SD_RETRY)
-                break;
-            else
-            {
-                uart_debug_close();
+        if(sd_rx == '<' || sd_retry == MAX_SD_RETRY)
+            break;
+        else
+        {
+            uart_debug_close();
 
-                GPIO_write(nbox_spi_cs_n, 1); //turn off SD card
-                Task_sleep(5000);
-            }
+            GPIO_write(nbox_spi_cs_n, 1); //turn off SD card
+            energy_off(ENERGY_SD_CARD);
+            Task_sleep(5000);
         }
-    #endif
+    }
+#endif
+
+    return retval;
+}
+
+static void sd_logger_close()
+{
+    Task_sleep(3000); //wait for data to be written
+
+#if LOG_VERBOSE
+    uart_serial_write(&debug_uart, end_string, sizeof(end_string));
+    Task_sleep(100);
+    uart_start_debug_prints();
+#else
+    uart_debug_close();
+    Semaphore_post((Semaphore_Handle)semSerial);
+#endif
+
+    GPIO_write(nbox_spi_cs_n, 1); //turn off SD card
+    energy_off(ENERGY_SD_CARD);
+    clock_release_fast(CLOCK_USER_SD_CARD);
+}
+
+#define LOG_SD_CHUNK        240 // log bytes per 'Z' block: 20 long or 30 short entries
+
+#pragma PERSISTENT(sd_z_buf)
+static uint8_t sd_z_buf[LOG_SD_CHUNK] = {0,}; // scratch buffer in FRAM, keeps the RAM free
+
+// PARAM_SD_COMPRESS: the log entries as they are in FRAM, in blocks of up to LOG_SD_CHUNK bytes.
+// Each block is a 'Z' line (number of log bytes, number of LZSS bytes) followed by the
+// LZSS data (lzss.c), or by the log bytes themselves if they do not get smaller (0 LZSS
+// bytes). Blocks may split an entry: the decoder (host/platform/log_unpack.c) joins the
+// blocks of a flush and prints the same lines as the text flush. About a quarter of the
+// bytes of the text lines go over the UART (host/test_lzss.c -b), so the SD logger is on
+// for a shorter time.
+static void log_send_compressed(uint16_t* FRAM_read_end_ptr)
+{
+    uint8_t outbuffer[OUTPUT_BUF_LEN];
+
+    while(FRAM_read_ptr < FRAM_read_end_ptr)
+    {
+        uint16_t n = (uint8_t*)FRAM_read_end_ptr - (uint8_t*)FRAM_read_ptr;
+        if(n > LOG_SD_CHUNK)
+            n = LOG_SD_CHUNK;
+        uint16_t n_z = lzss_compress((const uint8_t*)FRAM_read_ptr, n, sd_z_buf, n - 1);
+
+        outbuffer[0] = 'Z';
+        outbuffer[1] = ',';
+        int strlen = ui2a(n, 10, 1, HIDE_LEADING_ZEROS, &(outbuffer[2]));
+        outbuffer[strlen+2] = ',';
+        uart_serial_write(&debug_uart, outbuffer, strlen+3);
+        strlen = ui2a(n_z, 10, 1, HIDE_LEADING_ZEROS, outbuffer);
+        outbuffer[strlen] = '\n';
+        uart_serial_write(&debug_uart, outbuffer, strlen+1);
+
+        if(n_z > 0)
+            uart_serial_write(&debug_uart, sd_z_buf, n_z);
+        else
+            uart_serial_write(&debug_uart, (const uint8_t*)FRAM_read_ptr, n);
+
+        FRAM_read_ptr += n/2;
+    }
+}
+
+int log_send_data_via_uart(uint16_t* FRAM_read_end_ptr)
+{
+    int retval = 0; //returns 1 on successful SD card detection.
+
+    if(!sd_card_busy)
+    {
+        sd_card_busy = 1;
+
+        retval = sd_logger_open();
 
         uint8_t outbuffer[OUTPUT_BUF_LEN];
 
@@ -351,6 +499,8 @@ int log_send_data_via_uart(uint16_t* FRAM_read_end_ptr)
         outbuffer[strlen] = '\n';
         uart_serial_write(&debug_uart, outbuffer, strlen+1);
 
+        if(params_get(PARAM_SD_COMPRESS))
+            log_send_compressed(FRAM_read_end_ptr); // nothing left for the text lines below
 
         while(FRAM_read_ptr < FRAM_read_end_ptr)
         {
@@ -363,7 +513,7 @@ int log_send_data_via_uart(uint16_t* FRAM_read_end_ptr)
 
             unsigned char logchar = outbuffer[0];
 
-            if(logchar == 'X' || logchar == 'O' || logchar == 'S' || logchar == 'A' || logchar == 'R')
+            if(logchar == 'X' || logchar == 'O' || logchar == 'S' || logchar == 'A' || logchar == 'R' || logchar == 'W' || logchar == 'G' || logchar == 'V' || logchar == 'o')
             {
                 //send out milliseconds:
     //		    strlen = ui2a((*((uint8_t*)FRAM_read_ptr+LOG_MSEC_8b_OFS)<<2), 10, 1,HIDE_LEADING_ZEROS, outbuffer);
@@ -407,18 +557,50 @@ int log_send_data_via_uart(uint16_t* FRAM_read_end_ptr)
             FRAM_read_ptr += LOG_ENTRY_SHORT_16b_LEN;
         }
 
-        Task_sleep(3000); //wait for data to be written
+        sd_logger_close();
+
+        sd_card_busy = 0;
+    }
+
+    return retval;
+}
+
+// capture trace (trace.c) as hex lines after a 'C' header line (start time, length in bytes)
+int log_send_trace_via_uart(uint32_t start_time, const uint8_t* buf, uint16_t len)
+{
+    int retval = 0;
+
+    if(!sd_card_busy)
+    {
+        sd_card_busy = 1;
+
+        retval = sd_logger_open();
+
+        uint8_t outbuffer[2*TRACE_LINE_BYTES+1];
+        uint16_t i;
 
-    #if LOG_VERBOSE
-        uart_serial_write(&debug_uart, end_string, sizeof(end_string));
-        Task_sleep(100);
-        uart_start_debug_prints();
-    #else
-        uart_debug_close();
-        Semaphore_post((Semaphore_Handle)semSerial);
-    #endif
+        outbuffer[0] = 'C';
+        outbuffer[1] = ',';
+        int strlen = ui2a(start_time, 10, 1, HIDE_LEADING_ZEROS, &(outbuffer[2]));
+        outbuffer[strlen+2] = ',';
+        uart_serial_write(&debug_uart, outbuffer, strlen+3);
+        strlen = ui2a(len, 10, 1, HIDE_LEADING_ZEROS, outbuffer);
+        outbuffer[strlen] = '\n';
+        uart_serial_write(&debug_uart, outbuffer, strlen+1);
+
+        for(i = 0; i < len; i++)
+        {
+            outbuffer[2*(i % TRACE_LINE_BYTES)] = hex_digit[buf[i] >> 4];
+            outbuffer[2*(i % TRACE_LINE_BYTES)+1] = hex_digit[buf[i] & 0x0f];
+            if((i % TRACE_LINE_BYTES) == TRACE_LINE_BYTES-1 || i == len-1)
+            {
+                strlen = 2*(i % TRACE_LINE_BYTES) + 2;
+                outbuffer[strlen] = '\n';
+                uart_serial_write(&debug_uart, outbuffer, strlen+1);
+            }
+        }
 
-        GPIO_write(nbox_spi_cs_n, 1); //turn off SD card
+        sd_logger_close();
 
         sd_card_busy = 0;
     }
@@ -431,13 +613,6 @@ uint8_t log_phase_two()
 	return 0;//phase_two>0;
 }
 
-//called periodically
-Void cron_quick_clock(UArg arg){
-	// back up time stamp
-	if(log_initialized)
-		(*(uint32_t*)LOG_TIMESTAMP) = Seconds_get();
-}
-
 
 extern SPI_Handle  nestbox_spi_handle;
 int sd_spi_is_initialized = 0;
@@ -611,12 +786,12 @@ int sd_spi_is_initialized = 0;
 //    return 1;
 //}
 
-void log_Task()
+void log_task_start()
 {
     log_startup();
 
     //TODO: check first if there is some logged stuff on the FRAM to avoid data loss after a crash.
-    FRAM_read_ptr = (unsigned int*)LOG_START_POS; // points to start of logged data.
+    // (after a deep pause, log_startup() kept the read position)
 
 #if(LOG_VERBOSE)
     uart_debug_open();
@@ -627,13 +802,16 @@ void log_Task()
 #endif
 
     // indicate system is running/restarting:
-    GPIO_write(Board_led_status, 1);
-    Task_sleep(1000);
-    GPIO_write(Board_led_status, 0);
-    Task_sleep(500);
-    GPIO_write(Board_led_status, 1);
-    Task_sleep(500);
-    GPIO_write(Board_led_status, 0);
+    if(!deep_pause_fast_start())
+    {
+        GPIO_write(Board_led_status, 1);
+        Task_sleep(1000);
+        GPIO_write(Board_led_status, 0);
+        Task_sleep(500);
+        GPIO_write(Board_led_status, 1);
+        Task_sleep(500);
+        GPIO_write(Board_led_status, 0);
+    }
 
     //sd_spi_init_logger();
     //fat_disk_initialize (0);
@@ -665,27 +843,42 @@ void log_Task()
 //
 //        }
 //    }
+}
 
+void log_task_step()
+{
+    log_backup_timestamp();
 
-	while(1)
-	{
+    if(current_log_partition == FIRST && *FRAM_offset_ptr > LOG_MIDDLE_OFS)
+    {
+        //Flush out the first half of the internal log via UART
+        log_send_data_via_uart((uint16_t*)LOG_MIDDLE_POS);
+        current_log_partition = SECOND;
+    }
 
-	    if(current_log_partition == FIRST && *FRAM_offset_ptr > LOG_MIDDLE_OFS)
-	    {
-	        //Flush out the first half of the internal log via UART
-	        log_send_data_via_uart((uint16_t*)LOG_MIDDLE_POS);
-	        current_log_partition = SECOND;
-	    }
+    if(current_log_partition == SECOND && *FRAM_offset_ptr < LOG_MIDDLE_OFS)
+    {
+        //Flush out the first half of the internal log via UART
+        log_send_data_via_uart((uint16_t*)(FRAM_read_end_ptr_value+LOG_START_POS));
+        current_log_partition = FIRST;
+        FRAM_read_ptr = (uint16_t*)LOG_START_POS; // points back to start of logged data.
+    }
 
-	    if(current_log_partition == SECOND && *FRAM_offset_ptr < LOG_MIDDLE_OFS)
-        {
-            //Flush out the first half of the internal log via UART
-            log_send_data_via_uart((uint16_t*)(FRAM_read_end_ptr_value+LOG_START_POS));
-            current_log_partition = FIRST;
-            FRAM_read_ptr = (uint16_t*)LOG_START_POS; // points back to start of logged data.
-        }
+    trace_poll(); // finished sensor capture to the SD card
+}
+
+void log_Task()
+{
+    periodic_t period;
+
+    log_task_start();
+    periodic_start(&period, T_LOG_FLUSH_CHECK);
+
+	while(1)
+	{
+	    log_task_step();
 
-	    Task_sleep(10000);
+	    periodic_sleep(&period, T_LOG_FLUSH_CHECK);
 
 //		if(phase_two == 2)
 //		{
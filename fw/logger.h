@@ -10,6 +10,8 @@
 
 #include <stdint.h>
 
+#define T_LOG_FLUSH_CHECK   10000 // ms between two checks of the FRAM log fill level
+
 int log_sd_card_busy();
 
 int log_restart();
@@ -20,8 +22,20 @@ int log_write_new_entry(uint8_t logchar, uint16_t value);
 int log_write_new_rfid_entry(uint64_t uid);
 int log_write_new_weight_entry(uint8_t logchar, uint32_t weight, uint16_t stdev);
 
+uint16_t log_get_write_offset();
+uint16_t log_get_capacity();
+uint16_t log_read_bytes(uint16_t offset, uint8_t* buf, uint16_t n);
+const uint8_t* log_get_bytes(uint16_t offset, uint16_t* n);
+
+// writes a capture trace (trace.c) to the SD card, returns 1 on successful SD card detection
+int log_send_trace_via_uart(uint32_t start_time, const uint8_t* buf, uint16_t len);
+
 int32_t get_weight_offset(); //inside loadcell.c
 
 void log_Task();
 
+// the log task split up for the service loop (service_loop.c): start once, then step every T_LOG_FLUSH_CHECK
+void log_task_start();
+void log_task_step();
+
 #endif /* FW_LOGGER_H_ */
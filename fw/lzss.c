@@ -0,0 +1,128 @@
+/*
+ * lzss.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Small LZSS compressor for log transfers. The window is the input itself (the log is
+ *  memory mapped FRAM), so no RAM is needed besides a few locals.
+ *
+ *  Format: a flag byte precedes every group of up to 8 items, bit i (LSB first) describes
+ *  item i: 1 = literal byte, 0 = match of 2 bytes (distance-1, length-LZSS_MIN_MATCH).
+ *  The log entries repeat their logchar and the upper timestamp bytes every 8 or 12 bytes,
+ *  which is what the matches pick up.
+ */
+
+#include "lzss.h"
+
+uint16_t lzss_compress(const uint8_t *src, uint16_t n, uint8_t *dst, uint16_t dst_len)
+{
+    uint16_t pos = 0;
+    uint16_t out = 0;
+    uint16_t flag_pos = 0;
+    uint8_t flag_bit = 8; // no flag byte open yet
+
+    while(pos < n)
+    {
+        uint16_t best_len = 0;
+        uint16_t best_dist = 0;
+        uint16_t max_len = n - pos;
+        uint16_t dist;
+
+        if(max_len > LZSS_MAX_MATCH)
+            max_len = LZSS_MAX_MATCH;
+
+        // the closest match wins on equal length (log entries repeat at a short distance)
+        for(dist = 1; dist <= LZSS_WINDOW && dist <= pos; dist++)
+        {
+            const uint8_t *a = &src[pos];
+            const uint8_t *b = &src[pos - dist];
+            uint16_t len = 0;
+
+            while(len < max_len && a[len] == b[len])
+                len++;
+
+            if(len > best_len)
+            {
+                best_len = len;
+                best_dist = dist;
+                if(len == max_len)
+                    break;
+            }
+        }
+
+        if(flag_bit == 8)
+        {
+            if(out >= dst_len)
+                return 0;
+            flag_pos = out;
+            dst[out++] = 0;
+            flag_bit = 0;
+        }
+
+        if(best_len >= LZSS_MIN_MATCH)
+        {
+            if(out + 2 > dst_len)
+                return 0;
+            dst[out++] = best_dist - 1;
+            dst[out++] = best_len - LZSS_MIN_MATCH;
+            pos += best_len;
+        }
+        else
+        {
+            if(out >= dst_len)
+                return 0;
+            dst[flag_pos] |= 1 << flag_bit;
+            dst[out++] = src[pos++];
+        }
+        flag_bit++;
+    }
+
+    return out;
+}
+
+#ifdef LZSS_DECODER
+uint16_t lzss_decompress(const uint8_t *src, uint16_t n, uint8_t *dst, uint16_t dst_len)
+{
+    uint16_t pos = 0;
+    uint16_t out = 0;
+    uint8_t flags = 0;
+    uint8_t flag_bit = 8;
+
+    while(pos < n)
+    {
+        if(flag_bit == 8)
+        {
+            flags = src[pos++];
+            flag_bit = 0;
+            continue;
+        }
+
+        if(flags & (1 << flag_bit))
+        {
+            if(out >= dst_len)
+                return 0;
+            dst[out++] = src[pos++];
+        }
+        else
+        {
+            uint16_t dist, len;
+
+            if(pos + 2 > n)
+                return 0;
+            dist = (uint16_t)src[pos++] + 1;
+            len = (uint16_t)src[pos++] + LZSS_MIN_MATCH;
+            if(dist > out || out + len > dst_len)
+                return 0;
+            while(len--)
+            {
+                dst[out] = dst[out - dist];
+                out++;
+            }
+        }
+        flag_bit++;
+    }
+
+    return out;
+}
+#endif
@@ -0,0 +1,31 @@
+/*
+ * lzss.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_LZSS_H_
+#define FW_LZSS_H_
+
+#include <stdint.h>
+
+#define LZSS_WINDOW         128 // bytes, maximum match distance (<= 256)
+#define LZSS_MIN_MATCH      3
+#define LZSS_MAX_MATCH      18
+
+//#define LZSS_DECODER      // also build lzss_decompress() (host side / self test)
+
+// worst case output size for n input bytes (all literals)
+#define LZSS_MAX_OUTPUT(n)  ((n) + ((n)+7)/8)
+
+// compresses n bytes from src (any memory mapped location, e.g. FRAM) into dst.
+// returns the compressed size, 0 if it does not fit into dst_len bytes.
+uint16_t lzss_compress(const uint8_t *src, uint16_t n, uint8_t *dst, uint16_t dst_len);
+
+#ifdef LZSS_DECODER
+// returns the decompressed size, 0 on a corrupt input or if it does not fit into dst_len bytes
+uint16_t lzss_decompress(const uint8_t *src, uint16_t n, uint8_t *dst, uint16_t dst_len);
+#endif
+
+#endif /* FW_LZSS_H_ */
@@ -4,6 +4,10 @@
 
 #include "min.h"
 #include "../uart_helper.h"
+#ifndef MIN_CRC32_BITWISE
+#include "min_crc32_tables.h"
+#endif
+#include <ti/sysbios/knl/Clock.h>
 
 #define TRANSPORT_FIFO_SIZE_FRAMES_MASK             ((uint8_t)((1U << TRANSPORT_FIFO_SIZE_FRAMES_BITS) - 1U))
 #define TRANSPORT_FIFO_SIZE_FRAME_DATA_MASK         ((uint16_t)((1U << TRANSPORT_FIFO_SIZE_FRAME_DATA_BITS) - 1U))
@@ -25,7 +29,7 @@ enum {
 #define TRANSPORT_ACK_RETRANSMIT_TIMEOUT_MS         (25U)
 #endif
 #ifndef TRANSPORT_FRAME_RETRANSMIT_TIMEOUT_MS
-#define TRANSPORT_FRAME_RETRANSMIT_TIMEOUT_MS       (50U) // Should be long enough for a whole window to be transmitted plus an ACK / NACK to get back
+#define TRANSPORT_FRAME_RETRANSMIT_TIMEOUT_MS       (50U) // ACK / NACK latency; the wire time of the window is added (min_tx_time_ms)
 #endif
 #ifndef TRANSPORT_MAX_WINDOW_SIZE
 #define TRANSPORT_MAX_WINDOW_SIZE                   (16U)
@@ -53,6 +57,7 @@ static void crc32_init_context(struct crc32_context *context)
     context->crc = 0xffffffffU;
 }
 
+#ifdef MIN_CRC32_BITWISE
 static void crc32_step(struct crc32_context *context, uint8_t byte)
 {
     context->crc ^= byte;
@@ -62,6 +67,32 @@ static void crc32_step(struct crc32_context *context, uint8_t byte)
         context->crc = (context->crc >> 1) ^ (0xedb88320U & mask);
     }
 }
+#else
+static void crc32_step(struct crc32_context *context, uint8_t byte)
+{
+    context->crc = crc32_table[0][(uint8_t)(context->crc ^ byte)] ^ (context->crc >> 8);
+}
+#endif
+
+// CRC over a contiguous block of bytes
+static void crc32_block(struct crc32_context *context, const uint8_t *data, uint16_t len)
+{
+#ifdef MIN_CRC32_SLICE_BY_4
+    uint32_t crc = context->crc;
+    while(len >= 4U) {
+        crc ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+        crc = crc32_table[3][crc & 0xffU] ^ crc32_table[2][(crc >> 8) & 0xffU] ^
+              crc32_table[1][(crc >> 16) & 0xffU] ^ crc32_table[0][crc >> 24];
+        data += 4;
+        len -= 4U;
+    }
+    context->crc = crc;
+#endif
+    while(len > 0) {
+        crc32_step(context, *data++);
+        len--;
+    }
+}
 
 static uint32_t crc32_finalize(struct crc32_context *context)
 {
@@ -69,11 +100,11 @@ static uint32_t crc32_finalize(struct crc32_context *context)
 }
 
 
-static void stuffed_tx_byte(struct min_context *self, uint8_t byte)
+// Transmits a byte without adding it to the checksum (payload checksum is done in blocks)
+static void stuffed_tx_byte_no_crc(struct min_context *self, uint8_t byte)
 {
     // Transmit the byte
     min_tx_byte(self->port, byte);
-    crc32_step(&self->tx_checksum, byte);
 
     // See if an additional stuff byte is needed
     if(byte == HEADER_BYTE) {
@@ -87,7 +118,15 @@ static void stuffed_tx_byte(struct min_context *self, uint8_t byte)
     }
 }
 
-static void on_wire_bytes(struct min_context *self, uint8_t id_control, uint8_t seq, uint8_t *payload_base, uint16_t payload_offset, uint16_t payload_mask, uint8_t payload_len)
+static void stuffed_tx_byte(struct min_context *self, uint8_t byte)
+{
+    crc32_step(&self->tx_checksum, byte);
+    stuffed_tx_byte_no_crc(self, byte);
+}
+
+// ext_payload (if any) is sent after the payload, straight from where it is
+static void on_wire_bytes(struct min_context *self, uint8_t id_control, uint8_t seq, uint8_t *payload_base, uint16_t payload_offset, uint16_t payload_mask, uint8_t payload_len,
+                          const uint8_t *ext_payload, uint8_t ext_payload_len)
 {
     uint8_t n, i;
     uint32_t checksum;
@@ -108,13 +147,29 @@ static void on_wire_bytes(struct min_context *self, uint8_t id_control, uint8_t
         stuffed_tx_byte(self, seq);
     }
 
-    stuffed_tx_byte(self, payload_len);
+    stuffed_tx_byte(self, payload_len + ext_payload_len);
+
+    if(payload_len > 0) {
+        // checksum the payload in (at most two, if it wraps in the ring buffer) contiguous blocks
+        uint16_t first_len = payload_len;
+        if(payload_mask != 0xffffU && (uint16_t)(payload_offset + payload_len) > payload_mask + 1U) {
+            first_len = payload_mask + 1U - payload_offset;
+        }
+        crc32_block(&self->tx_checksum, &payload_base[payload_offset], first_len);
+        crc32_block(&self->tx_checksum, &payload_base[0], payload_len - first_len);
+    }
+    if(ext_payload_len > 0) {
+        crc32_block(&self->tx_checksum, ext_payload, ext_payload_len);
+    }
 
     for(i = 0, n = payload_len; n > 0; n--, i++) {
-        stuffed_tx_byte(self, payload_base[payload_offset]);
+        stuffed_tx_byte_no_crc(self, payload_base[payload_offset]);
         payload_offset++;
         payload_offset &= payload_mask;
     }
+    for(i = 0; i < ext_payload_len; i++) {
+        stuffed_tx_byte_no_crc(self, ext_payload[i]);
+    }
 
     checksum = crc32_finalize(&self->tx_checksum);
 
@@ -129,6 +184,8 @@ static void on_wire_bytes(struct min_context *self, uint8_t id_control, uint8_t
     min_tx_byte(self->port, EOF_BYTE);
 
     min_tx_finished(self->port);
+
+    self->tx_frames++;
 }
 
 #ifdef TRANSPORT_PROTOCOL
@@ -152,6 +209,23 @@ static void transport_fifo_pop(struct min_context *self)
     self->transport_fifo.n_ring_buffer_bytes -= frame->payload_len;
 }
 
+// Round trip of a frame that was just ACKed; a retransmitted frame can't tell which copy got through
+static void transport_record_rtt(struct min_context *self, struct transport_frame *frame)
+{
+    uint32_t rtt = now - frame->last_sent_time_ms;
+    uint8_t bucket = 0;
+
+    if(frame->retransmitted) {
+        return;
+    }
+    while(bucket < TRANSPORT_RTT_BUCKETS - 1U && rtt >= ((uint32_t)TRANSPORT_RTT_BUCKET0_MS << bucket)) {
+        bucket++;
+    }
+    if(self->transport_fifo.ack_rtt_hist[bucket] < 0xffffU) {
+        self->transport_fifo.ack_rtt_hist[bucket]++;
+    }
+}
+
 // Claim a buffer slot from the FIFO. Returns 0 if there is no space.
 static struct transport_frame *transport_fifo_push(struct min_context *self, uint16_t data_size)
 {
@@ -204,7 +278,8 @@ static struct transport_frame *transport_fifo_get(struct min_context *self, uint
 static void transport_fifo_send(struct min_context *self, struct transport_frame *frame)
 {
     min_debug_print("transport_fifo_send: min_id=%d, seq=%d, payload_len=%d\n", frame->min_id, frame->seq, frame->payload_len);
-    on_wire_bytes(self, frame->min_id | (uint8_t)0x80U, frame->seq, payloads_ring_buffer, frame->payload_offset, TRANSPORT_FIFO_SIZE_FRAME_DATA_MASK, frame->payload_len);
+    on_wire_bytes(self, frame->min_id | (uint8_t)0x80U, frame->seq, payloads_ring_buffer, frame->payload_offset, TRANSPORT_FIFO_SIZE_FRAME_DATA_MASK, frame->payload_len,
+                  frame->ext_payload, frame->ext_payload_len);
     frame->last_sent_time_ms = now;
 }
 
@@ -215,7 +290,7 @@ static void send_ack(struct min_context *self)
     // always the same as the sequence number.
     min_debug_print("send ACK: seq=%d\n", self->transport_fifo.rn);
     if(ON_WIRE_SIZE(0) <= min_tx_space(self->port)) {
-        on_wire_bytes(self, ACK, self->transport_fifo.rn, &self->transport_fifo.rn, 0, 0xffffU, 1U);
+        on_wire_bytes(self, ACK, self->transport_fifo.rn, &self->transport_fifo.rn, 0, 0xffffU, 1U, 0, 0);
         self->transport_fifo.last_sent_ack_time_ms = now;
     }
 }
@@ -225,7 +300,7 @@ static void send_reset(struct min_context *self)
 {
     min_debug_print("send RESET\n");
     if(ON_WIRE_SIZE(0) <= min_tx_space(self->port)) {
-        on_wire_bytes(self, RESET, 0, 0, 0, 0, 0);
+        on_wire_bytes(self, RESET, 0, 0, 0, 0, 0, 0, 0);
     }
 }
 
@@ -258,10 +333,26 @@ void min_transport_reset(struct min_context *self, bool inform_other_side)
     transport_fifo_reset(self);
 }
 
+// Returns true if a frame with the given payload length would be accepted by min_queue_frame()
+// API call.
+bool min_queue_has_space_for_frame(struct min_context *self, uint8_t payload_len)
+{
+    return self->transport_fifo.n_frames < TRANSPORT_FIFO_MAX_FRAMES &&
+           self->transport_fifo.n_ring_buffer_bytes <= TRANSPORT_FIFO_MAX_FRAME_DATA - payload_len;
+}
+
 // Queues a MIN ID / payload frame into the outgoing FIFO
 // API call.
 // Returns true if the frame was queued OK.
 bool min_queue_frame(struct min_context *self, uint8_t min_id, uint8_t *payload, uint8_t payload_len)
+{
+    return min_queue_frame_ref(self, min_id, payload, payload_len, 0, 0);
+}
+
+// Queues a frame that is only partly copied into the FIFO: ext_payload is sent (and re-sent) from where it is.
+// API call.
+bool min_queue_frame_ref(struct min_context *self, uint8_t min_id, uint8_t *payload, uint8_t payload_len,
+                         const uint8_t *ext_payload, uint8_t ext_payload_len)
 {
     struct transport_frame *frame = transport_fifo_push(self, payload_len); // Claim a FIFO slot, reserve space for payload
 
@@ -270,6 +361,8 @@ bool min_queue_frame(struct min_context *self, uint8_t min_id, uint8_t *payload,
         // Copy frame details into frame slot, copy payload into ring buffer
         frame->min_id = min_id & (uint8_t)0x3fU;
         frame->payload_len = payload_len;
+        frame->ext_payload = ext_payload;
+        frame->ext_payload_len = ext_payload_len;
 
         uint16_t payload_offset = frame->payload_offset;
         uint32_t i;
@@ -315,6 +408,28 @@ static struct transport_frame *find_retransmit_frame(struct min_context *self)
 
     return oldest_frame;
 }
+
+// Long enough for the whole window to be transmitted plus an ACK / NACK to get back. With blocking UART
+// writes, the ACK of the oldest frame is only read after the rest of the window went out.
+static uint32_t retransmit_timeout_ms(struct min_context *self)
+{
+    uint8_t window_size = self->transport_fifo.sn_max - self->transport_fifo.sn_min;
+    uint8_t idx = self->transport_fifo.head_idx;
+    uint32_t window_bytes = 0;
+    uint8_t i;
+
+    for(i = 0; i < window_size; i++) {
+        struct transport_frame *frame = &self->transport_fifo.frames[idx];
+        window_bytes += ON_WIRE_SIZE(frame->payload_len + frame->ext_payload_len);
+        idx++;
+        idx &= TRANSPORT_FIFO_SIZE_FRAMES_MASK;
+    }
+    if(window_bytes > 0xffffU) {
+        window_bytes = 0xffffU;
+    }
+
+    return TRANSPORT_FRAME_RETRANSMIT_TIMEOUT_MS + min_tx_time_ms(self->port, (uint16_t)window_bytes);
+}
 #endif // TRANSPORT_PROTOCOL
 
 // This runs the receiving half of the transport protocol, acknowledging frames received, discarding
@@ -325,6 +440,8 @@ static void valid_frame_received(struct min_context *self)
     uint8_t *payload = self->rx_frame_payload_buf;
     uint8_t payload_len = self->rx_control;
 
+    self->rx_frames++;
+
 #ifdef TRANSPORT_PROTOCOL
     uint8_t seq = self->rx_frame_seq;
     uint8_t num_acked;
@@ -356,12 +473,15 @@ static void valid_frame_received(struct min_context *self)
                 min_debug_print("Received ACK seq=%d, num_acked=%d, num_nacked=%d\n", seq, num_acked, num_nacked);
                 uint8_t i;
                 for(i = 0; i < num_acked; i++) {
+                    transport_record_rtt(self, &self->transport_fifo.frames[self->transport_fifo.head_idx]);
                     transport_fifo_pop(self);
                 }
                 uint8_t idx = self->transport_fifo.head_idx;
                 // Now retransmit the number of frames that were requested
                 for(i = 0; i < num_nacked; i++) {
                     struct transport_frame *retransmit_frame = &self->transport_fifo.frames[idx];
+                    retransmit_frame->retransmitted = 1U;
+                    self->transport_fifo.retransmits++;
                     transport_fifo_send(self, retransmit_frame);
                     idx++;
                     idx &= TRANSPORT_FIFO_SIZE_FRAMES_MASK;
@@ -523,6 +643,7 @@ static void rx_byte(struct min_context *self, uint8_t byte)
             crc = crc32_finalize(&self->rx_checksum);
             if(self->rx_frame_checksum != crc) {
                 // Frame fails the checksum and so is dropped
+                self->rx_checksum_errors++;
                 self->rx_frame_state = SEARCHING_FOR_SOF;
             }
             else {
@@ -535,6 +656,9 @@ static void rx_byte(struct min_context *self, uint8_t byte)
                 // Frame received OK, pass up data to handler
                 valid_frame_received(self);
             }
+            else {
+                self->rx_eof_errors++;
+            }
             // else discard
             // Look for next frame */
             self->rx_frame_state = SEARCHING_FOR_SOF;
@@ -550,6 +674,12 @@ static void rx_byte(struct min_context *self, uint8_t byte)
 void min_poll(struct min_context *self, uint8_t *buf, uint32_t buf_len)
 {
     uint32_t i;
+
+#ifdef TRANSPORT_PROTOCOL
+    // before the received bytes: ACK round trips and receive times are taken from now
+    now = min_time_ms();
+#endif
+
     for(i = 0; i < buf_len; i++) {
         rx_byte(self, buf[i]);
     }
@@ -557,8 +687,6 @@ void min_poll(struct min_context *self, uint8_t *buf, uint32_t buf_len)
 #ifdef TRANSPORT_PROTOCOL
     uint8_t window_size;
 
-    now = 0;//TODO; min_time_ms();
-
     bool remote_connected = (now - self->transport_fifo.last_received_anything_ms < TRANSPORT_IDLE_TIMEOUT_MS);
     bool remote_active = (now - self->transport_fifo.last_received_frame_ms < TRANSPORT_IDLE_TIMEOUT_MS);
 
@@ -567,8 +695,9 @@ void min_poll(struct min_context *self, uint8_t *buf, uint32_t buf_len)
     if((window_size < TRANSPORT_MAX_WINDOW_SIZE) && (self->transport_fifo.n_frames > window_size)) {
         // There are new frames we can send; but don't even bother if there's no buffer space for them
         struct transport_frame *frame = transport_fifo_get(self, window_size);
-        if(ON_WIRE_SIZE(frame->payload_len) < min_tx_space(self->port)) {
+        if(ON_WIRE_SIZE(frame->payload_len + frame->ext_payload_len) < min_tx_space(self->port)) {
             frame->seq = self->transport_fifo.sn_max;
+            frame->retransmitted = 0;
             transport_fifo_send(self, frame);
 
             // Move window on
@@ -580,9 +709,11 @@ void min_poll(struct min_context *self, uint8_t *buf, uint32_t buf_len)
         if((window_size > 0) && remote_connected) {
             // There are unacknowledged frames. Can re-send an old frame. Pick the least recently sent one.
             struct transport_frame *oldest_frame = find_retransmit_frame(self);
-            if(now - oldest_frame->last_sent_time_ms >= TRANSPORT_FRAME_RETRANSMIT_TIMEOUT_MS) {
+            if(now - oldest_frame->last_sent_time_ms >= retransmit_timeout_ms(self)) {
                 // Resending oldest frame if there's a chance there's enough space to send it
-                if(ON_WIRE_SIZE(oldest_frame->payload_len) <= min_tx_space(self->port)) {
+                if(ON_WIRE_SIZE(oldest_frame->payload_len + oldest_frame->ext_payload_len) <= min_tx_space(self->port)) {
+                    oldest_frame->retransmitted = 1U;
+                    self->transport_fifo.retransmits++;
                     transport_fifo_send(self, oldest_frame);
                 }
             }
@@ -607,15 +738,33 @@ void min_init_context(struct min_context *self, uint8_t port)
     self->rx_frame_state = SEARCHING_FOR_SOF;
     self->port = port;
 
+    min_reset_stats(self);
+
+#ifdef TRANSPORT_PROTOCOL
+    transport_fifo_reset(self);
+#endif // TRANSPORT_PROTOCOL
+}
+
+void min_reset_stats(struct min_context *self)
+{
+    self->tx_frames = 0;
+    self->rx_frames = 0;
+    self->rx_checksum_errors = 0;
+    self->rx_eof_errors = 0;
+
 #ifdef TRANSPORT_PROTOCOL
     // Counters for diagnosis purposes
+    uint8_t i;
     self->transport_fifo.spurious_acks = 0;
     self->transport_fifo.sequence_mismatch_drop = 0;
     self->transport_fifo.dropped_frames = 0;
     self->transport_fifo.resets_received = 0;
+    self->transport_fifo.retransmits = 0;
     self->transport_fifo.n_ring_buffer_bytes_max = 0;
     self->transport_fifo.n_frames_max = 0;
-    transport_fifo_reset(self);
+    for(i = 0; i < TRANSPORT_RTT_BUCKETS; i++) {
+        self->transport_fifo.ack_rtt_hist[i] = 0;
+    }
 #endif // TRANSPORT_PROTOCOL
 }
 
@@ -623,14 +772,25 @@ void min_init_context(struct min_context *self, uint8_t port)
 void min_send_frame(struct min_context *self, uint8_t min_id, uint8_t *payload, uint8_t payload_len)
 {
     if((ON_WIRE_SIZE(payload_len) <= min_tx_space(self->port))) {
-        on_wire_bytes(self, min_id & (uint8_t) 0x3fU, 0, payload, 0, 0xffffU, payload_len);
+        on_wire_bytes(self, min_id & (uint8_t) 0x3fU, 0, payload, 0, 0xffffU, payload_len, 0, 0);
     }
 }
 
 // CALLBACK. Must return current buffer space in the given port. Used to check that a frame can be
 // queued.
 uint16_t min_tx_space(uint8_t port){
-    return 256;
+    return 512; // UART writes are blocking, make sure a full 255 byte frame (plus stuff bytes) always fits
+}
+
+// CALLBACK. Must return current time in milliseconds.
+uint32_t min_time_ms(void){
+    return Clock_getTicks(); // Clock.tickPeriod = 1 ms
+}
+
+// CALLBACK. Must return the time n_bytes take on the wire (10 bits per byte, stuff bytes not counted).
+uint32_t min_tx_time_ms(uint8_t port, uint16_t n_bytes){
+    uint32_t baudrate = uart_wifi_get_baudrate();
+    return ((uint32_t)n_bytes * 10000U + baudrate - 1U) / baudrate;
 }
 
 // CALLBACK. Send a byte on the given line.
@@ -644,9 +804,4 @@ void min_tx_start(uint8_t port)
 void min_tx_finished(uint8_t port)
 {}
 
-void min_application_handler(uint8_t min_id, uint8_t *min_payload, uint8_t len_payload, uint8_t port)
-{
-    static uint8_t count = 0x30;
-    count = count+1;
-    uart_serial_print_event('N', &count, 1);
-}
+// CALLBACK min_application_handler() is implemented in wifi_commands.c (wifi command dispatcher)
@@ -18,6 +18,10 @@
 // -  Define MAX_PAYLOAD if the size of the frames is to be limited. This is particularly useful with the transport
 //    protocol where a deep FIFO is wanted but not for large frames.
 //
+// -  The CRC32 is table driven by default (1 kB table, min_crc32_tables.h). Define MIN_CRC32_SLICE_BY_4 to
+//    checksum outgoing payloads 4 bytes at a time (4 kB of tables) or MIN_CRC32_BITWISE to go back to the
+//    table-less bit-by-bit version. All variants give identical frames on the wire.
+//
 // The API is as follows:
 //
 // -  min_init_context()
@@ -55,6 +59,10 @@
 // -  min_time_ms()
 //    This is called to obtain current time in milliseconds. This is used by the MIN transport protocol to drive
 //    timeouts and retransmits.
+//
+// -  min_tx_time_ms()
+//    Time the given number of bytes takes on the wire. The frame retransmit timeout grows with it, so that slow
+//    links with long frames do not retransmit frames whose ACK is simply not back yet.
 
 
 #ifndef MIN_H
@@ -75,14 +83,20 @@
 #define MAX_PAYLOAD                                 (255U)
 #endif
 
-// Powers of two for FIFO management. Default is 16 frames in the FIFO, total of 1024 bytes for frame data
+// Powers of two for FIFO management. Default is 16 frames in the FIFO, total of 512 bytes for frame data
+// (log download frames reference the FRAM directly, see min_queue_frame_ref(); only their headers and
+// compressed chunks are copied)
 #ifndef TRANSPORT_FIFO_SIZE_FRAMES_BITS
 #define TRANSPORT_FIFO_SIZE_FRAMES_BITS             (4U)
 #endif
 #ifndef TRANSPORT_FIFO_SIZE_FRAME_DATA_BITS
-#define TRANSPORT_FIFO_SIZE_FRAME_DATA_BITS         (10U)
+#define TRANSPORT_FIFO_SIZE_FRAME_DATA_BITS         (9U)
 #endif
 
+// ACK round trip histogram: bucket i counts round trips below (TRANSPORT_RTT_BUCKET0_MS << i), the last one the rest
+#define TRANSPORT_RTT_BUCKETS                       (8U)
+#define TRANSPORT_RTT_BUCKET0_MS                    (4U)
+
 #define TRANSPORT_FIFO_MAX_FRAMES                   (1U << TRANSPORT_FIFO_SIZE_FRAMES_BITS)
 #define TRANSPORT_FIFO_MAX_FRAME_DATA               (1U << TRANSPORT_FIFO_SIZE_FRAME_DATA_BITS)
 
@@ -122,10 +136,13 @@ struct crc32_context {
 
 struct transport_frame {
     uint32_t last_sent_time_ms;                     // When frame was last sent (used for re-send timeouts)
+    const uint8_t *ext_payload;                     // Rest of the payload outside of the ring buffer (e.g. in FRAM)
     uint16_t payload_offset;                        // Where in the ring buffer the payload is
-    uint8_t payload_len;                            // How big the payload is
+    uint8_t payload_len;                            // How big the payload is (bytes in the ring buffer)
+    uint8_t ext_payload_len;
     uint8_t min_id;                                 // ID of frame
     uint8_t seq;                                    // Sequence number of frame
+    uint8_t retransmitted;                          // Sent more than once (no round trip measurement)
 };
 
 struct transport_fifo {
@@ -137,6 +154,8 @@ struct transport_fifo {
     uint32_t spurious_acks;
     uint32_t sequence_mismatch_drop;
     uint32_t resets_received;
+    uint32_t retransmits;
+    uint16_t ack_rtt_hist[TRANSPORT_RTT_BUCKETS];   // Time from sending a frame to its ACK (first transmissions only)
     uint16_t n_ring_buffer_bytes;                   // Number of bytes used in the payload ring buffer
     uint16_t n_ring_buffer_bytes_max;               // Largest number of bytes ever used
     uint16_t ring_buffer_tail_offset;               // Tail of the payload ring buffer
@@ -167,11 +186,23 @@ struct min_context {
     uint8_t rx_control;                             // Control byte
     uint8_t tx_header_byte_countdown;               // Count out the header bytes
     uint8_t port;                                   // Number of the port associated with the context
+    uint32_t tx_frames;                             // Diagnostic counters (all frames, including ACKs)
+    uint32_t rx_frames;
+    uint32_t rx_checksum_errors;
+    uint32_t rx_eof_errors;
 };
 
 #ifdef TRANSPORT_PROTOCOL
 // Queue a MIN frame in the transport queue
 bool min_queue_frame(struct min_context *self, uint8_t min_id, uint8_t *payload, uint8_t payload_len);
+
+// Queue a frame whose payload is payload (copied) followed by ext_payload (not copied). ext_payload must
+// stay unchanged until the frame is acknowledged or the transport is reset. payload_len + ext_payload_len <= 255.
+bool min_queue_frame_ref(struct min_context *self, uint8_t min_id, uint8_t *payload, uint8_t payload_len,
+                         const uint8_t *ext_payload, uint8_t ext_payload_len);
+
+// Check if there is space in the transport queue for a frame with payload_len bytes to copy
+bool min_queue_has_space_for_frame(struct min_context *self, uint8_t payload_len);
 #endif
 
 // Send a non-transport frame MIN frame
@@ -185,6 +216,9 @@ void min_poll(struct min_context *self, uint8_t *buf, uint32_t buf_len);
 // Reset the state machine and (optionally) tell the other side that we have done so
 void min_transport_reset(struct min_context *self, bool inform_other_side);
 
+// Clear the diagnostic counters
+void min_reset_stats(struct min_context *self);
+
 // CALLBACK. Handle incoming MIN frame
 void min_application_handler(uint8_t min_id, uint8_t *min_payload, uint8_t len_payload, uint8_t port);
 
@@ -192,6 +226,9 @@ void min_application_handler(uint8_t min_id, uint8_t *min_payload, uint8_t len_p
 // CALLBACK. Must return current time in milliseconds.
 // Typically a tick timer interrupt will increment a 32-bit variable every 1ms (e.g. SysTick on Cortex M ARM devices).
 uint32_t min_time_ms(void);
+
+// CALLBACK. Must return the time in milliseconds that n_bytes take on the wire of the given port.
+uint32_t min_tx_time_ms(uint8_t port, uint16_t n_bytes);
 #endif
 
 // CALLBACK. Must return current buffer space in the given port. Used to check that a frame can be
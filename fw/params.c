@@ -0,0 +1,106 @@
+/*
+ * params.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Tuning parameters in FRAM, so every box can be set up in the field (wifi 'P' command)
+ *  without reflashing. The table is protected by a version number and a CRC16 (hardware
+ *  CRC module), a damaged or outdated table is replaced by the defaults at startup.
+ */
+
+#include "params.h"
+
+#include <stddef.h>
+
+#include <msp430.h>
+#include <inc/hw_memmap.h>
+#include <crc.h>
+
+#include <ti/sysbios/hal/Hwi.h>
+
+#define PARAMS_CRC_SEED     0xFFFF
+
+struct param_limits {
+    int32_t def;
+    int32_t min;
+    int32_t max;
+};
+
+static const struct param_limits param_limits[PARAM_COUNT] = {
+    {50000, 1000,   8000000},   // PARAM_WEIGHT_THRESHOLD: ADC_VAL = 1098.9 * GRAMS + OFFSET; R^2 = 0.99999
+    {1000,  100,    60000},     // PARAM_T_LOADCELL_POLL
+    {200,   20,     2000},      // PARAM_RFID_TIMEOUT
+    {1000,  100,    60000},     // PARAM_T_RFID_RETRY
+    {30000, 1000,   3600000},   // PARAM_BAT_TEST_INTERVAL
+    {10,    1,      64},        // PARAM_N_AVERAGES
+    {1000,  10,     100000},    // PARAM_SAMPLE_TOLERANCE
+    {115200, 9600,  460800},    // PARAM_SD_BAUDRATE: only rates in uartEUSCIABaudrates work
+    {0,     0,      1},         // PARAM_SD_COMPRESS
+};
+
+struct param_store {
+    uint16_t version;
+    uint16_t count;
+    int32_t value[PARAM_COUNT];
+    uint16_t crc;
+};
+
+#pragma PERSISTENT(param_store)
+static struct param_store param_store = {0,};
+
+static uint16_t params_crc()
+{
+    unsigned int i;
+    const uint16_t *data = (const uint16_t *)&param_store;
+
+    CRC_setSeed(CRC_BASE, PARAMS_CRC_SEED);
+    for(i = 0; i < offsetof(struct param_store, crc)/2; i++)
+        CRC_set16BitData(CRC_BASE, data[i]);
+
+    return CRC_getResult(CRC_BASE);
+}
+
+void params_init()
+{
+    uint8_t i;
+
+    if(param_store.version == PARAMS_VERSION && param_store.count == PARAM_COUNT && param_store.crc == params_crc())
+        return;
+
+    param_store.version = PARAMS_VERSION;
+    param_store.count = PARAM_COUNT;
+    for(i = 0; i < PARAM_COUNT; i++)
+        param_store.value[i] = param_limits[i].def;
+    param_store.crc = params_crc();
+}
+
+int32_t params_get(uint8_t id)
+{
+    int32_t value;
+    unsigned int key;
+
+    if(id >= PARAM_COUNT)
+        return 0;
+
+    key = Hwi_disable(); // 32bit values are written in two steps
+    value = param_store.value[id];
+    Hwi_restore(key);
+
+    return value;
+}
+
+int params_set(uint8_t id, int32_t value)
+{
+    unsigned int key;
+
+    if(id >= PARAM_COUNT || value < param_limits[id].min || value > param_limits[id].max)
+        return 0;
+
+    key = Hwi_disable();
+    param_store.value[id] = value;
+    param_store.crc = params_crc();
+    Hwi_restore(key);
+
+    return 1;
+}
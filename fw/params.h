@@ -0,0 +1,37 @@
+/*
+ * params.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_PARAMS_H_
+#define FW_PARAMS_H_
+
+#include <stdint.h>
+
+#define PARAMS_VERSION      2   // increase when the table below changes: stored values are replaced by the defaults
+
+// tuning parameters, the numbers are used over wifi ('P' command): only append!
+enum param_id {
+    PARAM_WEIGHT_THRESHOLD = 0, // raw ADC units above the zero offset that start an event
+    PARAM_T_LOADCELL_POLL,      // ms between two load cell polls
+    PARAM_RFID_TIMEOUT,         // ms, RFID detection window
+    PARAM_T_RFID_RETRY,         // ms, wait after a weight without RFID tag
+    PARAM_BAT_TEST_INTERVAL,    // ms between two battery measurements
+    PARAM_N_AVERAGES,           // ADC samples per averaged weight sample
+    PARAM_SAMPLE_TOLERANCE,     // raw ADC units, maximum variation within one averaged sample
+    PARAM_SD_BAUDRATE,          // baud, UART to the SD logger; must match the config file of the SD logger
+    PARAM_SD_COMPRESS,          // 1: log flush to the SD logger as LZSS blocks ('Z' lines, see logger.c)
+    PARAM_COUNT
+};
+
+// checks version and CRC of the stored table, restores the defaults if necessary. Call before BIOS_start().
+void params_init();
+
+int32_t params_get(uint8_t id);
+
+// returns 1 if the value was stored, 0 for an unknown id or a value out of range
+int params_set(uint8_t id, int32_t value);
+
+#endif /* FW_PARAMS_H_ */
@@ -0,0 +1,70 @@
+/*
+ * periodic.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Periodic tasks sleep to an absolute deadline instead of a relative Task_sleep(),
+ *  so the time spent in the loop body (ADC, SD card, UART) does not add up and the
+ *  next wake up time of every task is known in advance. If the period is a multiple of
+ *  PERIODIC_GRID_MS, the deadlines are rounded up to that grid: with the dynamic tick,
+ *  tasks that are due at the same time share one timer interrupt (the 1 s SecondsClock
+ *  tick runs on the same grid). Other periods (e.g. a 500 ms load cell poll) keep their
+ *  exact deadlines.
+ */
+
+#include "periodic.h"
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+
+static uint32_t periodic_align(uint32_t ticks, uint32_t period_ms)
+{
+    if(period_ms % PERIODIC_GRID_MS != 0)
+        return ticks;
+    return ((ticks + PERIODIC_GRID_MS - 1) / PERIODIC_GRID_MS) * PERIODIC_GRID_MS;
+}
+
+void periodic_start(periodic_t *p, uint32_t period_ms)
+{
+    p->deadline = periodic_align(Clock_getTicks() + period_ms, period_ms);
+    p->missed = 0;
+}
+
+void periodic_sleep(periodic_t *p, uint32_t period_ms)
+{
+    uint32_t now = Clock_getTicks();
+    int32_t remaining = (int32_t)(p->deadline - now);
+
+    if(remaining <= 0)
+    {
+        // late (long SD write or the tick was stopped during a system pause): next grid point
+        p->missed += 1;
+        p->deadline = periodic_align(now + 1, period_ms);
+        remaining = (int32_t)(p->deadline - now);
+    }
+
+    Task_sleep((UInt32)remaining);
+    p->deadline = periodic_align(p->deadline + period_ms, period_ms);
+}
+
+int periodic_due(periodic_t *p, uint32_t period_ms)
+{
+    uint32_t now = Clock_getTicks();
+
+    if((int32_t)(p->deadline - now) > 0)
+        return 0;
+
+    p->deadline = periodic_align(p->deadline + period_ms, period_ms);
+    if((int32_t)(p->deadline - now) <= 0)
+    {
+        p->missed += 1;
+        p->deadline = periodic_align(now + 1, period_ms);
+    }
+    return 1;
+}
+
+int32_t periodic_remaining(const periodic_t *p)
+{
+    return (int32_t)(p->deadline - Clock_getTicks());
+}
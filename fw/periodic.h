@@ -0,0 +1,33 @@
+/*
+ * periodic.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_PERIODIC_H_
+#define FW_PERIODIC_H_
+
+#include <stdint.h>
+
+// deadlines of periods that are multiples of this (ms) are aligned to it, so these tasks wake up on the same tick
+#define PERIODIC_GRID_MS    1000
+
+// absolute wake up time of a periodic task, in clock ticks (ms)
+typedef struct {
+    uint32_t deadline;
+    uint32_t missed;    // periods that were skipped because the task was late
+} periodic_t;
+
+// first deadline is one period from now; also to restart after a phase that is not periodic
+void periodic_start(periodic_t *p, uint32_t period_ms);
+
+// sleep until the next deadline and advance it by period_ms (no drift from the task's own run time)
+void periodic_sleep(periodic_t *p, uint32_t period_ms);
+
+// without sleeping (event loop): returns 1 and advances the deadline if it is reached
+int periodic_due(periodic_t *p, uint32_t period_ms);
+// ms until the deadline, <= 0 if it is due
+int32_t periodic_remaining(const periodic_t *p);
+
+#endif /* FW_PERIODIC_H_ */
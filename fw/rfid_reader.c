@@ -12,6 +12,9 @@
 #include "logger.h"
 #include <msp430.h>
 #include "user_button.h"
+#include "energy.h"
+#include "trace.h"
+#include "clock_policy.h"
 
 #include <time.h>
 #include <ti/sysbios/hal/Seconds.h>
@@ -100,7 +103,10 @@ void rfid_start_detection()
 {
 	lf_tagdata.valid = 0;
 	GPIO_write(nbox_5v_enable,1);
+	energy_on(ENERGY_5V);
+	clock_request_fast(CLOCK_USER_RFID);
 	mlx90109_activate_reader(&mlx_dev);
+	trace_rfid_field(1);
 	em4095_startRfidCapture();
 }
 
@@ -113,15 +119,19 @@ void rfid_stop_detection()
 {
 	em4095_stopRfidCapture();
 	mlx90109_disable_reader(&mlx_dev, &lf_tagdata);
+	trace_rfid_field(0);
+	clock_release_fast(CLOCK_USER_RFID);
 #ifdef WIFI_USE_5V
 	if(!user_wifi_enabled())
 #endif
-	GPIO_write(nbox_5v_enable,0);
+	{
+	    GPIO_write(nbox_5v_enable,0);
+	    energy_off(ENERGY_5V);
+	}
 }
 
 volatile uint8_t last_bit = 0;
 volatile uint16_t last_timer_val = 0;
-static uint16_t timediff = 0;
 
 //one bit period = 500us = 62.5 cycles = shortest interval
 //mid interval = 750us = 94 cycles
@@ -188,9 +198,18 @@ void lf_tag_read_isr()
 //		mlx_dev.int_time[cnt] = (TA3R-mlx_dev.int_time[cnt]);
 #else
 	// for EM reader, this is the data pin with CCR!!!
-	timediff = TB0CCR2 - last_timer_val;
+	uint16_t timediff = TB0CCR2 - last_timer_val;
 	last_timer_val = TB0CCR2;
 
+	trace_rfid_edge(timediff);
+	rfid_decode_edge(timediff);
+#endif
+}
+
+// EM4100 Manchester decoding from the time between two falling edges (capture timer ticks).
+// Separate from the ISR so recorded traces (trace.c) can be replayed through it.
+void rfid_decode_edge(uint16_t timediff)
+{
 	if(timediff > 2000)
 	{
 		timediff = 0xFFFF - timediff;
@@ -236,7 +255,6 @@ void lf_tag_read_isr()
 		}
 
 	}
-#endif
 }
 
 
@@ -27,5 +27,6 @@ void rfid_reset_detection_counts();
 
 
 void lf_tag_read_isr();
+void rfid_decode_edge(uint16_t timediff);
 
 #endif /* FW_RFID_READER_H_ */
@@ -143,6 +143,7 @@ void rtc_update_system_time()
     ltm.tm_hour = RTCHOUR;   // Hours. Valid values are 0 to 23. // ((unix_timestamp % 86400) - (unix_timestamp % 3600))/3600; // Hour
     ltm.tm_min = RTCMIN;     // Minutes. Valid values are 0 to 59. //  ((unix_timestamp % 3600) - (unix_timestamp % 60))/60;      // Minute
     ltm.tm_sec = RTCSEC;     // Seconds. Valid values are 0 to 59. //(unix_timestamp % 60);                            // Seconds
+    ltm.tm_isdst = 0;        // the RTC runs on standard time; left uninitialized, mktime() may shift it by an hour
 
     unix_timestamp = mktime(&ltm) - 2208988800; // add offset from year 1900 to 1970.
 
@@ -215,6 +216,18 @@ void rtc_resume_system()
     }
 }
 
+// after a deep pause (LPM3.5) the RTC kept running, only the system time is lost.
+// The alarm flag was already read and cleared in deep_pause_init().
+void rtc_deep_resume(int alarm_wake)
+{
+    if(alarm_wake)
+        rtc_state = NIGHT_SHIFT;    // resume alarm
+    else
+        rtc_state = USER_INTERRUPT; // woken up by the user button
+
+    rtc_update_system_time();
+}
+
 // IV 0FFCEh
 // reacts to: RTCRDYIFG, RTCTEVIFG, RTCAIFG, RT0PSIFG, RT1PSIFG, RTCOFIFG, (RTCIV)
 void rtc_isr()
@@ -29,6 +29,8 @@ int rtc_is_it_time_to_pause();
 void rtc_pause_system();
 //turn on system again
 void rtc_resume_system();
+//system restarted from a deep pause: time of day and wake up reason from the RTC
+void rtc_deep_resume(int alarm_wake);
 
 
 #endif /* FW_RTC_H_ */
@@ -0,0 +1,93 @@
+/*
+ * service_loop.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Event loop mode (USE_EVENT_LOOP): the battery monitor, the log flush and the PIR wake up
+ *  run to completion in one task instead of three tasks that mostly sleep. Periodic work
+ *  is due at absolute deadlines (periodic.c), interrupts post events; in between the task
+ *  pends on the service event with a timeout until the earliest deadline. Saves two task stacks.
+ *  The load cell, RFID and user button (wifi) tasks stay tasks: they block on semaphores and
+ *  on SPI/UART transfers in the middle of their work.
+ */
+
+#include "service_loop.h"
+#include "battery_monitor.h"
+#include "logger.h"
+#include "PIR_wakeup.h"
+#include "params.h"
+#include "periodic.h"
+#include "../Board.h"
+
+#include <xdc/cfg/global.h> //needed for the event object
+
+enum service_job {
+    SERVICE_BATTERY = 0,
+    SERVICE_LOG,
+    SERVICE_JOB_COUNT
+};
+
+void service_post(UInt events)
+{
+    Event_post((Event_Handle)evtService, events);
+}
+
+static uint32_t service_period(unsigned int job)
+{
+    if(job == SERVICE_BATTERY)
+        return params_get(PARAM_BAT_TEST_INTERVAL);
+    return T_LOG_FLUSH_CHECK;
+}
+
+static void service_run(unsigned int job)
+{
+    if(job == SERVICE_BATTERY)
+        battery_step();
+    else
+        log_task_step();
+}
+
+void service_Task()
+{
+    periodic_t period[SERVICE_JOB_COUNT];
+    unsigned int i;
+
+    log_task_start(); // the log (and the time from FRAM) before the first entry
+    battery_start();
+#if USE_PIR
+    PIR_wakeup_start();
+#endif
+
+    for(i = 0; i < SERVICE_JOB_COUNT; i++)
+        periodic_start(&period[i], service_period(i));
+
+    while(1)
+    {
+        int32_t timeout = periodic_remaining(&period[0]);
+        UInt events;
+
+        for(i = 1; i < SERVICE_JOB_COUNT; i++)
+        {
+            if(periodic_remaining(&period[i]) < timeout)
+                timeout = periodic_remaining(&period[i]);
+        }
+
+        events = Event_pend((Event_Handle)evtService, Event_Id_NONE, SERVICE_EVT_PIR,
+                            timeout > 0 ? (UInt)timeout : BIOS_NO_WAIT);
+
+#if USE_PIR
+        if(events & SERVICE_EVT_PIR)
+            PIR_wakeup_handle();
+#else
+        (void)events;
+#endif
+
+        // jobs on the same grid point run in one wake up
+        for(i = 0; i < SERVICE_JOB_COUNT; i++)
+        {
+            if(periodic_due(&period[i], service_period(i)))
+                service_run(i);
+        }
+    }
+}
@@ -0,0 +1,23 @@
+/*
+ * service_loop.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_SERVICE_LOOP_H_
+#define FW_SERVICE_LOOP_H_
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Event.h>
+
+// events posted from interrupts to the service task
+#define SERVICE_EVT_PIR         Event_Id_00
+
+// only with USE_EVENT_LOOP: replaces battery_Task, log_Task and PIR_wakeup_Task
+void service_Task();
+
+// ISR safe
+void service_post(UInt events);
+
+#endif /* FW_SERVICE_LOOP_H_ */
@@ -0,0 +1,91 @@
+/*
+ * stack_monitor.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Stack high water marks. SYS/BIOS fills all task stacks and the system stack with a
+ *  known pattern at startup (Task.initStackFlag, Hwi.initStackFlag); Task_stat() and
+ *  Hwi_getStackInfo() find the deepest overwritten word. The scan is done from the idle
+ *  loop, rate limited so it does not keep the CPU out of low power mode.
+ */
+
+#include "stack_monitor.h"
+
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+struct stack_entry {
+    Task_Handle task;
+    uint16_t size;
+    uint16_t peak;
+    uint8_t id;
+};
+
+static struct stack_entry entries[STACK_MONITOR_MAX_TASKS];
+static unsigned int n_entries = 0;
+static uint16_t hwi_size = 0;
+static uint16_t hwi_peak = 0;
+static uint32_t last_scan = 0;
+
+void stack_monitor_add(uint8_t id, Task_Handle task)
+{
+    if(n_entries >= STACK_MONITOR_MAX_TASKS)
+        return;
+
+    entries[n_entries].task = task;
+    entries[n_entries].id = id;
+    entries[n_entries].size = 0;
+    entries[n_entries].peak = 0;
+    n_entries++;
+}
+
+static void stack_monitor_scan()
+{
+    unsigned int i;
+    Task_Stat stat;
+    Hwi_StackInfo hwi_info;
+
+    for(i = 0; i < n_entries; i++)
+    {
+        Task_stat(entries[i].task, &stat);
+        entries[i].size = stat.stackSize;
+        entries[i].peak = stat.used;
+    }
+
+    Hwi_getStackInfo(&hwi_info, TRUE);
+    hwi_size = hwi_info.hwiStackSize;
+    hwi_peak = hwi_info.hwiStackPeak;
+}
+
+Void stack_monitor_idle()
+{
+    uint32_t now = Clock_getTicks();
+
+    if(last_scan != 0 && (now - last_scan) < STACK_SCAN_INTERVAL)
+        return;
+
+    last_scan = now | 1; // 0 means "not scanned yet"
+    stack_monitor_scan();
+}
+
+unsigned int stack_monitor_count()
+{
+    return n_entries;
+}
+
+uint8_t stack_monitor_get(unsigned int n, uint16_t *size, uint16_t *peak)
+{
+    if(n >= n_entries)
+        return 0;
+
+    *size = entries[n].size;
+    *peak = entries[n].peak;
+    return entries[n].id;
+}
+
+void stack_monitor_get_hwi(uint16_t *size, uint16_t *peak)
+{
+    *size = hwi_size;
+    *peak = hwi_peak;
+}
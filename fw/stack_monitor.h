@@ -0,0 +1,30 @@
+/*
+ * stack_monitor.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_STACK_MONITOR_H_
+#define FW_STACK_MONITOR_H_
+
+#include <stdint.h>
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Task.h>
+
+#define STACK_MONITOR_MAX_TASKS     8
+#define STACK_SCAN_INTERVAL         10000   // ms between two scans in the idle loop
+
+// register a task (in main(), after Task_construct), id: character used in the 'K' report
+void stack_monitor_add(uint8_t id, Task_Handle task);
+
+// idle function (nestbox_rtos.cfg): scans the stack fill patterns every STACK_SCAN_INTERVAL
+Void stack_monitor_idle();
+
+unsigned int stack_monitor_count();
+// peak and size in bytes of the n'th registered task, returns its id
+uint8_t stack_monitor_get(unsigned int n, uint16_t *size, uint16_t *peak);
+// system (Hwi/ISR) stack
+void stack_monitor_get_hwi(uint16_t *size, uint16_t *peak);
+
+#endif /* FW_STACK_MONITOR_H_ */
@@ -0,0 +1,125 @@
+/*
+ * telemetry.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Live load cell samples for calibration and field debugging. The load cell task puts
+ *  (decimated) samples into a small ring; the wifi task sends them in batches as
+ *  unreliable MIN frames. If the link does not keep up, the oldest samples are
+ *  overwritten and counted.
+ *
+ *  frame: 'v', dropped samples (16bit), n, n * (ticks (32bit, ms), phase, sample (32bit))
+ *  all big endian.
+ */
+
+#include "telemetry.h"
+#include "log_transfer.h"
+
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#define TELEMETRY_MIN_ID        0x33U
+#define TELEMETRY_SAMPLE_LEN    9
+
+struct telemetry_sample {
+    uint32_t ticks;
+    int32_t value;
+    uint8_t phase;
+};
+
+static struct telemetry_sample ring[TELEMETRY_RING_SIZE];
+static volatile unsigned int head = 0;   // next free slot
+static volatile unsigned int count = 0;
+static volatile uint16_t dropped = 0;
+
+static volatile uint8_t decimation = 0;
+static unsigned int decimation_cnt = 0;
+
+static uint8_t frame_buf[4 + TELEMETRY_BATCH*TELEMETRY_SAMPLE_LEN];
+
+void telemetry_subscribe(uint8_t new_decimation)
+{
+    unsigned int key = Hwi_disable();
+    count = 0;
+    dropped = 0;
+    decimation_cnt = 0;
+    decimation = new_decimation;
+    Hwi_restore(key);
+}
+
+void telemetry_unsubscribe()
+{
+    telemetry_subscribe(0);
+}
+
+int telemetry_active()
+{
+    return decimation > 0;
+}
+
+void telemetry_add_sample(uint8_t phase, int32_t sample)
+{
+    unsigned int key;
+
+    if(decimation == 0)
+        return;
+
+    decimation_cnt = decimation_cnt + 1;
+    if(decimation_cnt < decimation)
+        return;
+    decimation_cnt = 0;
+
+    key = Hwi_disable();
+    ring[head].ticks = Clock_getTicks();
+    ring[head].value = sample;
+    ring[head].phase = phase;
+    head = (head + 1) & (TELEMETRY_RING_SIZE-1);
+    if(count < TELEMETRY_RING_SIZE)
+        count = count + 1;
+    else
+        dropped = dropped + 1; // overwrote the oldest sample
+    Hwi_restore(key);
+}
+
+void telemetry_poll(struct min_context *ctx)
+{
+    unsigned int key;
+    unsigned int tail;
+    uint8_t n = 0;
+    uint8_t *p = &frame_buf[4];
+
+    // a running log download has priority, samples keep dropping meanwhile
+    if(count == 0 || log_transfer_active())
+        return;
+
+    key = Hwi_disable();
+    tail = (head - count) & (TELEMETRY_RING_SIZE-1);
+    while(count > 0 && n < TELEMETRY_BATCH)
+    {
+        struct telemetry_sample *s = &ring[tail];
+        p[0] = s->ticks >> 24;
+        p[1] = s->ticks >> 16;
+        p[2] = s->ticks >> 8;
+        p[3] = s->ticks;
+        p[4] = s->phase;
+        p[5] = s->value >> 24;
+        p[6] = s->value >> 16;
+        p[7] = s->value >> 8;
+        p[8] = s->value;
+        p += TELEMETRY_SAMPLE_LEN;
+
+        tail = (tail + 1) & (TELEMETRY_RING_SIZE-1);
+        count = count - 1;
+        n = n + 1;
+    }
+    frame_buf[1] = dropped >> 8;
+    frame_buf[2] = dropped;
+    Hwi_restore(key);
+
+    frame_buf[0] = 'v';
+    frame_buf[3] = n;
+
+    // the UART write happens outside the critical section
+    min_send_frame(ctx, TELEMETRY_MIN_ID, frame_buf, 4 + n*TELEMETRY_SAMPLE_LEN);
+}
@@ -0,0 +1,33 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_TELEMETRY_H_
+#define FW_TELEMETRY_H_
+
+#include <stdint.h>
+#include "min/min.h"
+
+#define TELEMETRY_RING_SIZE     16  // power of 2! samples waiting to be sent
+#define TELEMETRY_BATCH         16  // samples per 'v' frame
+
+// phases of the load cell state machine
+#define TELEMETRY_PHASE_POLL    'P' // idle polling, single shot mode
+#define TELEMETRY_PHASE_EVENT   'X' // continuous mode, bird on the perch
+#define TELEMETRY_PHASE_OFFSET  'O' // continuous mode, perch empty again
+
+// every decimation'th sample is streamed (0: off)
+void telemetry_subscribe(uint8_t decimation);
+void telemetry_unsubscribe();
+int telemetry_active();
+
+// load cell task: never blocks, the oldest sample is dropped when the ring is full
+void telemetry_add_sample(uint8_t phase, int32_t sample);
+
+// wifi task: sends the waiting samples as 'v' frames
+void telemetry_poll(struct min_context *ctx);
+
+#endif /* FW_TELEMETRY_H_ */
@@ -0,0 +1,255 @@
+/*
+ * trace.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Capture mode for algorithm work: raw load cell samples and RFID capture timer edges are
+ *  recorded in FRAM, bit-exact, and written to the SD card when the capture stops or the
+ *  FRAM is full. The trace survives a reset until the next capture is started.
+ *
+ *  Encoding: an RFID edge with a timer delta < 0x80 (the normal case, 62..125 ticks) is one
+ *  byte. Everything else starts with a record byte (trace.h) followed by LEB128 varints;
+ *  samples are stored as zigzag encoded difference to the previous sample.
+ *  trace_replay() (TRACE_REPLAY) decodes a trace, e.g. on the PC to feed rfid_decode_edge()
+ *  (host/test_trace_replay.c).
+ */
+
+#include "trace.h"
+#include "logger.h"
+
+#include <string.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/hal/Seconds.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#define TRACE_REC_MAX_LEN       11      // record byte + 2 varints
+
+#pragma PERSISTENT(trace_buf)
+static uint8_t trace_buf[TRACE_BUF_SIZE] = {0,};
+#pragma PERSISTENT(trace_len)
+static uint16_t trace_len = 0;
+#pragma PERSISTENT(trace_start_time)
+static uint32_t trace_start_time = 0;
+
+static volatile uint8_t streams = 0;
+static volatile uint8_t overflow = 0;
+static volatile uint8_t flush_pending = 0;
+static uint32_t last_ticks = 0;
+static int32_t last_sample = 0;
+
+static uint8_t* put_varint(uint8_t *p, uint32_t value)
+{
+    while(value >= 0x80)
+    {
+        *p++ = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    *p++ = value;
+    return p;
+}
+
+// ms since the last timed record
+static uint32_t trace_dt()
+{
+    uint32_t now = Clock_getTicks();
+    uint32_t dt = now - last_ticks;
+    last_ticks = now;
+    return dt;
+}
+
+// must be called with interrupts disabled
+static void trace_append(const uint8_t *rec, unsigned int n)
+{
+    if(trace_len + n > TRACE_BUF_SIZE)
+    {
+        // FRAM is full: stop here, the trace is complete up to this point
+        overflow = 1;
+        streams = 0;
+        flush_pending = 1;
+        return;
+    }
+    memcpy(&trace_buf[trace_len], rec, n);
+    trace_len += n;
+}
+
+void trace_start(uint8_t new_streams)
+{
+    unsigned int key = Hwi_disable();
+    streams = 0;
+    trace_len = 0;
+    trace_start_time = Seconds_get();
+    last_ticks = Clock_getTicks();
+    last_sample = 0;
+    overflow = 0;
+    flush_pending = 0;
+    streams = new_streams;
+    Hwi_restore(key);
+}
+
+void trace_stop()
+{
+    unsigned int key = Hwi_disable();
+    if(streams)
+        flush_pending = trace_len > 0;
+    streams = 0;
+    Hwi_restore(key);
+}
+
+uint8_t trace_streams()
+{
+    return streams;
+}
+
+uint16_t trace_get_length()
+{
+    return trace_len;
+}
+
+int trace_overflow()
+{
+    return overflow;
+}
+
+void trace_rfid_edge(uint16_t timer_delta)
+{
+    uint8_t rec[TRACE_REC_MAX_LEN];
+    uint8_t *p = rec;
+
+    if(!(streams & TRACE_RFID))
+        return;
+
+    if(timer_delta > 0 && timer_delta < 0x80)
+        *p++ = timer_delta;
+    else
+    {
+        *p++ = TRACE_REC_EDGE;
+        p = put_varint(p, timer_delta);
+    }
+    unsigned int key = Hwi_disable();
+    trace_append(rec, p - rec);
+    Hwi_restore(key);
+}
+
+void trace_rfid_field(int on)
+{
+    uint8_t rec[TRACE_REC_MAX_LEN];
+    uint8_t *p = rec;
+
+    if(!(streams & TRACE_RFID))
+        return;
+
+    unsigned int key = Hwi_disable();
+    *p++ = on ? TRACE_REC_FIELD_ON : TRACE_REC_FIELD_OFF;
+    p = put_varint(p, trace_dt());
+    trace_append(rec, p - rec);
+    Hwi_restore(key);
+}
+
+void trace_loadcell_sample(int32_t sample)
+{
+    uint8_t rec[TRACE_REC_MAX_LEN];
+    uint8_t *p = rec;
+    int32_t diff;
+
+    if(!(streams & TRACE_LOADCELL))
+        return;
+
+    unsigned int key = Hwi_disable();
+    diff = sample - last_sample;
+    last_sample = sample;
+    *p++ = TRACE_REC_SAMPLE;
+    p = put_varint(p, trace_dt());
+    p = put_varint(p, ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31));
+    trace_append(rec, p - rec);
+    Hwi_restore(key);
+}
+
+void trace_poll()
+{
+    if(!flush_pending || log_sd_card_busy())
+        return; // a running log flush: try again at the next log step
+
+    // one attempt, like the FRAM log flush: without SD logger (or with LOG_VERBOSE,
+    // where the trace goes to the debug UART) it would be sent again every log step
+    log_send_trace_via_uart(trace_start_time, trace_buf, trace_len);
+    flush_pending = 0;
+}
+
+#ifdef TRACE_REPLAY
+// returns the position after the varint, 0 if it runs past end
+static const uint8_t* get_varint(const uint8_t *p, const uint8_t *end, uint32_t *value)
+{
+    unsigned int shift = 0;
+
+    *value = 0;
+    while(p < end && shift < 35)
+    {
+        *value |= (uint32_t)(*p & 0x7f) << shift;
+        if(!(*p++ & 0x80))
+            return p;
+        shift += 7;
+    }
+    return 0;
+}
+
+uint16_t trace_replay(const uint8_t *buf, uint16_t len, const struct trace_replay_handler *h)
+{
+    const uint8_t *p = buf;
+    const uint8_t *end = buf + len;
+    uint32_t ms = 0;
+    int32_t sample = 0;
+    uint32_t value;
+
+    while(p < end)
+    {
+        uint8_t rec = *p;
+        const uint8_t *next = p + 1;
+
+        if(rec == TRACE_REC_END)
+            break;
+
+        if(rec < 0x80)
+        {
+            if(h->rfid_edge)
+                h->rfid_edge(rec);
+        }
+        else if(rec == TRACE_REC_EDGE)
+        {
+            next = get_varint(next, end, &value);
+            if(!next)
+                break;
+            if(h->rfid_edge)
+                h->rfid_edge((uint16_t)value);
+        }
+        else if(rec == TRACE_REC_SAMPLE)
+        {
+            next = get_varint(next, end, &value);
+            if(!next)
+                break;
+            ms += value;
+            next = get_varint(next, end, &value);
+            if(!next)
+                break;
+            sample += (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+            if(h->loadcell_sample)
+                h->loadcell_sample(ms, sample);
+        }
+        else if(rec == TRACE_REC_FIELD_ON || rec == TRACE_REC_FIELD_OFF)
+        {
+            next = get_varint(next, end, &value);
+            if(!next)
+                break;
+            ms += value;
+            if(h->rfid_field)
+                h->rfid_field(ms, rec == TRACE_REC_FIELD_ON);
+        }
+        else
+            break; // unknown record
+
+        p = next;
+    }
+
+    return p - buf;
+}
+#endif
@@ -0,0 +1,55 @@
+/*
+ * trace.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_TRACE_H_
+#define FW_TRACE_H_
+
+#include <stdint.h>
+
+#define TRACE_BUF_SIZE          4096    // bytes of FRAM for one capture
+
+// streams that can be captured
+#define TRACE_RFID              0x01    // EM4095 capture timer edges and field on/off
+#define TRACE_LOADCELL          0x02    // raw ADS1220 samples
+
+// record types (first byte); 0x01..0x7F is an RFID edge with this timer delta
+#define TRACE_REC_END           0x00    // unused FRAM
+#define TRACE_REC_EDGE          0x80    // varint timer delta
+#define TRACE_REC_SAMPLE        0x81    // varint ms since last record, zigzag varint sample delta
+#define TRACE_REC_FIELD_ON      0x82    // varint ms since last record
+#define TRACE_REC_FIELD_OFF     0x83    // varint ms since last record
+
+// clears the FRAM trace and starts recording the given streams
+void trace_start(uint8_t streams);
+// stops recording; the trace is written to the SD card by the log task
+void trace_stop();
+
+uint8_t trace_streams();
+uint16_t trace_get_length();
+int trace_overflow();
+
+// called from the RFID capture ISR / load cell task. No-op if the stream is not captured
+void trace_rfid_edge(uint16_t timer_delta);
+void trace_rfid_field(int on);
+void trace_loadcell_sample(int32_t sample);
+
+// log task: writes a finished trace to the SD card
+void trace_poll();
+
+#ifdef TRACE_REPLAY
+struct trace_replay_handler {
+    void (*rfid_edge)(uint16_t timer_delta);
+    void (*rfid_field)(uint32_t ms, int on);
+    void (*loadcell_sample)(uint32_t ms, int32_t sample);
+};
+
+// decodes a trace and calls the handlers in recorded order (ms: time since start of the capture);
+// returns the number of bytes used, less than len on a corrupt trace
+uint16_t trace_replay(const uint8_t *buf, uint16_t len, const struct trace_replay_handler *h);
+#endif
+
+#endif /* FW_TRACE_H_ */
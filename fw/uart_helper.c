@@ -5,10 +5,11 @@
  *      Author: raffael
  */
 
-#include <msp430.h>
 
 #include "../Board.h"
 #include "uart_helper.h"
+#include "energy.h"
+#include "clock_policy.h"
 #include <xdc/runtime/Timestamp.h>
 #include <ti/sysbios/hal/Seconds.h>
 
@@ -21,6 +22,69 @@ UART_Handle wifi_uart;
 static int debug_uart_initialized = 0;
 static int wifi_uart_initialized = 0;
 
+static uint32_t debug_baudrate = UART_DEFAULT_BAUDRATE;
+static uint32_t wifi_baudrate = UART_DEFAULT_BAUDRATE;
+
+// receive ring, filled from the UART interrupt (read callback mode)
+struct uart_rx_ring {
+    uint8_t buf[UART_RX_RING_SIZE];
+    volatile uint16_t head;         // written by the ISR
+    volatile uint16_t tail;         // written by the task
+    volatile uint16_t overruns;
+    uint8_t rx_byte;                // target of the pending UART_read()
+    volatile int enabled;           // re-arm UART_read() from the callback
+    Semaphore_Handle sem;           // posted on EOF byte or watermark
+};
+
+static struct uart_rx_ring wifi_rx_ring;
+
+static void uart_rx_ring_reset(struct uart_rx_ring* ring, Semaphore_Handle sem)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overruns = 0;
+    ring->sem = sem;
+    Semaphore_reset(sem, 0);
+}
+
+// runs in interrupt context
+static void uart_rx_ring_push(struct uart_rx_ring* ring, uint8_t byte)
+{
+    uint16_t next = (ring->head + 1) & (UART_RX_RING_SIZE - 1);
+
+    if(next == ring->tail)
+    {
+        ring->overruns++;
+        Semaphore_post(ring->sem);
+        return;
+    }
+    ring->buf[ring->head] = byte;
+    ring->head = next;
+
+    if(byte == UART_RX_WAKE_BYTE || ((ring->head - ring->tail) & (UART_RX_RING_SIZE - 1)) >= UART_RX_RING_WATERMARK)
+        Semaphore_post(ring->sem);
+}
+
+static size_t uart_rx_ring_pop(struct uart_rx_ring* ring, uint8_t *data, size_t n)
+{
+    size_t i = 0;
+    while(i < n && ring->tail != ring->head)
+    {
+        data[i++] = ring->buf[ring->tail];
+        ring->tail = (ring->tail + 1) & (UART_RX_RING_SIZE - 1);
+    }
+    return i;
+}
+
+static void uart_wifi_rx_callback(UART_Handle handle, void *buf, size_t count)
+{
+    if(count == 1)
+        uart_rx_ring_push(&wifi_rx_ring, wifi_rx_ring.rx_byte);
+
+    if(wifi_rx_ring.enabled)
+        UART_read(handle, &wifi_rx_ring.rx_byte, 1); // re-arm for the next byte
+}
+
 
 int uart_debug_open(){
 	static UART_Params uartParams;
@@ -28,8 +92,7 @@ int uart_debug_open(){
 	if(debug_uart_initialized == 0)
 	{
 	    //reset TX gpio register settings:
-	    P2OUT |= BIT5;
-	    P2SEL1 |= BIT5;
+	    Board_uart_tx_pin(Board_UART_debug, 1);
 
 		/* Create a UART with data processing off. */
 		UART_Params_init(&uartParams);
@@ -37,7 +100,7 @@ int uart_debug_open(){
 		uartParams.readDataMode = UART_DATA_BINARY;
 		uartParams.readReturnMode = UART_RETURN_FULL;
 		uartParams.readEcho = UART_ECHO_OFF;
-		uartParams.baudRate = 9600;
+		uartParams.baudRate = debug_baudrate;
 		//uartParams.readMode = UART_MODE_BLOCKING;
 		uartParams.readTimeout = 100;
 		//uartParams.dataLength = UART_LEN_8;
@@ -68,8 +131,7 @@ void uart_debug_close(){
         UART_close(debug_uart);
 
     //force write TX gpio to zero:
-    P2OUT &= ~BIT5;
-    P2SEL1 &= ~BIT5;
+    Board_uart_tx_pin(Board_UART_debug, 0);
 
     debug_uart_initialized = 0;
 #endif
@@ -82,8 +144,7 @@ int uart_wifi_open(){
     if(wifi_uart_initialized == 0)
     {
 //      reset TX gpio register settings:
-        P2OUT |= BIT0;
-        P2SEL1 |= BIT0;
+        Board_uart_tx_pin(Board_UART_wifi, 1);
 
         /* Create a UART with data processing off. */
         UART_Params_init(&uartParams);
@@ -91,9 +152,9 @@ int uart_wifi_open(){
         uartParams.readDataMode = UART_DATA_BINARY;
         uartParams.readReturnMode = UART_RETURN_FULL;
         uartParams.readEcho = UART_ECHO_OFF;
-        uartParams.baudRate = 9600;
-        //uartParams.readMode = UART_MODE_BLOCKING;
-        uartParams.readTimeout = 1000;
+        uartParams.baudRate = wifi_baudrate;
+        uartParams.readMode = UART_MODE_CALLBACK;
+        uartParams.readCallback = &uart_wifi_rx_callback;
         //uartParams.dataLength = UART_LEN_8;
 
         //Correct port for the mainboard
@@ -102,6 +163,10 @@ int uart_wifi_open(){
         if (wifi_uart == NULL)
             return 0;
 
+        uart_rx_ring_reset(&wifi_rx_ring, (Semaphore_Handle)semWifiRx);
+        wifi_rx_ring.enabled = 1;
+        UART_read(wifi_uart, &wifi_rx_ring.rx_byte, 1);
+
 #if(WIFI_UART_VERBOSE)
 
         const char test_string[] = "nestbox wifi UART initialized\n";
@@ -110,7 +175,7 @@ int uart_wifi_open(){
 
         {
             uint8_t my_rx_bytes[32];
-            int len=uart_serial_read(&wifi_uart, my_rx_bytes, 8);
+            int len=uart_wifi_rx_wait(my_rx_bytes, 8, 1000);
 
             wifi_uart_initialized = 1;
             uart_serial_write(&wifi_uart, my_rx_bytes, len);
@@ -118,6 +183,8 @@ int uart_wifi_open(){
 #endif
 
         wifi_uart_initialized = 1;
+        energy_on(ENERGY_WIFI);
+        clock_request_fast(CLOCK_USER_WIFI);
     }
 
     return 1;
@@ -125,18 +192,66 @@ int uart_wifi_open(){
 
 void uart_wifi_close(){
 
+    wifi_rx_ring.enabled = 0;
+    UART_readCancel(wifi_uart);
     UART_close(wifi_uart);
 
     //force write TX gpio to zero:
-    P2OUT &= ~BIT0; // !!! this actually sets it as input --> TODO!!!
-    P2SEL1 &= ~BIT0;
+    Board_uart_tx_pin(Board_UART_wifi, 0); // !!! this actually sets it as input --> TODO!!!
 
     wifi_uart_initialized = 0;
+    energy_off(ENERGY_WIFI);
+    clock_release_fast(CLOCK_USER_WIFI);
+}
+
+int uart_debug_set_baudrate(uint32_t baudrate)
+{
+    if(!nbox_uart_baudrate_supported(baudrate))
+        return 0;
+
+    debug_baudrate = baudrate;
+    return 1;
+}
+
+int uart_wifi_set_baudrate(uint32_t baudrate)
+{
+    if(!nbox_uart_baudrate_supported(baudrate))
+        return 0;
+
+    if(baudrate != wifi_baudrate)
+    {
+        wifi_baudrate = baudrate;
+        if(wifi_uart_initialized)
+        {
+            uart_wifi_close();
+            uart_wifi_open();
+        }
+    }
+    return 1;
+}
+
+size_t uart_wifi_rx_wait(uint8_t *data, size_t n, unsigned int timeout)
+{
+    if(wifi_rx_ring.tail == wifi_rx_ring.head)
+        Semaphore_pend(wifi_rx_ring.sem, timeout);
+    else
+        Semaphore_reset(wifi_rx_ring.sem, 0); // data is already waiting
+
+    return uart_rx_ring_pop(&wifi_rx_ring, data, n);
+}
+
+unsigned int uart_wifi_rx_overruns()
+{
+    return wifi_rx_ring.overruns;
+}
+
+uint32_t uart_wifi_get_baudrate()
+{
+    return wifi_baudrate;
 }
 
 void uart_wifi_set_floating(){
-    P2OUT &= ~BIT5;
-    P2SEL1 &= ~BIT5;
+    Board_uart_tx_pin(Board_UART_debug, 0);
 }
 
 
@@ -219,16 +334,16 @@ int uart_serial_getc(UART_Handle *dev)
 }
 
 //leading zeros only works for hexadecimal base!!!
-int ui2a(unsigned long num, unsigned long base, int uc, int leading_zeros,uint8_t* buffer)
+int ui2a(uint32_t num, uint32_t base, int uc, int leading_zeros,uint8_t* buffer)
 {
     int n=0;
-    unsigned long d=1;
+    uint32_t d=1;
     while (num/d >= base)
         d*=base;
     if(leading_zeros)
     {
-    		unsigned long tmp = num;
-    		while((!(tmp & 0xf0000000)) && (n<sizeof(long)*2-1))
+    		uint32_t tmp = num;
+    		while((!(tmp & 0xf0000000)) && (n<sizeof(uint32_t)*2-1))
     		{
     			tmp = tmp << 4;
     			*buffer++ = '0';
@@ -236,7 +351,7 @@ int ui2a(unsigned long num, unsigned long base, int uc, int leading_zeros,uint8_
     		}
     }
     while (d!=0) {
-        unsigned long dgt = num / d;
+        uint32_t dgt = num / d;
         num%= d;
         d/=base;
         if (n || dgt>0 || d==0) {
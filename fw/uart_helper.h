@@ -18,6 +18,12 @@
 
 #define UART_BUFFER_SIZE 50
 
+#define UART_DEFAULT_BAUDRATE   9600 // both sides fall back to this rate
+
+#define UART_RX_RING_SIZE       256  // power of 2! holds a full MIN frame
+#define UART_RX_RING_WATERMARK  64   // wake the reading task when this many bytes are waiting
+#define UART_RX_WAKE_BYTE       0x55 // MIN EOF byte: wake the reading task at the end of every frame
+
 extern UART_Handle debug_uart;
 extern UART_Handle wifi_uart;
 
@@ -28,6 +34,15 @@ int uart_wifi_open();
 void uart_wifi_close();
 void uart_wifi_set_floating();
 
+// only baudrates listed in uartEUSCIABaudrates (nestbox_init.c) are accepted; returns 1 on success
+int uart_debug_set_baudrate(uint32_t baudrate); // applied at the next uart_debug_open()
+int uart_wifi_set_baudrate(uint32_t baudrate);  // re-opens the UART if it is open
+uint32_t uart_wifi_get_baudrate();
+
+// wait up to timeout (ms) for received bytes (EOF byte or watermark) and copy up to n of them to data
+size_t uart_wifi_rx_wait(uint8_t *data, size_t n, unsigned int timeout);
+unsigned int uart_wifi_rx_overruns();
+
 size_t uart_serial_write(UART_Handle *dev, const uint8_t *data, unsigned int n);
 
 size_t uart_serial_read(UART_Handle *dev, uint8_t *data, unsigned int n);
@@ -41,7 +56,7 @@ void uart_stop_debug_prints();
 
 void uart_serial_print_event(char type, const uint8_t* data, unsigned int n);
 
-int ui2a(unsigned long num, unsigned long base, int uc, int leading_zeros,uint8_t* buffer);
+int ui2a(uint32_t num, uint32_t base, int uc, int leading_zeros,uint8_t* buffer);
 int intToStr(unsigned long x, uint8_t* buffer, int d);
 
 
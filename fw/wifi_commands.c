@@ -0,0 +1,508 @@
+/*
+ * wifi_commands.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Commands from the ESP wifi module. Every command is one MIN frame (id WIFI_MIN_ID) with the
+ *  command character as first byte (| WRITE_REQ to set a value); the answer starts with the
+ *  same character. Commands are looked up in wifi_command_table.
+ */
+
+#include "wifi_commands.h"
+
+#include "logger.h"
+#include "log_transfer.h"
+#include "telemetry.h"
+#include "params.h"
+#include "energy.h"
+#include "trace.h"
+#include "stack_monitor.h"
+#include "uart_helper.h"
+#include "rfid_reader.h"
+#include "load_cell.h"
+#include "battery_monitor.h"
+#include "rtc.h"
+#include "../Board.h"
+
+#include <ti/sysbios/hal/Seconds.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#define WIFI_TX_BUF_LEN         64
+#define BAUD_CONFIRM_TIMEOUT    3000 // ms without a frame before falling back to the default baud rate
+
+// fills tx (tx[0] is already set to the command character), returns the answer length
+typedef uint8_t (*wifi_command_fxn)(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx);
+// optional: runs after the answer was sent
+typedef void (*wifi_post_fxn)(const uint8_t *payload, uint8_t len);
+
+struct wifi_command {
+    uint8_t cmd;
+    wifi_command_fxn fxn;
+    wifi_post_fxn post;
+};
+
+static struct min_context *min_ctx;
+static uint8_t tx_buf[WIFI_TX_BUF_LEN];
+
+static int sd_card_detection_status = 0;
+static unsigned int baud_unconfirmed = 0; // >0: a new baud rate was set, but no frame was received with it yet (ms waited)
+static uint32_t pending_baudrate = 0;
+static uint16_t reply_max_ms = 0;  // longest time from a complete command frame to the sent answer
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    uint32_t value = p[0];
+    value = (value<<8) + p[1];
+    value = (value<<8) + p[2];
+    value = (value<<8) + p[3];
+    return value;
+}
+
+// big endian, returns the position after the value
+static uint8_t *put_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+    return p + 4;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = value >> 8;
+    p[1] = value;
+    return p + 2;
+}
+
+static uint8_t cmd_heartbeat(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    tx[1] = 1;
+    return 2;
+}
+
+static uint8_t cmd_time(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    if((ctrl_byte & WRITE_REQ) && len >= 5)
+        rtc_set_clock(get_u32(&payload[1]));
+
+    //send back (new) time value
+    put_u32(&tx[1], Seconds_get());
+    return 5;
+}
+
+static uint8_t cmd_pause_times(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    if((ctrl_byte & WRITE_REQ) && len >= 5)
+        rtc_set_pause_times(payload[1], payload[2], payload[3], payload[4]);
+
+    // send back (new) values
+    tx[1] = rtc_get_p_hour();
+    tx[2] = rtc_get_p_min();
+    tx[3] = rtc_get_r_hour();
+    tx[4] = rtc_get_r_min();
+    return 5;
+}
+
+static uint8_t cmd_battery(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    put_u16(&tx[1], battery_get_vbat());
+    return 3;
+}
+
+static uint8_t cmd_weight(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    put_u32(&tx[1], get_last_stored_weight());
+    return 5;
+}
+
+static uint8_t cmd_offset(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    put_u32(&tx[1], get_weight_offset());
+    return 5;
+}
+
+// write: threshold above the zero offset, applied at the next load cell poll. read: absolute
+// threshold, as the ESP clients expect it (the old value until that poll). The delta itself
+// is parameter PARAM_WEIGHT_THRESHOLD ('P' command).
+static uint8_t cmd_threshold(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    if((ctrl_byte & WRITE_REQ) && len >= 5)
+        set_weight_threshold(get_u32(&payload[1]));
+
+    put_u32(&tx[1], get_weight_threshold());
+    return 5;
+}
+
+static uint8_t cmd_rfid(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    uint64_t tag_id = 0;
+    rfid_get_last_id(&tag_id);
+
+    put_u32(&tx[1], (uint32_t)tag_id);
+    return 5;
+}
+
+// commands that only confirm and then do something:
+static uint8_t cmd_confirm(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    tx[1] = 1;
+    return 2;
+}
+
+static void post_tare(const uint8_t *payload, uint8_t len)
+{
+    load_cell_trigger_tare();
+}
+
+static void post_bypass_on(const uint8_t *payload, uint8_t len)
+{
+    load_cell_bypass_threshold(1);
+}
+
+static void post_bypass_off(const uint8_t *payload, uint8_t len)
+{
+    load_cell_bypass_threshold(0);
+}
+
+static void post_flush(const uint8_t *payload, uint8_t len)
+{
+    // queued log frames point into the FRAM log that is about to be cleared
+    log_transfer_stop();
+    min_transport_reset(min_ctx, 1);
+    sd_card_detection_status = log_restart();
+}
+
+static uint8_t cmd_flush_status(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    tx[1] = sd_card_detection_status;
+    return 2;
+}
+
+static uint8_t cmd_baudrate(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    uint8_t accepted = 1;
+
+    pending_baudrate = uart_wifi_get_baudrate();
+    if((ctrl_byte & WRITE_REQ) && len >= 5)
+    {
+        accepted = nbox_uart_baudrate_supported(get_u32(&payload[1]));
+        if(accepted)
+            pending_baudrate = get_u32(&payload[1]);
+    }
+    // the answer is still sent with the old baud rate
+    tx[1] = accepted;
+    put_u32(&tx[2], pending_baudrate);
+    return 6;
+}
+
+static void post_baudrate(const uint8_t *payload, uint8_t len)
+{
+    if(pending_baudrate != uart_wifi_get_baudrate())
+    {
+        Task_sleep(5); // let the last byte leave the shift register
+        uart_wifi_set_baudrate(pending_baudrate);
+        baud_unconfirmed = 1;
+    }
+}
+
+static uint8_t cmd_log_query(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    put_u16(&tx[1], log_get_write_offset());
+    tx[3] = log_transfer_active();
+    return 4;
+}
+
+// log download: stream log bytes [start, end) as 'g' frames, also used to resume.
+// payload[5] = 1: compressed 'z' frames where possible
+static uint8_t cmd_log_get(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    uint16_t start = 0;
+    if(len >= 5)
+        start = ((uint16_t)payload[1] << 8) + payload[2];
+
+    put_u16(&tx[1], start);
+    return 3;
+}
+
+static void post_log_get(const uint8_t *payload, uint8_t len)
+{
+    uint16_t start = 0;
+    uint16_t end = 0;
+    if(len >= 5)
+    {
+        start = ((uint16_t)payload[1] << 8) + payload[2];
+        end = ((uint16_t)payload[3] << 8) + payload[4];
+    }
+    log_transfer_start(min_ctx, start, end, len >= 6 && payload[5]);
+}
+
+// live load cell samples as 'v' frames, every n'th sample (payload[1], default 1)
+static uint8_t cmd_subscribe(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    uint8_t decimation = 1;
+    if(len >= 2 && payload[1] > 0)
+        decimation = payload[1];
+
+    telemetry_subscribe(decimation);
+    tx[1] = decimation;
+    return 2;
+}
+
+static void post_unsubscribe(const uint8_t *payload, uint8_t len)
+{
+    telemetry_unsubscribe();
+}
+
+// tuning parameter (params.h): payload[1] = id, write: payload[2..5] = new value.
+// answer: id, accepted (0: unknown id or out of range), value, number of parameters
+static uint8_t cmd_param(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    uint8_t id = 0;
+    uint8_t accepted = 0;
+
+    if(len >= 2)
+    {
+        id = payload[1];
+        accepted = id < PARAM_COUNT;
+    }
+    if((ctrl_byte & WRITE_REQ) && len >= 6)
+    {
+        if(id == PARAM_WEIGHT_THRESHOLD) // has to reach the ADC thresholds as well
+            accepted = set_weight_threshold(get_u32(&payload[2]));
+        else
+            accepted = params_set(id, get_u32(&payload[2]));
+    }
+
+    tx[1] = id;
+    tx[2] = accepted;
+    put_u32(&tx[3], params_get(id));
+    tx[7] = PARAM_COUNT;
+    return 8;
+}
+
+// energy accounting (energy.c), write request: restart it after the answer.
+// Layout (big endian): seconds since the reset, ms in each energy_state (4 each),
+// estimated charge in uAh, average current in uA, projected battery life in hours, MCU wake ups per hour
+static uint8_t cmd_energy(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    uint8_t i;
+    uint8_t *p = &tx[1];
+
+    p = put_u32(p, energy_get_elapsed());
+    for(i = 0; i < ENERGY_STATE_COUNT; i++)
+        p = put_u32(p, energy_get_ms(i));
+    p = put_u32(p, energy_get_charge_uah());
+    p = put_u32(p, energy_get_average_ua());
+    p = put_u32(p, energy_get_projected_hours());
+    p = put_u32(p, energy_get_wakeups_per_hour());
+
+    return p - tx;
+}
+
+static void post_energy(const uint8_t *payload, uint8_t len)
+{
+    if(payload[0] & WRITE_REQ)
+        energy_reset();
+}
+
+// sensor capture (trace.c), write: payload[1] = streams to record (0: stop, the log task writes it to the SD card).
+// answer (big endian): streams, trace length(2), capacity(2), overflow(1)
+static uint8_t cmd_trace(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    uint8_t *p = &tx[1];
+
+    if((ctrl_byte & WRITE_REQ) && len >= 2)
+    {
+        if(payload[1])
+            trace_start(payload[1] & (TRACE_RFID | TRACE_LOADCELL));
+        else
+            trace_stop();
+    }
+
+    *p++ = trace_streams();
+    p = put_u16(p, trace_get_length());
+    p = put_u16(p, TRACE_BUF_SIZE);
+    *p++ = trace_overflow();
+
+    return p - tx;
+}
+
+// stack high water marks (stack_monitor.c), bytes, as of the last idle loop scan.
+// answer (big endian): number of tasks, per task: id, size(2), peak(2); system (Hwi) stack size(2), peak(2)
+static uint8_t cmd_stacks(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    unsigned int i;
+    uint16_t size;
+    uint16_t peak;
+    uint8_t *p = &tx[1];
+
+    *p++ = stack_monitor_count();
+    for(i = 0; i < stack_monitor_count(); i++)
+    {
+        *p++ = stack_monitor_get(i, &size, &peak);
+        p = put_u16(p, size);
+        p = put_u16(p, peak);
+    }
+    stack_monitor_get_hwi(&size, &peak);
+    p = put_u16(p, size);
+    p = put_u16(p, peak);
+
+    return p - tx;
+}
+
+// MIN link statistics, write request: clear them after the answer.
+// Layout (big endian): tx frames, rx frames, rx checksum errors, rx EOF errors, retransmits, spurious ACKs,
+// sequence mismatch drops, resets received, dropped frames (4 each), max frames queued (1),
+// max queue bytes (2), ACK round trip histogram (TRANSPORT_RTT_BUCKETS * 2), max reply time in ms (2)
+static uint8_t cmd_link_stats(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    unsigned int i;
+    uint8_t *p = &tx[1];
+
+    p = put_u32(p, min_ctx->tx_frames);
+    p = put_u32(p, min_ctx->rx_frames);
+    p = put_u32(p, min_ctx->rx_checksum_errors);
+    p = put_u32(p, min_ctx->rx_eof_errors);
+    p = put_u32(p, min_ctx->transport_fifo.retransmits);
+    p = put_u32(p, min_ctx->transport_fifo.spurious_acks);
+    p = put_u32(p, min_ctx->transport_fifo.sequence_mismatch_drop);
+    p = put_u32(p, min_ctx->transport_fifo.resets_received);
+    p = put_u32(p, min_ctx->transport_fifo.dropped_frames);
+    *p++ = min_ctx->transport_fifo.n_frames_max;
+    p = put_u16(p, min_ctx->transport_fifo.n_ring_buffer_bytes_max);
+    for(i = 0; i < TRANSPORT_RTT_BUCKETS; i++)
+        p = put_u16(p, min_ctx->transport_fifo.ack_rtt_hist[i]);
+    p = put_u16(p, reply_max_ms);
+
+    return p - tx;
+}
+
+static void post_link_stats(const uint8_t *payload, uint8_t len)
+{
+    if(payload[0] & WRITE_REQ)
+    {
+        min_reset_stats(min_ctx);
+        reply_max_ms = 0;
+    }
+}
+
+// everything the ESP usually polls in one answer. Layout (big endian), STATUS_VERSION 1:
+// version, time(4), vbat(2), last weight(4), offset(4), threshold(4), last tag(4), pause times(4),
+// log write offset(2), log capacity(2), flush status(1), SD busy(1), log transfer active(1),
+// wifi baud rate(4), UART rx overruns(2), T-MIN dropped frames(2)
+static uint8_t cmd_status(uint8_t ctrl_byte, const uint8_t *payload, uint8_t len, uint8_t *tx)
+{
+    uint64_t tag_id = 0;
+    uint8_t *p = &tx[1];
+
+    rfid_get_last_id(&tag_id);
+
+    *p++ = STATUS_VERSION;
+    p = put_u32(p, Seconds_get());
+    p = put_u16(p, battery_get_vbat());
+    p = put_u32(p, get_last_stored_weight());
+    p = put_u32(p, get_weight_offset());
+    p = put_u32(p, get_weight_threshold());
+    p = put_u32(p, (uint32_t)tag_id);
+    *p++ = rtc_get_p_hour();
+    *p++ = rtc_get_p_min();
+    *p++ = rtc_get_r_hour();
+    *p++ = rtc_get_r_min();
+    p = put_u16(p, log_get_write_offset());
+    p = put_u16(p, log_get_capacity());
+    *p++ = sd_card_detection_status;
+    *p++ = log_sd_card_busy();
+    *p++ = log_transfer_active();
+    p = put_u32(p, uart_wifi_get_baudrate());
+    p = put_u16(p, uart_wifi_rx_overruns());
+    p = put_u16(p, (uint16_t)min_ctx->transport_fifo.dropped_frames);
+
+    return p - tx;
+}
+
+static const struct wifi_command wifi_command_table[] = {
+    {'H', cmd_heartbeat,    0},
+    {'Z', cmd_time,         0},
+    {'S', cmd_pause_times,  0},
+    {'B', cmd_battery,      0},
+    {'W', cmd_weight,       0},
+    {'O', cmd_offset,       0},
+    {'D', cmd_threshold,    0},
+    {'R', cmd_rfid,         0},
+    {'t', cmd_confirm,      post_tare},         // trigger load cell tare
+    {'L', cmd_confirm,      post_bypass_on},    // log weights without threshold
+    {'l', cmd_confirm,      post_bypass_off},
+    {'F', cmd_confirm,      post_flush},        // flush the log to the SD card
+    {'f', cmd_flush_status, 0},
+    {'U', cmd_baudrate,     post_baudrate},
+    {'Q', cmd_log_query,    0},
+    {'G', cmd_log_get,      post_log_get},
+    {'A', cmd_status,       0},
+    {'M', cmd_subscribe,    0},
+    {'m', cmd_confirm,      post_unsubscribe},
+    {'N', cmd_link_stats,   post_link_stats},
+    {'P', cmd_param,        0},
+    {'E', cmd_energy,       post_energy},
+    {'C', cmd_trace,        0},
+    {'K', cmd_stacks,       0},
+};
+
+void wifi_commands_init(struct min_context *ctx)
+{
+    min_ctx = ctx;
+}
+
+void wifi_commands_idle(unsigned int ms_waited)
+{
+    if(baud_unconfirmed)
+    {
+        baud_unconfirmed += ms_waited;
+        if(baud_unconfirmed > BAUD_CONFIRM_TIMEOUT) // silence after a baud change
+        {
+            uart_wifi_set_baudrate(UART_DEFAULT_BAUDRATE);
+            baud_unconfirmed = 0;
+        }
+    }
+}
+
+void wifi_commands_reset()
+{
+    log_transfer_stop();
+    telemetry_unsubscribe();
+    uart_wifi_set_baudrate(UART_DEFAULT_BAUDRATE); // the next session starts at the default rate again
+    baud_unconfirmed = 0;
+}
+
+// CALLBACK from min_poll(): one complete command frame was received
+void min_application_handler(uint8_t min_id, uint8_t *min_payload, uint8_t len_payload, uint8_t port)
+{
+    unsigned int i;
+    uint8_t ctrl_byte;
+    uint32_t t_start = Clock_getTicks();
+
+    baud_unconfirmed = 0; // got a frame --> the link works
+
+    if(len_payload == 0)
+        return;
+
+    ctrl_byte = min_payload[0];
+
+    for(i = 0; i < sizeof(wifi_command_table)/sizeof(struct wifi_command); i++)
+    {
+        if(wifi_command_table[i].cmd == (ctrl_byte & 0x7f))
+        {
+            tx_buf[0] = wifi_command_table[i].cmd;
+            min_send_frame(min_ctx, WIFI_MIN_ID, tx_buf, wifi_command_table[i].fxn(ctrl_byte, min_payload, len_payload, tx_buf));
+
+            t_start = Clock_getTicks() - t_start;
+            if(t_start > reply_max_ms)
+                reply_max_ms = t_start;
+
+            if(wifi_command_table[i].post)
+                wifi_command_table[i].post(min_payload, len_payload);
+            break;
+        }
+    }
+}
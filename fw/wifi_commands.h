@@ -0,0 +1,28 @@
+/*
+ * wifi_commands.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef FW_WIFI_COMMANDS_H_
+#define FW_WIFI_COMMANDS_H_
+
+#include <stdint.h>
+#include "min/min.h"
+
+#define WIFI_MIN_ID             0x33U   // all frames to/from the ESP use this MIN identifier
+#define WRITE_REQ               0x80    // set in the command byte to write a new value
+
+#define STATUS_VERSION          1       // layout version of the 'A' status snapshot
+
+// the context used for all replies
+void wifi_commands_init(struct min_context *ctx);
+
+// called when nothing was received for ms_waited milliseconds (falls back to the default baud rate)
+void wifi_commands_idle(unsigned int ms_waited);
+
+// wifi was switched off
+void wifi_commands_reset();
+
+#endif /* FW_WIFI_COMMANDS_H_ */
@@ -0,0 +1,229 @@
+/*
+ * bench_energy.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Energy benchmark: the firmware (on the host platform) runs through a season scenario
+ *  (scenarios/season.txt) once per configuration, and the current model (models.h:
+ *  power_sim_report()) gives the charge per night, split by power state, and the
+ *  runtime on one battery charge. The configurations run in parallel.
+ *
+ *    bench_energy [-v] [-s scenario.txt] [config ...]
+ *      -v   charge per power state
+ *      -s   season scenario (default scenarios/season.txt)
+ *      config  see configs[] below (default: all)
+ *
+ *  Firmware build options are compared with two builds, e.g.
+ *  make clean bench_energy FW_DEFS=-DUSE_KALMAN_ESTIMATOR.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "sim.h"
+#include "models.h"
+#include "scenario.h"
+
+#define MAX_CONFIGS     16
+#define HOURS_PER_NIGHT 24.0    // a night and the day after it
+
+int nestbox_main(void);
+
+// a configuration: statements after the season scenario (params, SD baud rate) and
+// changes of the current model (other hardware)
+struct config {
+    const char *name;
+    const char *what;
+    const char *statements;
+    void (*hardware)(struct power_model *model);
+};
+
+static void no_leds(struct power_model *model)
+{
+    model->ua[POWER_LEDS] = 0;
+}
+
+static void lpm4_pause(struct power_model *model)
+{
+    model->ua[POWER_PAUSE] = 1;
+}
+
+static const struct config configs[] = {
+    { "default",     "as built",                            "",                                 NULL },
+    { "poll_2s",     "load cell poll every 2 s",            "param t_loadcell_poll 2000\n",     NULL },
+    { "rfid_100ms",  "100 ms RFID window",                  "param rfid_timeout 100\n",         NULL },
+    { "bat_5min",    "battery check every 5 minutes",       "param bat_test_interval 300000\n", NULL },
+    { "sd_9600",     "SD logger at 9600 baud",              "sd_baud 9600\n",                   NULL },
+    { "sd_lzss",     "compressed log flush",                "param sd_compress 1\n",           NULL },
+    { "no_leds",     "status LEDs not fitted",              "",                                 no_leds },
+    { "lpm4_pause",  "1 uA while paused (LPM3.5 + RTC)",    "",                                 lpm4_pause },
+};
+
+static const char *const state_names[POWER_STATE_COUNT] = {
+    "base", "pause", "cpu", "5v", "ldo", "adc", "sd", "uart", "wifi", "leds", "vbat",
+};
+
+struct result {
+    struct power_report report;
+    double battery_mah;
+    int halted;
+};
+
+static char *read_file(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char *text;
+    long len;
+
+    if(f == NULL || fseek(f, 0, SEEK_END) != 0 || (len = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0)
+    {
+        perror(path);
+        exit(1);
+    }
+    text = malloc(len + 1);
+    if(text == NULL || fread(text, 1, len, f) != (size_t)len)
+        abort();
+    text[len] = '\0';
+    fclose(f);
+    return text;
+}
+
+static void run_config(const struct config *c, const char *season, int fd)
+{
+    struct power_model model = power_model_default;
+    struct result r;
+    struct scenario s;
+    char *text = malloc(strlen(season) + strlen(c->statements) + 2);
+
+    if(text == NULL)
+        abort();
+    sprintf(text, "%s\n%s", season, c->statements);
+    if(scenario_parse(&s, text) != 0)
+        _exit(2);
+    if(c->hardware != NULL)
+        c->hardware(&model);
+
+    scenario_start(&s);
+    nestbox_main();
+
+    power_sim_report(&model, &r.report);
+    r.battery_mah = model.battery_mah;
+    r.halted = sim_halt_reason() != NULL;
+    if(write(fd, &r, sizeof(r)) != sizeof(r))
+        _exit(2);
+    _exit(0);
+}
+
+// each run needs a fresh process: the firmware state is global
+static pid_t start_config(const struct config *c, const char *season, int *fd)
+{
+    int fds[2];
+    pid_t pid;
+
+    fflush(stdout);
+    if(pipe(fds) != 0 || (pid = fork()) < 0)
+        abort();
+    if(pid == 0)
+    {
+        close(fds[0]);
+        run_config(c, season, fds[1]);
+    }
+    close(fds[1]);
+    *fd = fds[0];
+    return pid;
+}
+
+static int finish_config(const struct config *c, pid_t pid, int fd, int verbose)
+{
+    struct result r;
+    ssize_t n = read(fd, &r, sizeof(r));
+    double nights;
+    double average_ua;
+    unsigned int i;
+
+    close(fd);
+    waitpid(pid, NULL, 0);
+    if(n != sizeof(r) || r.report.elapsed_us == 0)
+    {
+        printf("%-11s failed\n", c->name);
+        return 1;
+    }
+
+    nights = r.report.elapsed_us / (HOURS_PER_NIGHT * 3600 * SIM_US_PER_SEC);
+    average_ua = r.report.total_uah / (r.report.elapsed_us / (3600.0 * SIM_US_PER_SEC));
+    printf("%-11s %9.2f %8.0f %9.0f   %s%s\n", c->name, r.report.total_uah / 1000 / nights, average_ua,
+           r.battery_mah * 1000 / average_ua / 24, c->what, r.halted ? " (halted)" : "");
+    if(verbose)
+    {
+        printf("%11s", "mAh/night");
+        for(i = 0; i < POWER_STATE_COUNT; i++)
+            printf(" %s %.2f", state_names[i], r.report.uah[i] / 1000 / nights);
+        printf("\n%11s", "h/night");
+        for(i = 0; i < POWER_STATE_COUNT; i++)
+            printf(" %s %.2f", state_names[i], r.report.us[i] / (3600.0 * SIM_US_PER_SEC) / nights);
+        printf("\n");
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "scenarios/season.txt";
+    unsigned int n_configs = sizeof(configs) / sizeof(configs[0]);
+    const struct config *run[MAX_CONFIGS];
+    pid_t pids[MAX_CONFIGS];
+    int fds[MAX_CONFIGS];
+    unsigned int n_run = 0;
+    unsigned int i;
+    int verbose = 0;
+    int failed = 0;
+    char *season;
+    struct scenario s;
+    int opt;
+
+    while((opt = getopt(argc, argv, "vs:")) != -1)
+    {
+        switch(opt)
+        {
+        case 'v':
+            verbose = 1;
+            break;
+        case 's':
+            path = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-v] [-s scenario.txt] [config ...]\n", argv[0]);
+            return 2;
+        }
+    }
+    for(i = 0; i < n_configs; i++)
+    {
+        int selected = optind == argc;
+        int k;
+        for(k = optind; k < argc; k++)
+            if(strcmp(argv[k], configs[i].name) == 0)
+                selected = 1;
+        if(selected && n_run < MAX_CONFIGS)
+            run[n_run++] = &configs[i];
+    }
+
+    season = read_file(path);
+    if(scenario_parse(&s, season) != 0)
+        return 1;
+    printf("%s: %.0f nights, %zu visits, %.0f mAh battery\n", path,
+           s.duration_us / (HOURS_PER_NIGHT * 3600 * SIM_US_PER_SEC), s.n_visits, power_model_default.battery_mah);
+    scenario_free(&s);
+
+    for(i = 0; i < n_run; i++)
+        pids[i] = start_config(run[i], season, &fds[i]);
+    printf("%-11s %9s %8s %9s\n", "config", "mAh/night", "avg uA", "runtime d");
+    for(i = 0; i < n_run; i++)
+        failed |= finish_config(run[i], pids[i], fds[i], verbose);
+
+    free(season);
+    return failed;
+}
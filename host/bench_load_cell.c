@@ -0,0 +1,367 @@
+/*
+ * bench_load_cell.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Load cell benchmark: the firmware (load_cell.c unchanged, on the host platform) weighs
+ *  the birds of generated scenarios (platform/scenario.h) with the ADS1220 model, and
+ *  every visit is judged on accuracy and energy together:
+ *
+ *    time to stable   arrival to the stable series (S entry) of the first W (weight) entry
+ *    weight error     W entry against the birds on the perch at the end of that series
+ *    ADC on           time the ADS1220 spent converting during the visit
+ *
+ *    bench_load_cell [-v] [case ...]
+ *      -v   one line per visit
+ *      case sitting, landing, preening, hopping, two_birds, wind, temperature (default: all)
+ *
+ *  Run it before and after a change in the load cell path, e.g. with
+ *  make bench FW_DEFS=-DUSE_KALMAN_ESTIMATOR for the Kalman estimator.
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "sim.h"
+#include "models.h"
+#include "scenario.h"
+
+#define COUNTS_PER_GRAM     1098.9  // params.c
+#define VISITS              24
+#define VISIT_PERIOD_S      600     // 10 minutes from one visit to the next
+#define FIRST_VISIT_S       900
+#define SETTLE_US           (30 * SIM_US_PER_SEC) // entries after the departure still count
+#define MAX_ENTRIES         4096
+#define SCENARIO_SIZE       8192
+
+int nestbox_main(void);
+int __real_log_write_new_weight_entry(uint8_t logchar, uint32_t weight, uint16_t stdev);
+
+// a weight entry of the firmware; W entries get the time and the truth of the S entry
+// (the series) they come from
+struct entry {
+    uint64_t time_us;
+    char type;
+    int32_t value;
+    double grams;
+};
+
+// birds on the perch at overlapping times count as one visit
+struct visit {
+    uint64_t from_us;
+    uint64_t to_us;                 // last departure + SETTLE_US, or the next arrival
+    uint64_t adc_from_us;           // ads1220_sim_converting_us() at from_us and to_us
+    uint64_t adc_to_us;
+};
+
+struct bench_case {
+    const char *name;
+    const char *what;
+    void (*generate)(char *text);
+};
+
+static struct entry entries[MAX_ENTRIES];
+static unsigned int n_entries = 0;
+static struct visit visits[VISITS * 2];
+static unsigned int n_visits = 0;
+static int verbose = 0;
+
+/* ======== scenario generators ======== */
+
+static size_t append(char *text, const char *fmt, ...)
+{
+    size_t len = strlen(text);
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(text + len, SCENARIO_SIZE - len, fmt, ap);
+    va_end(ap);
+    return strlen(text);
+}
+
+// night shift from 18:00 UTC, the birds come every 10 minutes from 18:15
+static void night(char *text)
+{
+    text[0] = '\0';
+    append(text, "start 2026-10-18 18:00:00\n");
+    append(text, "duration %us\n", FIRST_VISIT_S + VISITS * VISIT_PERIOD_S);
+}
+
+// owls from 150 to 650 g
+static double owl_grams(unsigned int i)
+{
+    return 150 + (i * 137) % 500 + (i % 3) * 0.3;
+}
+
+static void visits_of(char *text, unsigned int stay_s, const char *behaviour)
+{
+    unsigned int i;
+
+    for(i = 0; i < VISITS; i++)
+        append(text, "visit %u %u 59004529B6 %.1f %s\n",
+               FIRST_VISIT_S + i * VISIT_PERIOD_S, stay_s, owl_grams(i), behaviour);
+}
+
+static void gen_sitting(char *text)
+{
+    night(text);
+    visits_of(text, 120, "sitting");
+}
+
+// short stays: landed and gone again before the series is complete
+static void gen_landing(char *text)
+{
+    unsigned int i;
+
+    night(text);
+    for(i = 0; i < VISITS; i++)
+        append(text, "visit %u %u 59004529B6 %.1f\n",
+               FIRST_VISIT_S + i * VISIT_PERIOD_S, 8 + (i % 6) * 3, owl_grams(i));
+}
+
+static void gen_preening(char *text)
+{
+    night(text);
+    visits_of(text, 120, "preening");
+}
+
+static void gen_hopping(char *text)
+{
+    night(text);
+    visits_of(text, 120, "hopping");
+}
+
+// the second owl lands 5 to 40 s after the first one and leaves first
+static void gen_two_birds(char *text)
+{
+    unsigned int i;
+
+    night(text);
+    for(i = 0; i < VISITS; i++)
+    {
+        unsigned int at = FIRST_VISIT_S + i * VISIT_PERIOD_S;
+        unsigned int later = 5 + (i % 8) * 5;
+        append(text, "visit %u 150 59004529B6 %.1f\n", at, owl_grams(i));
+        append(text, "visit %u %u 580053A0AF %.1f\n", at + later, 60 + (i % 4) * 20, owl_grams(i + 7));
+    }
+}
+
+// a gale building up over the night: 0 to 20 g on the perch
+static void gen_wind(char *text)
+{
+    night(text);
+    append(text, "wind 0 0\n");
+    append(text, "wind %us 20\n", FIRST_VISIT_S + VISITS * VISIT_PERIOD_S);
+    visits_of(text, 120, "sitting");
+}
+
+// the perch cools down by 15 degC over the night, the zero offset drifts with it
+static void gen_temperature(char *text)
+{
+    night(text);
+    append(text, "offset_drift -150\n");
+    append(text, "temperature 0 15\n");
+    append(text, "temperature %us 0\n", FIRST_VISIT_S + VISITS * VISIT_PERIOD_S);
+    visits_of(text, 120, "sitting");
+}
+
+static const struct bench_case cases[] = {
+    { "sitting",     "owls keep still for 2 minutes",        gen_sitting },
+    { "landing",     "8 to 23 s stays",                      gen_landing },
+    { "preening",    "weight shifts every 3 s",              gen_preening },
+    { "hopping",     "off the perch for 0.4 s every 10 s",   gen_hopping },
+    { "two_birds",   "a second owl joins",                   gen_two_birds },
+    { "wind",        "0 to 20 g of wind",                    gen_wind },
+    { "temperature", "15 to 0 degC, -150 counts/degC",       gen_temperature },
+};
+
+/* ======== one run ======== */
+
+// every weight entry of the firmware, with the time and the truth
+int __wrap_log_write_new_weight_entry(uint8_t logchar, uint32_t weight, uint16_t stdev)
+{
+    static uint64_t series_us = 0;
+    static double series_grams = 0;
+
+    if(logchar == 'S')
+    {
+        series_us = sim_time_us();
+        series_grams = scenario_birds_grams(series_us);
+    }
+    if(n_entries < MAX_ENTRIES)
+    {
+        struct entry *e = &entries[n_entries++];
+        e->time_us = logchar == 'W' ? series_us : sim_time_us();
+        e->type = logchar;
+        e->value = (int32_t)weight;
+        e->grams = logchar == 'W' ? series_grams : scenario_birds_grams(e->time_us);
+    }
+    return __real_log_write_new_weight_entry(logchar, weight, stdev);
+}
+
+static void visit_begin(void *arg)
+{
+    ((struct visit *)arg)->adc_from_us = ads1220_sim_converting_us();
+}
+
+static void visit_end(void *arg)
+{
+    ((struct visit *)arg)->adc_to_us = ads1220_sim_converting_us();
+}
+
+// group the overlapping visits of the scenario, and sample the ADC on time around them
+static void visits_plan(const struct scenario *s)
+{
+    size_t i;
+
+    for(i = 0; i < s->n_visits && n_visits < sizeof(visits) / sizeof(visits[0]); i++)
+    {
+        const struct scenario_visit *sv = &s->visits[i];
+        struct visit *v = &visits[n_visits];
+        uint64_t end = sv->at_us + sv->duration_us + SETTLE_US;
+
+        if(n_visits > 0 && sv->at_us < visits[n_visits-1].to_us - SETTLE_US)
+        {
+            v = &visits[n_visits-1];
+            if(end > v->to_us)
+                v->to_us = end;
+            continue;
+        }
+        if(n_visits > 0 && visits[n_visits-1].to_us > sv->at_us)
+            visits[n_visits-1].to_us = sv->at_us;
+        v->from_us = sv->at_us;
+        v->to_us = end;
+        n_visits++;
+    }
+    for(i = 0; i < n_visits; i++)
+    {
+        sim_at(visits[i].from_us, visit_begin, &visits[i]);
+        sim_at(visits[i].to_us, visit_end, &visits[i]);
+    }
+}
+
+static const struct entry *first_entry(char type, uint64_t from_us, uint64_t to_us)
+{
+    unsigned int i;
+
+    for(i = 0; i < n_entries; i++)
+        if(entries[i].type == type && entries[i].time_us >= from_us && entries[i].time_us < to_us)
+            return &entries[i];
+    return NULL;
+}
+
+static void report(const struct bench_case *c)
+{
+    unsigned int measured = 0;
+    unsigned int i;
+    double stable_sum = 0, stable_max = 0;
+    double error_sum = 0, error_max = 0;
+    double adc_sum = 0;
+
+    for(i = 0; i < n_visits; i++)
+    {
+        const struct visit *v = &visits[i];
+        const struct entry *w = first_entry('W', v->from_us, v->to_us);
+        double adc = (v->adc_to_us - v->adc_from_us) / (double)SIM_US_PER_SEC;
+
+        adc_sum += adc;
+        if(w != NULL)
+        {
+            double stable = (w->time_us - v->from_us) / (double)SIM_US_PER_SEC;
+            double error = w->value / COUNTS_PER_GRAM - w->grams;
+            measured++;
+            stable_sum += stable;
+            error_sum += fabs(error);
+            if(stable > stable_max)
+                stable_max = stable;
+            if(fabs(error) > error_max)
+                error_max = fabs(error);
+            if(verbose)
+                printf("  %-11s %7.0f s  %6.1f g  stable %5.1f s  error %+6.2f g  ADC on %5.2f s\n", c->name,
+                       v->from_us / (double)SIM_US_PER_SEC, w->grams, stable, error, adc);
+        }
+        else if(verbose)
+            printf("  %-11s %7.0f s  no weight                                   ADC on %5.2f s\n", c->name,
+                   v->from_us / (double)SIM_US_PER_SEC, adc);
+    }
+
+    printf("%-11s %6u %8u", c->name, n_visits, measured);
+    if(measured > 0)
+        printf("  %6.1f %6.1f  %6.2f %6.2f", stable_sum / measured, stable_max, error_sum / measured, error_max);
+    else
+        printf("  %6s %6s  %6s %6s", "-", "-", "-", "-");
+    printf("  %7.2f   %s\n", n_visits > 0 ? adc_sum / n_visits : 0.0, c->what);
+}
+
+static void run_case(const struct bench_case *c)
+{
+    static char text[SCENARIO_SIZE];
+    struct scenario s;
+
+    c->generate(text);
+    if(scenario_parse(&s, text) != 0)
+        _exit(2);
+    scenario_start(&s);
+    visits_plan(&s);
+
+    nestbox_main();
+
+    report(c);
+    fflush(stdout);
+    _exit(0);
+}
+
+// each run needs a fresh process: the firmware state is global
+static int run_forked(const struct bench_case *c)
+{
+    pid_t pid;
+    int status;
+
+    fflush(stdout);
+    pid = fork();
+    if(pid < 0)
+        abort();
+    if(pid == 0)
+        run_case(c);
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int n_cases = sizeof(cases) / sizeof(cases[0]);
+    unsigned int i;
+    int failed = 0;
+    int opt;
+
+    while((opt = getopt(argc, argv, "v")) != -1)
+    {
+        if(opt != 'v')
+        {
+            fprintf(stderr, "usage: %s [-v] [case ...]\n", argv[0]);
+            return 2;
+        }
+        verbose = 1;
+    }
+
+    printf("%-11s %6s %8s  %13s  %13s  %7s\n", "", "", "", "stable [s]", "|error| [g]", "ADC on");
+    printf("%-11s %6s %8s  %6s %6s  %6s %6s  %7s\n", "case", "visits", "measured",
+           "mean", "max", "mean", "max", "[s]");
+    for(i = 0; i < n_cases; i++)
+    {
+        int selected = optind == argc;
+        int k;
+        for(k = optind; k < argc; k++)
+            if(strcmp(argv[k], cases[i].name) == 0)
+                selected = 1;
+        if(selected)
+            failed |= run_forked(&cases[i]);
+    }
+    return failed;
+}
@@ -0,0 +1,109 @@
+/*
+ * bench_min.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Log download benchmark ('G' command, fw/log_transfer.c over T-MIN) against the host
+ *  MIN peer (min_peer.h): a log of 672 weight entries is downloaded at the wifi baud rates,
+ *  on a clean link and with lost and damaged frames, raw and compressed ('z' frames).
+ *
+ *    frames/s    frames the nestbox sent (ACKs, answers and retransmits included)
+ *    log B/s     log bytes that arrived at the ESP per second
+ *    wire B/s    bytes the nestbox sent per second (stuff bytes included)
+ *    retx        frames sent again by the T-MIN transport
+ *    overrun     bytes lost in the RX ring of the nestbox (ACKs that came while it was
+ *                blocked in UART writes)
+ *    FAILED      the download did not complete or the bytes differ
+ *
+ *  "before" is the transfer as it was before the retransmit timeout included the wire
+ *  time: a fixed retransmit timeout and 16 min_poll() per log_transfer_poll().
+ *
+ *    bench_min [-r]   -r: only the current transfer
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "min_peer.h"
+
+#define LOG_BYTES       8064    // 672 long entries
+
+struct link_case {
+    uint32_t baudrate;
+    unsigned int loss;          // permille lost, the same damaged
+};
+
+static const struct link_case cases[] = {
+    { 9600, 0 }, { 9600, 20 }, { 57600, 0 }, { 115200, 0 }, { 115200, 20 }, { 115200, 50 },
+};
+
+static uint8_t log_bytes[LOG_BYTES];
+static uint8_t received[MIN_PEER_MAX_LOG];
+static uint32_t lcg = 7;
+
+static uint32_t random_below(uint32_t n)
+{
+    lcg = lcg * 1103515245U + 12345U;
+    return ((lcg >> 8) & 0xffffffU) % n;
+}
+
+// long 'W' entries of logger.c: time, 'W', 16 bit, 32 bit weight
+static void make_log()
+{
+    uint32_t t = 1792346400U;
+    unsigned int i;
+
+    for(i = 0; i + 12 <= LOG_BYTES; i += 12)
+    {
+        uint32_t weight = 170000U + random_below(20000);
+        t += 20 + random_below(600);
+        memcpy(&log_bytes[i], &t, 4);
+        log_bytes[i + 4] = 'W';
+        log_bytes[i + 5] = 0;
+        log_bytes[i + 6] = random_below(256);
+        log_bytes[i + 7] = 0;
+        memcpy(&log_bytes[i + 8], &weight, 4);
+    }
+}
+
+static void run(const struct link_case *c, int compressed, int legacy)
+{
+    struct min_peer_link link = { c->baudrate, c->loss, c->loss, 1, legacy };
+    uint32_t t0, frames0, bytes0, ms;
+    int n;
+
+    min_peer_init(&link, log_bytes, LOG_BYTES);
+    t0 = min_peer_now();
+    frames0 = min_peer_nestbox_frames();
+    bytes0 = min_peer_nestbox_bytes();
+
+    memset(received, 0, sizeof(received));
+    n = min_peer_download(0, 0, compressed, received);
+    ms = min_peer_now() - t0;
+    if(ms == 0)
+        ms = 1;
+
+    printf("%6lu %4.1f%%  %-4s %-6s %8.2f s %7.1f %8.0f %8.0f %6lu %7lu%s\n",
+           (unsigned long)c->baudrate, c->loss / 10.0, compressed ? "z" : "raw", legacy ? "before" : "after",
+           ms / 1000.0, (min_peer_nestbox_frames() - frames0) * 1000.0 / ms,
+           n > 0 ? n * 1000.0 / ms : 0.0, (min_peer_nestbox_bytes() - bytes0) * 1000.0 / ms,
+           (unsigned long)min_peer_nestbox()->transport_fifo.retransmits, (unsigned long)min_peer_nestbox_overruns(),
+           n == LOG_BYTES && memcmp(received, log_bytes, LOG_BYTES) == 0 ? "" : "  FAILED");
+}
+
+int main(int argc, char **argv)
+{
+    int current_only = argc > 1 && strcmp(argv[1], "-r") == 0;
+    unsigned int i;
+    int compressed, legacy;
+
+    make_log();
+    printf("%u log bytes\n", LOG_BYTES);
+    printf("  baud  lost  log  xfer       time frames/s  log B/s wire B/s   retx overrun\n");
+    for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        for(compressed = 0; compressed <= 1; compressed++)
+            for(legacy = current_only ? 0 : 1; legacy >= 0; legacy--)
+                run(&cases[i], compressed, legacy);
+    return 0;
+}
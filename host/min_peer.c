@@ -0,0 +1,543 @@
+/*
+ * min_peer.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Host MIN peer (min_peer.h). fw/min/min.c is included here, as in test_min_crc.c, and
+ *  serves both contexts: the nestbox (port 0) and the ESP (port 1). The frames a side
+ *  writes during a step are split at their header bytes (stuffing keeps 3 header bytes
+ *  out of a frame body), dropped or damaged, and written to its end of the socketpair;
+ *  the other side reads the bytes once their wire time has passed.
+ *
+ *  min_application_handler() of the nestbox is the one of wifi_commands.c: the binaries
+ *  are linked with --wrap=min_application_handler, and the ESP side gets its frames here.
+ *  The firmware modules behind the commands are stubs, the log is a plain array.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "min_peer.h"
+#include "../fw/min/min.c"
+
+#include "wifi_commands.h"
+#include "log_transfer.h"
+#include "lzss.h"
+#include "logger.h"
+#include "params.h"
+#include "energy.h"
+#include "trace.h"
+#include "telemetry.h"
+#include "stack_monitor.h"
+#include "rfid_reader.h"
+#include "load_cell.h"
+#include "battery_monitor.h"
+#include "rtc.h"
+#include "uart_helper.h"
+
+#include <ti/sysbios/hal/Seconds.h>
+
+#define NESTBOX                 0
+#define ESP                     1
+
+#define TX_BUF_SIZE             16384   // what one side writes during one step
+#define IN_FLIGHT               256     // frames on the way to a side
+#define NESTBOX_RX_BYTES        32      // uart_wifi_rx_wait() in user_button_Task()
+#define NESTBOX_RX_RING         (UART_RX_RING_SIZE - 1) // bytes its RX ring holds (uart_helper.c)
+#define T_WIFI_RX               1000    // ms, its read timeouts (user_button.c)
+#define T_MIN_POLL              10
+#define ANSWER_TIMEOUT_MS       100     // the ESP waits this plus the wire time for an answer
+#define COMMAND_RETRIES         5
+#define DOWNLOAD_STALL_MS       30000   // no data frame for this long: the download failed
+#define LEGACY_POLLS            16      // min_poll() per log_transfer_poll() before user-031
+
+struct in_flight {
+    uint32_t n;
+    uint64_t arrival_us;
+};
+
+struct side {
+    struct min_context ctx;
+    int fd;                             // this side's end of the socketpair
+    uint8_t tx[TX_BUF_SIZE];
+    size_t tx_len;
+    struct in_flight frames[IN_FLIGHT]; // towards this side
+    unsigned int head, tail;
+    uint8_t rx[TX_BUF_SIZE];            // arrived and not read yet (the UART RX ring)
+    uint32_t rx_len;
+    uint32_t rx_size;
+    uint32_t overruns;                  // bytes lost because the RX ring was full
+    uint64_t line_free_us;              // the line from this side
+};
+
+UART_Handle wifi_uart;
+
+static struct side sides[2];
+static struct min_peer_link peer_link;
+static uint32_t now_ms;
+static uint32_t lcg;
+static int tx_side;                     // the side that runs min_poll() now
+
+static uint64_t nestbox_busy_us;        // blocked in a UART write
+static uint32_t nestbox_wait_until;     // end of the read timeout
+static uint32_t nestbox_rx_timeout;
+static uint32_t nestbox_frames;
+static uint32_t nestbox_bytes;
+
+static uint8_t fram_log[MIN_PEER_MAX_LOG];
+static uint16_t fram_log_len;
+
+// what the ESP side received
+static uint8_t answer_buf[MAX_PAYLOAD];
+static int answer_len;
+static uint8_t *download_buf;
+static uint32_t download_next;
+static uint32_t download_last_ms;
+static int download_done;
+static int download_order_error;
+
+static struct min_peer_stats stats;
+static uint32_t latency[MIN_PEER_MAX_COMMANDS];
+
+static uint32_t random_below(uint32_t n)
+{
+    lcg = lcg * 1103515245U + 12345U;
+    return ((lcg >> 8) & 0xffffffU) % n;
+}
+
+static uint64_t wire_us(uint32_t n_bytes)
+{
+    return (uint64_t)n_bytes * 10U * 1000000U / peer_link.baudrate;
+}
+
+/* ======== the wire ======== */
+
+int uart_serial_putc(UART_Handle *dev, uint8_t c)
+{
+    struct side *s = &sides[tx_side];
+
+    (void)dev;
+    if(s->tx_len < TX_BUF_SIZE)
+        s->tx[s->tx_len++] = c;
+    return 1;
+}
+
+static int frame_start(const uint8_t *p, size_t i, size_t n)
+{
+    return i + 2 < n && p[i] == HEADER_BYTE && p[i + 1] == HEADER_BYTE && p[i + 2] == HEADER_BYTE;
+}
+
+// the frames written during this step go on the line, one after the other
+static void send_frames(int from)
+{
+    struct side *s = &sides[from];
+    struct side *to = &sides[!from];
+    size_t i = 0;
+
+    if(s->line_free_us < (uint64_t)now_ms * 1000U)
+        s->line_free_us = (uint64_t)now_ms * 1000U;
+
+    while(i < s->tx_len)
+    {
+        size_t end = i + 1;
+        while(end < s->tx_len && !frame_start(s->tx, end, s->tx_len))
+            end++;
+
+        s->line_free_us += wire_us(end - i);
+        if(from == NESTBOX)
+        {
+            nestbox_frames++;
+            nestbox_bytes += end - i;
+        }
+
+        if(random_below(1000) >= peer_link.drop_permille)
+        {
+            struct in_flight *f = &to->frames[to->tail % IN_FLIGHT];
+
+            if(random_below(1000) < peer_link.corrupt_permille)
+                s->tx[i + random_below(end - i)] ^= 1U + random_below(255);
+            if(to->tail - to->head >= IN_FLIGHT || write(s->fd, &s->tx[i], end - i) != (ssize_t)(end - i))
+                abort();
+            f->n = end - i;
+            f->arrival_us = s->line_free_us;
+            to->tail++;
+        }
+        i = end;
+    }
+    s->tx_len = 0;
+}
+
+// frames whose wire time has passed go into the RX ring (bytes that do not fit are lost),
+// then up to max bytes are read from it
+static uint32_t receive(int side, uint8_t *buf, uint32_t max)
+{
+    struct side *s = &sides[side];
+    uint8_t frame[TX_BUF_SIZE];
+    uint32_t n;
+
+    while(s->head != s->tail && s->frames[s->head % IN_FLIGHT].arrival_us <= (uint64_t)now_ms * 1000U)
+    {
+        n = s->frames[s->head++ % IN_FLIGHT].n;
+        if(read(s->fd, frame, n) != (ssize_t)n)
+            abort();
+        if(n > s->rx_size - s->rx_len)
+        {
+            s->overruns += n - (s->rx_size - s->rx_len);
+            n = s->rx_size - s->rx_len;
+        }
+        memcpy(&s->rx[s->rx_len], frame, n);
+        s->rx_len += n;
+    }
+
+    n = s->rx_len < max ? s->rx_len : max;
+    memcpy(buf, s->rx, n);
+    memmove(s->rx, &s->rx[n], s->rx_len - n);
+    s->rx_len -= n;
+    return n;
+}
+
+/* ======== the two sides ======== */
+
+// one turn of the wifi loop of user_button_Task()
+static void nestbox_step()
+{
+    uint8_t rx_bytes[NESTBOX_RX_BYTES];
+    uint32_t n;
+    int i;
+
+    receive(NESTBOX, rx_bytes, 0); // the UART ISR fills the RX ring while the task is blocked
+    if(nestbox_busy_us > (uint64_t)now_ms * 1000U)
+        return;
+    if(sides[NESTBOX].rx_len == 0 && now_ms < nestbox_wait_until)
+        return;
+
+    tx_side = NESTBOX;
+    n = receive(NESTBOX, rx_bytes, sizeof(rx_bytes));
+    if(n == 0)
+        wifi_commands_idle(nestbox_rx_timeout);
+
+    min_poll(&sides[NESTBOX].ctx, rx_bytes, n);
+    log_transfer_poll(&sides[NESTBOX].ctx);
+    if(peer_link.legacy_transfer && sides[NESTBOX].ctx.transport_fifo.n_frames > 0)
+        for(i = 1; i < LEGACY_POLLS; i++)
+            min_poll(&sides[NESTBOX].ctx, 0, 0);
+
+    send_frames(NESTBOX);
+    nestbox_busy_us = sides[NESTBOX].line_free_us; // blocking UART writes
+    nestbox_rx_timeout = log_transfer_active() ? T_MIN_POLL : T_WIFI_RX;
+    nestbox_wait_until = (uint32_t)((nestbox_busy_us + 999U) / 1000U) + nestbox_rx_timeout;
+}
+
+static void esp_step()
+{
+    uint8_t rx_bytes[TX_BUF_SIZE];
+    uint32_t n;
+
+    tx_side = ESP;
+    n = receive(ESP, rx_bytes, sizeof(rx_bytes));
+    min_poll(&sides[ESP].ctx, rx_bytes, n);
+    send_frames(ESP);
+}
+
+void min_peer_run(uint32_t ms)
+{
+    while(ms-- > 0)
+    {
+        nestbox_step();
+        esp_step();
+        now_ms++;
+    }
+}
+
+void __real_min_application_handler(uint8_t min_id, uint8_t *min_payload, uint8_t len_payload, uint8_t port);
+
+void __wrap_min_application_handler(uint8_t min_id, uint8_t *min_payload, uint8_t len_payload, uint8_t port)
+{
+    uint16_t offset;
+
+    if(port == NESTBOX)
+    {
+        __real_min_application_handler(min_id, min_payload, len_payload, port);
+        return;
+    }
+
+    if(len_payload >= 3 && (min_payload[0] == 'g' || min_payload[0] == 'z') && download_buf != NULL)
+    {
+        // a 'G' sent again restarts the stream: the data frames go where their offset says,
+        // only a gap is an error
+        offset = ((uint16_t)min_payload[1] << 8) + min_payload[2];
+        download_last_ms = now_ms;
+        if(offset > download_next)
+        {
+            download_order_error = 1;
+            return;
+        }
+        if(min_payload[0] == 'g' && len_payload == 3)
+            download_done = offset == download_next;
+        else if(min_payload[0] == 'g')
+        {
+            memcpy(&download_buf[offset], &min_payload[3], len_payload - 3);
+            download_next = offset + len_payload - 3;
+        }
+        else if(len_payload > 4 && lzss_decompress(&min_payload[4], len_payload - 4, &download_buf[offset],
+                                                   min_payload[3]) == min_payload[3])
+            download_next = offset + min_payload[3];
+        else
+            download_order_error = 1;
+        return;
+    }
+
+    memcpy(answer_buf, min_payload, len_payload);
+    answer_len = len_payload;
+}
+
+/* ======== API ======== */
+
+void min_peer_init(const struct min_peer_link *l, const uint8_t *log, uint16_t n)
+{
+    int fds[2];
+    int i;
+
+    for(i = 0; i < 2; i++)
+        if(sides[i].fd > 0)
+            close(sides[i].fd);
+    memset(sides, 0, sizeof(sides));
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        abort();
+
+    peer_link = *l;
+    lcg = peer_link.seed;
+    now_ms = 0;
+    nestbox_busy_us = 0;
+    nestbox_wait_until = 0;
+    nestbox_rx_timeout = T_WIFI_RX;
+    nestbox_frames = 0;
+    nestbox_bytes = 0;
+    memset(&stats, 0, sizeof(stats));
+
+    fram_log_len = n < MIN_PEER_MAX_LOG ? n : MIN_PEER_MAX_LOG;
+    memcpy(fram_log, log, fram_log_len);
+
+    for(i = 0; i < 2; i++)
+    {
+        sides[i].fd = fds[i];
+        sides[i].rx_size = i == NESTBOX ? NESTBOX_RX_RING : TX_BUF_SIZE;
+        min_init_context(&sides[i].ctx, i);
+    }
+    log_transfer_stop();
+    wifi_commands_init(&sides[NESTBOX].ctx);
+}
+
+uint32_t min_peer_now()
+{
+    return now_ms;
+}
+
+int min_peer_command(const uint8_t *cmd, uint8_t len, uint8_t *answer)
+{
+    uint32_t t0 = now_ms;
+    uint32_t timeout = ANSWER_TIMEOUT_MS + (uint32_t)(wire_us(ON_WIRE_SIZE(len) + ON_WIRE_SIZE(64)) / 1000U);
+    int tries;
+
+    for(tries = 0; tries <= COMMAND_RETRIES; tries++)
+    {
+        uint32_t t_send = now_ms;
+
+        if(tries > 0)
+            stats.resent++;
+        answer_len = -1;
+        tx_side = ESP;
+        min_send_frame(&sides[ESP].ctx, WIFI_MIN_ID, (uint8_t *)cmd, len);
+        send_frames(ESP);
+
+        while(now_ms - t_send < timeout)
+        {
+            min_peer_run(1);
+            if(answer_len > 0 && answer_buf[0] != (cmd[0] & 0x7f))
+            {
+                stats.wrong++; // late answer to the command before
+                answer_len = -1;
+            }
+            if(answer_len > 0)
+            {
+                if(stats.commands < MIN_PEER_MAX_COMMANDS)
+                    latency[stats.commands] = now_ms - t0;
+                stats.commands++;
+                memcpy(answer, answer_buf, answer_len);
+                return answer_len;
+            }
+        }
+    }
+    stats.lost++;
+    return -1;
+}
+
+int min_peer_download(uint16_t start, uint16_t end, int compressed, uint8_t *buf)
+{
+    uint8_t cmd[6] = { 'G', start >> 8, start, end >> 8, end, compressed };
+    uint8_t answer[MAX_PAYLOAD];
+
+    download_buf = buf;
+    download_next = start;
+    download_done = 0;
+    download_order_error = 0;
+
+    if(min_peer_command(cmd, sizeof(cmd), answer) < 0)
+        return -1;
+
+    download_last_ms = now_ms;
+    while(!download_done && !download_order_error && now_ms - download_last_ms < DOWNLOAD_STALL_MS)
+        min_peer_run(1);
+
+    download_buf = NULL;
+    if(!download_done || download_order_error)
+        return -1;
+    return download_next - start;
+}
+
+void min_peer_get_stats(struct min_peer_stats *s)
+{
+    *s = stats;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+uint32_t min_peer_latency_percentile(unsigned int percent)
+{
+    static uint32_t sorted[MIN_PEER_MAX_COMMANDS];
+    uint32_t n = stats.commands < MIN_PEER_MAX_COMMANDS ? stats.commands : MIN_PEER_MAX_COMMANDS;
+
+    if(n == 0)
+        return 0;
+    memcpy(sorted, latency, n * sizeof(uint32_t));
+    qsort(sorted, n, sizeof(uint32_t), compare_u32);
+    return sorted[(n - 1) * percent / 100];
+}
+
+struct min_context *min_peer_nestbox()
+{
+    return &sides[NESTBOX].ctx;
+}
+
+struct min_context *min_peer_esp()
+{
+    return &sides[ESP].ctx;
+}
+
+uint32_t min_peer_nestbox_frames()
+{
+    return nestbox_frames;
+}
+
+uint32_t min_peer_nestbox_bytes()
+{
+    return nestbox_bytes;
+}
+
+uint32_t min_peer_nestbox_overruns()
+{
+    return sides[NESTBOX].overruns;
+}
+
+/* ======== the rest of the firmware ======== */
+
+UInt32 Clock_getTicks()
+{
+    return now_ms;
+}
+
+UInt32 Seconds_get()
+{
+    return 1792346400U + now_ms / 1000U;
+}
+
+Void Task_sleep(UInt32 ticks)
+{
+    (void)ticks;
+}
+
+// the legacy transfer had a fixed retransmit timeout: no wire time (1 ms with this rate)
+uint32_t uart_wifi_get_baudrate()
+{
+    return peer_link.legacy_transfer ? 1000000000U : peer_link.baudrate;
+}
+
+int uart_wifi_set_baudrate(uint32_t baudrate)
+{
+    (void)baudrate;
+    return 1;
+}
+
+unsigned int uart_wifi_rx_overruns()
+{
+    return sides[NESTBOX].overruns;
+}
+
+int nbox_uart_baudrate_supported(unsigned long baudrate)
+{
+    return baudrate == 9600 || baudrate == 115200;
+}
+
+uint16_t log_get_write_offset()
+{
+    return fram_log_len;
+}
+
+uint16_t log_get_capacity()
+{
+    return MIN_PEER_MAX_LOG;
+}
+
+const uint8_t* log_get_bytes(uint16_t offset, uint16_t* n)
+{
+    if(offset >= fram_log_len)
+        *n = 0;
+    else if(*n > fram_log_len - offset)
+        *n = fram_log_len - offset;
+    return &fram_log[offset];
+}
+
+int log_restart()                   { return 0; }
+int log_sd_card_busy()              { return 0; }
+unsigned int battery_get_vbat()     { return 3600; }
+uint32_t energy_get_average_ua()    { return 360; }
+uint32_t energy_get_charge_uah()    { return 8690; }
+uint32_t energy_get_elapsed()       { return now_ms / 1000U; }
+uint32_t energy_get_ms(uint8_t state) { (void)state; return 0; }
+uint32_t energy_get_projected_hours() { return 5500; }
+uint32_t energy_get_wakeups_per_hour() { return 60; }
+void energy_reset()                 {}
+int32_t get_last_stored_weight()    { return 178021; }
+int32_t get_weight_offset()         { return 0; }
+int32_t get_weight_threshold()      { return 50000; }
+int set_weight_threshold(int32_t new_th) { (void)new_th; return 1; }
+void load_cell_bypass_threshold(int status) { (void)status; }
+void load_cell_trigger_tare()       {}
+int32_t params_get(uint8_t id)      { (void)id; return 0; }
+int params_set(uint8_t id, int32_t value) { (void)id; (void)value; return 0; }
+void rfid_get_last_id(uint64_t* id) { *id = 0x59004529B6ULL; }
+uint8_t rtc_get_p_hour()            { return 8; }
+uint8_t rtc_get_p_min()             { return 0; }
+uint8_t rtc_get_r_hour()            { return 16; }
+uint8_t rtc_get_r_min()             { return 0; }
+void rtc_set_clock(uint32_t unix_timestamp) { (void)unix_timestamp; }
+void rtc_set_pause_times(uint8_t p_hour, uint8_t p_min, uint8_t r_hour, uint8_t r_min)
+{
+    (void)p_hour; (void)p_min; (void)r_hour; (void)r_min;
+}
+unsigned int stack_monitor_count()  { return 0; }
+uint8_t stack_monitor_get(unsigned int n, uint16_t *size, uint16_t *peak) { (void)n; *size = *peak = 0; return 0; }
+void stack_monitor_get_hwi(uint16_t *size, uint16_t *peak) { *size = *peak = 0; }
+void telemetry_subscribe(uint8_t decimation) { (void)decimation; }
+void telemetry_unsubscribe()        {}
+uint16_t trace_get_length()         { return 0; }
+int trace_overflow()                { return 0; }
+void trace_start(uint8_t streams)   { (void)streams; }
+void trace_stop()                   {}
+uint8_t trace_streams()             { return 0; }
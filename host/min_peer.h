@@ -0,0 +1,77 @@
+/*
+ * min_peer.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Host MIN peer: the wifi side of the nestbox (fw/min/min.c, the command handler of
+ *  fw/wifi_commands.c and the log download of fw/log_transfer.c, the rest of the firmware
+ *  stubbed) and an ESP side MIN context, connected by a socketpair, in virtual time (ms).
+ *
+ *  The link carries whole frames at the baud rate of each direction; frames can be lost
+ *  or get one wrong byte. The nestbox side runs the loop of user_button_Task(): it waits
+ *  for received bytes (at most 32 per read) or the read timeout, UART writes block it for
+ *  their wire time, and bytes that arrive while its RX ring is full are lost. The ESP side
+ *  polls every ms and answers nothing by itself.
+ */
+
+#ifndef HOST_MIN_PEER_H_
+#define HOST_MIN_PEER_H_
+
+#include <stdint.h>
+
+#include "min/min.h"
+
+#define MIN_PEER_MAX_LOG        8192    // bytes of the simulated FRAM log
+#define MIN_PEER_MAX_COMMANDS   20000   // round trips with a recorded latency
+
+struct min_peer_link {
+    uint32_t baudrate;
+    unsigned int drop_permille;         // frames lost on the wire (both directions)
+    unsigned int corrupt_permille;      // frames with one wrong byte
+    uint32_t seed;                      // of the losses and errors
+    // log download as before the wire time retransmit timeout (user-031): the frame
+    // retransmit timeout is a fixed 50 ms and every log_transfer_poll() runs 16 min_poll()
+    int legacy_transfer;
+};
+
+struct min_peer_stats {
+    uint32_t commands;                  // commands answered
+    uint32_t resent;                    // commands sent again after the answer timeout
+    uint32_t lost;                      // commands without an answer after all retries
+    uint32_t wrong;                     // answers to another command
+};
+
+// a new link, both sides reset, the time at 0 and the log filled with n bytes of log
+void min_peer_init(const struct min_peer_link *link, const uint8_t *log, uint16_t n);
+
+uint32_t min_peer_now();
+
+// runs both sides for ms milliseconds
+void min_peer_run(uint32_t ms);
+
+// one command as the ESP sends it (min_send_frame) and its answer, sent again after the
+// answer timeout; returns the answer length (answer[0] is the command), -1 without answer
+int min_peer_command(const uint8_t *cmd, uint8_t len, uint8_t *answer);
+
+// 'G' download of the log bytes [start, end) into buf, until the end marker; returns
+// the number of bytes received in order, -1 if the stream stalled or was out of order
+int min_peer_download(uint16_t start, uint16_t end, int compressed, uint8_t *buf);
+
+void min_peer_get_stats(struct min_peer_stats *stats);
+
+// round trip time of the answered commands (first send to answer), percent 0..100
+uint32_t min_peer_latency_percentile(unsigned int percent);
+
+// the MIN contexts (diagnostic counters)
+struct min_context *min_peer_nestbox();
+struct min_context *min_peer_esp();
+
+// frames and bytes (stuff bytes included) that left the nestbox side
+uint32_t min_peer_nestbox_frames();
+uint32_t min_peer_nestbox_bytes();
+
+// bytes lost because the RX ring of the nestbox was full
+uint32_t min_peer_nestbox_overruns();
+
+#endif /* HOST_MIN_PEER_H_ */
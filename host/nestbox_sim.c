@@ -0,0 +1,114 @@
+/*
+ * nestbox_sim.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Runs the firmware on the host platform through a scenario file (platform/scenario.h)
+ *  and reports what ended up on the SD card.
+ *
+ *    nestbox_sim [-t] [-o sd.txt] scenario.txt
+ *      -t   simulate every 1 ms tick instead of fast forward
+ *      -o   write the SD card content to a file, compressed flushes (param sd_compress 1)
+ *           as text lines
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "models.h"
+#include "scenario.h"
+#include "log_unpack.h"
+
+int nestbox_main(void);
+
+// log lines of an entry type
+static unsigned long count_lines(const char *data, char c)
+{
+    const char *p = data;
+    unsigned long n = 0;
+
+    while(p != NULL && *p)
+    {
+        if(p[0] == c && p[1] == ',')
+            n++;
+        p = strchr(p, '\n');
+        if(p != NULL)
+            p++;
+    }
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    struct scenario s;
+    struct timespec t0, t1;
+    const char *out = NULL;
+    const char *data;
+    const char *reason;
+    size_t n, len;
+    double wall;
+    int opt;
+
+    while((opt = getopt(argc, argv, "to:")) != -1)
+    {
+        switch(opt)
+        {
+        case 't':
+            sim_set_fast_forward(0);
+            break;
+        case 'o':
+            out = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t] [-o sd.txt] scenario.txt\n", argv[0]);
+            return 2;
+        }
+    }
+    if(optind != argc - 1)
+    {
+        fprintf(stderr, "usage: %s [-t] [-o sd.txt] scenario.txt\n", argv[0]);
+        return 2;
+    }
+    if(scenario_load(&s, argv[optind]) != 0)
+        return 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    scenario_start(&s);
+    nestbox_main();
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    data = sd_logger_data(&n);
+    data = log_unpack((const uint8_t *)data, n, &len);
+    if(data == NULL)
+    {
+        fprintf(stderr, "corrupt compressed flush on the SD card\n");
+        return 1;
+    }
+    reason = sim_halt_reason();
+    printf("scenario: %.1f days, %zu visits\n", s.duration_us / (86400.0 * SIM_US_PER_SEC), s.n_visits);
+    printf("run:      %.0f s virtual in %.2f s (%.0fx), halt: %s\n",
+           sim_time_us() / (double)SIM_US_PER_SEC, wall, sim_time_us() / (wall * SIM_US_PER_SEC),
+           reason ? reason : "none");
+    printf("sd card:  %u sessions, %zu bytes (%zu as text), %zu garbled\n", sd_logger_sessions(), n, len,
+           sd_logger_garbled());
+    printf("entries:  %lu R (tag), %lu W (weight), %lu V (measured visit), %lu P (battery)\n",
+           count_lines(data, 'R'), count_lines(data, 'W'), count_lines(data, 'V'), count_lines(data, 'P'));
+
+    if(out != NULL)
+    {
+        FILE *f = fopen(out, "w");
+        if(f == NULL || fwrite(data, 1, len, f) != len || fclose(f) != 0)
+        {
+            perror(out);
+            return 1;
+        }
+    }
+    scenario_free(&s);
+    return 0;
+}
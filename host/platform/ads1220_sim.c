@@ -0,0 +1,258 @@
+/*
+ * ads1220_sim.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  ADS1220 on the load cell SPI bus (ADS1220/ads1220.c through spi_submit()), powered by
+ *  nbox_loadcell_ldo_enable. Every chip select frame is one command: RESET, START/SYNC,
+ *  POWERDOWN, RDATA, RREG, WREG; any other first byte just clocks out the last result.
+ *  Conversions take one period of the configured data rate (normal mode), in single
+ *  shot or continuous mode; DRDY (nbox_loadcell_data_ready) falls when a result is
+ *  ready and rises when it is read or about to be replaced.
+ *
+ *  The bridge input is the load on the perch in grams at the time the conversion ends,
+ *  with the box calibration of params.c (1098.9 counts per gram at gain 128) on top of
+ *  a zero offset that drifts with the temperature. Each result carries the input
+ *  referred noise of the data sheet (normal mode, by data rate and gain) as white
+ *  Gaussian noise from a fixed seed, so runs stay reproducible.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "sim.h"
+#include "models.h"
+#include "nestbox_init.h"
+
+#define CMD_POWERDOWN       0x02
+#define CMD_RESET           0x06
+#define CMD_START_SYNC      0x08
+#define CMD_RDATA           0x10
+#define CMD_RREG            0x20
+#define CMD_WREG            0x40
+
+#define CONF1_TS            0x02
+#define CONF1_CM            0x04
+#define CONF1_DR(_r)        (((_r) >> 5) & 0x07)
+#define CONF0_GAIN(_r)      (((_r) >> 1) & 0x07)
+
+#define COUNTS_PER_GRAM     1098.9  // at gain 128
+#define ZERO_OFFSET         180000  // empty perch at 20 degC, gain 128
+#define ZERO_CELSIUS        20.0
+#define FULL_SCALE          0x7fffff
+#define VREF_UV             3300000.0   // the bridge excitation (ratiometric)
+#define NOISE_SEED          0x9E3779B97F4A7C15ULL
+
+static const uint32_t rate_sps[8] = { 20, 45, 90, 175, 330, 600, 1000, 1000 };
+
+// input referred noise in uV RMS by data rate (rows) and gain 1 ... 128 (data sheet table 1)
+static const double noise_uv[7][8] = {
+    {  3.71,  1.96,  0.92,  0.47,  0.25,  0.18,  0.11,  0.09 },
+    {  5.36,  2.87,  1.38,  0.76,  0.42,  0.28,  0.17,  0.14 },
+    {  7.50,  3.93,  1.92,  0.99,  0.55,  0.38,  0.22,  0.17 },
+    { 10.60,  5.52,  2.90,  1.48,  0.81,  0.57,  0.33,  0.27 },
+    { 14.90,  7.98,  4.00,  2.06,  1.12,  0.82,  0.48,  0.38 },
+    { 25.30, 13.40,  7.13,  3.81,  2.04,  1.28,  0.77,  0.61 },
+    { 44.80, 24.50, 12.80,  6.80,  3.49,  2.28,  1.41,  1.03 },
+};
+
+static sim_signal_fxn perch_grams = NULL;
+static sim_signal_fxn perch_celsius = NULL;
+
+static uint8_t regs[4];
+static int powered = 0;
+static int converting = 0;
+static int unread = 0;              // DRDY low
+static int32_t result = 0;
+static uint32_t generation = 0;     // conversions of an earlier start are stale
+static double offset_drift = 0;     // counts per degC at gain 128
+static uint64_t rng = NOISE_SEED;
+static uint64_t converting_us = 0;  // finished periods of converting
+static uint64_t converting_since;
+
+static void drdy(int level)
+{
+    unread = !level;
+    sim_gpio_set_input(nbox_loadcell_data_ready, level);
+}
+
+static double celsius(uint64_t t)
+{
+    return perch_celsius != NULL ? perch_celsius(t) : ZERO_CELSIUS;
+}
+
+// xorshift64*, uniform in (0, 1)
+static double uniform()
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return ((rng * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0) + 0x1p-54;
+}
+
+// noise of one conversion in counts (Box-Muller)
+static double noise_counts()
+{
+    unsigned int rate = CONF1_DR(regs[1]) > 6 ? 6 : CONF1_DR(regs[1]);
+    unsigned int gain = CONF0_GAIN(regs[0]);
+    double lsb_uv = 2 * VREF_UV / (1 << gain) / (1 << 24);
+
+    return noise_uv[rate][gain] / lsb_uv * sqrt(-2 * log(uniform())) * cos(2 * M_PI * uniform());
+}
+
+static int32_t bridge_counts(uint64_t t)
+{
+    double grams = perch_grams != NULL ? perch_grams(t) : 0.0;
+    double zero = ZERO_OFFSET + offset_drift * (celsius(t) - ZERO_CELSIUS);
+    double counts = (zero + grams * COUNTS_PER_GRAM) * (1 << CONF0_GAIN(regs[0])) / 128 + noise_counts();
+
+    if(counts > FULL_SCALE)
+        counts = FULL_SCALE;
+    if(counts < -FULL_SCALE - 1)
+        counts = -FULL_SCALE - 1;
+    return (int32_t)counts;
+}
+
+// 14 bit temperature in 1/32 degC, left justified
+static int32_t temperature_counts(uint64_t t)
+{
+    int32_t temperature = (int32_t)floor(celsius(t) * 32);
+
+    return temperature * (1 << 10);
+}
+
+static uint64_t conversion_us()
+{
+    return SIM_US_PER_SEC / rate_sps[CONF1_DR(regs[1])];
+}
+
+static void set_converting(int on)
+{
+    if(on && !converting)
+        converting_since = sim_time_us();
+    if(!on && converting)
+        converting_us += sim_time_us() - converting_since;
+    converting = on;
+}
+
+static void conversion_done(void *arg)
+{
+    if((uintptr_t)arg != generation || !converting)
+        return;
+
+    if(regs[1] & CONF1_TS)
+        result = temperature_counts(sim_time_us());
+    else
+        result = bridge_counts(sim_time_us());
+
+    if(unread)
+        drdy(1); // the old result is replaced
+    drdy(0);
+
+    if(regs[1] & CONF1_CM)
+        sim_after(conversion_us(), conversion_done, arg);
+    else
+        set_converting(0);
+}
+
+static void conversion_start()
+{
+    generation++;
+    set_converting(1);
+    sim_after(conversion_us(), conversion_done, (void *)(uintptr_t)generation);
+}
+
+static void conversion_stop()
+{
+    generation++;
+    set_converting(0);
+}
+
+static void device_reset()
+{
+    memset(regs, 0, sizeof(regs));
+    conversion_stop();
+    result = 0;
+}
+
+static void shift_out(const uint8_t *src, uint8_t *rx, size_t n)
+{
+    memcpy(rx, src, n);
+    if(unread)
+        drdy(1);
+}
+
+static void ads_frame(const uint8_t *tx, uint8_t *rx, size_t n)
+{
+    uint8_t data[3];
+    uint8_t cmd = tx[0];
+
+    if(!powered || n == 0)
+        return;
+
+    data[0] = (result >> 16) & 0xff;
+    data[1] = (result >> 8) & 0xff;
+    data[2] = result & 0xff;
+
+    if((cmd & 0xf0) == CMD_WREG)
+    {
+        unsigned int reg = (cmd >> 2) & 0x03;
+        unsigned int count = (cmd & 0x03) + 1;
+        unsigned int i;
+        for(i = 0; i < count && reg + i < sizeof(regs) && 1 + i < n; i++)
+            regs[reg + i] = tx[1 + i];
+        // a register write restarts a running conversion
+        if(converting)
+            conversion_start();
+    }
+    else if((cmd & 0xf0) == CMD_RREG)
+    {
+        unsigned int reg = (cmd >> 2) & 0x03;
+        unsigned int count = (cmd & 0x03) + 1;
+        unsigned int i;
+        for(i = 0; i < count && reg + i < sizeof(regs) && 1 + i < n; i++)
+            rx[1 + i] = regs[reg + i];
+    }
+    else if((cmd & 0xfe) == CMD_RDATA)
+    {
+        if(n > 1)
+            shift_out(data, rx + 1, n - 1 < 3 ? n - 1 : 3);
+    }
+    else if((cmd & 0xfe) == CMD_RESET)
+        device_reset();
+    else if((cmd & 0xfe) == CMD_START_SYNC)
+        conversion_start();
+    else if((cmd & 0xfe) == CMD_POWERDOWN)
+        conversion_stop();
+    else
+        shift_out(data, rx, n < 3 ? n : 3);
+}
+
+static void ldo_power(unsigned int index, int level)
+{
+    (void)index;
+    powered = level;
+    device_reset();
+    drdy(1);
+}
+
+void ads1220_sim_attach(sim_signal_fxn grams, sim_signal_fxn temperature)
+{
+    perch_grams = grams;
+    perch_celsius = temperature;
+    sim_spi_attach(0, ads_frame);
+    sim_gpio_watch(nbox_loadcell_ldo_enable, ldo_power);
+}
+
+void ads1220_sim_set_offset_drift(double counts_per_degc)
+{
+    offset_drift = counts_per_degc;
+}
+
+uint64_t ads1220_sim_converting_us()
+{
+    if(converting)
+        return converting_us + sim_time_us() - converting_since;
+    return converting_us;
+}
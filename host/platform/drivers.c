@@ -0,0 +1,610 @@
+/*
+ * drivers.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  TI-RTOS drivers and driverlib on the host: GPIO on the simulated port registers,
+ *  UART and SPI towards the device models (sim.h), clock system, FRAM controller and
+ *  CRC module.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <msp430.h>
+#include <cs.h>
+#include <crc.h>
+#include <framctl.h>
+#include <ti/drivers/GPIO.h>
+#include <ti/drivers/UART.h>
+#include <ti/drivers/SPI.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+#include "sim.h"
+
+#define MAX_PINS        64
+#define MAX_WATCHES     4       // models watching the same output pin
+#define MAX_UARTS       2
+#define MAX_SPIS        1
+#define UART_FIFO_SIZE  64      // power of two
+#define UART_BITS       10      // start, 8 data, stop
+
+/* ======== GPIO ======== */
+
+struct port_regs {
+    volatile uint8_t *in;
+    volatile uint8_t *out;
+    volatile uint8_t *dir;
+    volatile uint8_t *ren;
+    volatile uint8_t *ies;
+    volatile uint8_t *ie;
+    volatile uint8_t *ifg;
+};
+
+// port J has no interrupts
+static volatile uint8_t pj_ies, pj_ie, pj_ifg;
+
+static const struct port_regs ports[] = {
+    { 0 },
+    { &P1IN, &P1OUT, &P1DIR, &P1REN, &P1IES, &P1IE, &P1IFG },
+    { &P2IN, &P2OUT, &P2DIR, &P2REN, &P2IES, &P2IE, &P2IFG },
+    { &P3IN, &P3OUT, &P3DIR, &P3REN, &P3IES, &P3IE, &P3IFG },
+    { &P4IN, &P4OUT, &P4DIR, &P4REN, &P4IES, &P4IE, &P4IFG },
+    { &PJIN, &PJOUT, &PJDIR, &PJREN, &pj_ies, &pj_ie, &pj_ifg },
+};
+
+// board pin table (nestbox_host.c)
+extern const GPIOMSP430_Config GPIOMSP430_config;
+
+static sim_gpio_fxn gpio_watch[MAX_PINS][MAX_WATCHES];
+static uint64_t pin_high_us[MAX_PINS];      // finished periods of the output high
+static uint64_t pin_high_since[MAX_PINS];
+
+static const struct port_regs *pin_port(unsigned int index)
+{
+    return &ports[GPIOMSP430_PORT(GPIOMSP430_config.pinConfigs[index])];
+}
+
+static uint8_t pin_bit(unsigned int index)
+{
+    return GPIOMSP430_BIT(GPIOMSP430_config.pinConfigs[index]);
+}
+
+static void pin_output_changed(unsigned int index, int old, int level)
+{
+    if(index >= MAX_PINS || old == level)
+        return;
+    if(level)
+        pin_high_since[index] = sim_time_us();
+    else
+        pin_high_us[index] += sim_time_us() - pin_high_since[index];
+}
+
+// pending and enabled interrupt of the pin: clear the flag, call back
+static void gpio_dispatch(unsigned int index)
+{
+    const struct port_regs *port = pin_port(index);
+    uint8_t bit = pin_bit(index);
+
+    if(!(*port->ifg & bit) || !(*port->ie & bit))
+        return;
+    *port->ifg &= ~bit;
+    if(index < GPIOMSP430_config.numberOfCallbacks && GPIOMSP430_config.callbacks[index] != NULL)
+    {
+        GPIOMSP430_config.callbacks[index](index);
+        sim_isr_exit();
+    }
+}
+
+void GPIO_init()
+{
+    unsigned int i;
+
+    for(i = 0; i < GPIOMSP430_config.numberOfPinConfigs; i++)
+    {
+        GPIO_PinConfig cfg = GPIOMSP430_config.pinConfigs[i];
+        const struct port_regs *port = pin_port(i);
+        uint8_t bit = pin_bit(i);
+        int old = (*port->out & bit) != 0;
+
+        *port->ie &= ~bit;
+        *port->ifg &= ~bit;
+        if(cfg & GPIO_CFG_OUT_STD)
+        {
+            *port->dir |= bit;
+            if(cfg & GPIO_CFG_OUT_HIGH)
+                *port->out |= bit;
+            else
+                *port->out &= ~bit;
+        }
+        else
+        {
+            *port->dir &= ~bit;
+            if(cfg & (GPIO_CFG_IN_PU | GPIO_CFG_IN_PD))
+                *port->ren |= bit;
+            if(cfg & GPIO_CFG_IN_PU)
+                *port->out |= bit;
+            else
+                *port->out &= ~bit;
+            if(cfg & GPIO_CFG_IN_INT_FALLING)
+                *port->ies |= bit;
+            else
+                *port->ies &= ~bit;
+        }
+        // outputs read back what they drive, open inputs their pull
+        if(*port->out & bit)
+            *port->in |= bit;
+        else
+            *port->in &= ~bit;
+        pin_output_changed(i, old, (*port->out & bit) != 0);
+    }
+}
+
+unsigned int GPIO_read(unsigned int index)
+{
+    return (*pin_port(index)->in & pin_bit(index)) ? 1 : 0;
+}
+
+void GPIO_write(unsigned int index, unsigned int value)
+{
+    const struct port_regs *port = pin_port(index);
+    uint8_t bit = pin_bit(index);
+    int old = (*port->out & bit) != 0;
+    unsigned int i;
+
+    if(value)
+        *port->out |= bit;
+    else
+        *port->out &= ~bit;
+    if(*port->dir & bit)
+    {
+        if(value)
+            *port->in |= bit;
+        else
+            *port->in &= ~bit;
+    }
+    if(old == (value != 0) || index >= MAX_PINS)
+        return;
+    pin_output_changed(index, old, value != 0);
+    for(i = 0; i < MAX_WATCHES && gpio_watch[index][i] != NULL; i++)
+        gpio_watch[index][i](index, value != 0);
+}
+
+void GPIO_toggle(unsigned int index)
+{
+    GPIO_write(index, !(*pin_port(index)->out & pin_bit(index)));
+}
+
+void GPIO_enableInt(unsigned int index)
+{
+    *pin_port(index)->ie |= pin_bit(index);
+    gpio_dispatch(index); // a latched edge interrupts right away
+}
+
+void GPIO_disableInt(unsigned int index)
+{
+    *pin_port(index)->ie &= ~pin_bit(index);
+}
+
+void GPIO_clearInt(unsigned int index)
+{
+    *pin_port(index)->ifg &= ~pin_bit(index);
+}
+
+void GPIO_setCallback(unsigned int index, GPIO_CallbackFxn callback)
+{
+    if(index < GPIOMSP430_config.numberOfCallbacks)
+        GPIOMSP430_config.callbacks[index] = callback;
+}
+
+void sim_gpio_set_input(unsigned int index, int level)
+{
+    const struct port_regs *port = pin_port(index);
+    uint8_t bit = pin_bit(index);
+    int old = (*port->in & bit) != 0;
+
+    if(*port->dir & bit)
+        return; // driven by the MCU
+    if(level)
+        *port->in |= bit;
+    else
+        *port->in &= ~bit;
+    if(old == (level != 0))
+        return;
+
+    // PxIES set: falling edge
+    if((level != 0) == !(*port->ies & bit))
+    {
+        *port->ifg |= bit;
+        gpio_dispatch(index);
+    }
+}
+
+int sim_gpio_get_output(unsigned int index)
+{
+    return (*pin_port(index)->out & pin_bit(index)) != 0;
+}
+
+uint64_t sim_gpio_high_us(unsigned int index)
+{
+    if(index >= MAX_PINS)
+        return 0;
+    if(sim_gpio_get_output(index))
+        return pin_high_us[index] + sim_time_us() - pin_high_since[index];
+    return pin_high_us[index];
+}
+
+void sim_gpio_watch(unsigned int index, sim_gpio_fxn fxn)
+{
+    unsigned int i;
+
+    if(index >= MAX_PINS)
+        return;
+    for(i = 0; i < MAX_WATCHES; i++)
+    {
+        if(gpio_watch[index][i] == NULL)
+        {
+            gpio_watch[index][i] = fxn;
+            return;
+        }
+    }
+    abort(); // more models on one pin than MAX_WATCHES
+}
+
+/* ======== UART ======== */
+
+struct uart_port {
+    UART_Config config;
+    const struct sim_uart_device *dev;
+    uint8_t fifo[UART_FIFO_SIZE];
+    unsigned int head;
+    unsigned int tail;
+    Semaphore_Object rx_sem;    // byte received (blocking reads)
+    uint64_t rx_busy_until;     // end of the last byte on the wire towards the MCU
+    uint64_t open_us;           // finished periods of the port open
+    uint64_t open_since;
+};
+
+struct uart_rx_byte {
+    unsigned int index;
+    uint8_t byte;
+    uint32_t baud;
+};
+
+static struct uart_port uarts[MAX_UARTS];
+
+static uint64_t uart_wire_us(size_t n, uint32_t baud)
+{
+    return (n * UART_BITS * SIM_US_PER_SEC + baud - 1) / baud;
+}
+
+void UART_init()
+{
+    unsigned int i;
+
+    for(i = 0; i < MAX_UARTS; i++)
+    {
+        uarts[i].config.index = i;
+        uarts[i].rx_sem.mode = Semaphore_Mode_BINARY;
+    }
+}
+
+void UART_Params_init(UART_Params *params)
+{
+    memset(params, 0, sizeof(*params));
+    params->readMode = UART_MODE_BLOCKING;
+    params->writeMode = UART_MODE_BLOCKING;
+    params->readTimeout = UART_WAIT_FOREVER;
+    params->writeTimeout = UART_WAIT_FOREVER;
+    params->readReturnMode = UART_RETURN_NEWLINE;
+    params->readDataMode = UART_DATA_TEXT;
+    params->writeDataMode = UART_DATA_TEXT;
+    params->readEcho = UART_ECHO_ON;
+    params->baudRate = 115200;
+    params->dataLength = UART_LEN_8;
+    params->stopBits = UART_STOP_ONE;
+    params->parityType = UART_PAR_NONE;
+}
+
+UART_Handle UART_open(unsigned int index, UART_Params *params)
+{
+    struct uart_port *port;
+
+    if(index >= MAX_UARTS || uarts[index].config.open)
+        return NULL;
+
+    port = &uarts[index];
+    if(params != NULL)
+        port->config.params = *params;
+    else
+        UART_Params_init(&port->config.params);
+    port->config.open = 1;
+    port->open_since = sim_time_us();
+    port->config.read_buf = NULL;
+    port->head = port->tail = 0;
+    port->rx_sem.count = 0;
+    if(port->dev != NULL && port->dev->open != NULL)
+        port->dev->open(port->config.params.baudRate);
+    return &port->config;
+}
+
+void UART_close(UART_Handle handle)
+{
+    struct uart_port *port = &uarts[handle->index];
+
+    if(handle->open)
+        port->open_us += sim_time_us() - port->open_since;
+    handle->open = 0;
+    handle->read_buf = NULL;
+    if(port->dev != NULL && port->dev->close != NULL)
+        port->dev->close();
+}
+
+int UART_write(UART_Handle handle, const void *buffer, size_t size)
+{
+    struct uart_port *port = &uarts[handle->index];
+
+    if(!handle->open)
+        return UART_ERROR;
+    if(port->dev != NULL && port->dev->rx != NULL)
+        port->dev->rx(buffer, size, handle->params.baudRate);
+    sim_task_wait_us(uart_wire_us(size, handle->params.baudRate));
+    return (int)size;
+}
+
+static int uart_fifo_pop(struct uart_port *port, uint8_t *byte)
+{
+    if(port->head == port->tail)
+        return 0;
+    *byte = port->fifo[port->tail];
+    port->tail = (port->tail + 1) & (UART_FIFO_SIZE - 1);
+    return 1;
+}
+
+// callback mode: fill the pending read from the FIFO, call back when it is complete
+static void uart_callback_read(struct uart_port *port)
+{
+    UART_Config *cfg = &port->config;
+
+    while(cfg->read_buf != NULL && uart_fifo_pop(port, &cfg->read_buf[cfg->read_count]))
+    {
+        if(++cfg->read_count == cfg->read_size)
+        {
+            uint8_t *buf = cfg->read_buf;
+            cfg->read_buf = NULL;
+            cfg->params.readCallback(cfg, buf, cfg->read_count);
+        }
+    }
+}
+
+int UART_read(UART_Handle handle, void *buffer, size_t size)
+{
+    struct uart_port *port = &uarts[handle->index];
+    uint8_t *data = buffer;
+    size_t count = 0;
+
+    if(!handle->open)
+        return UART_ERROR;
+
+    if(handle->params.readMode == UART_MODE_CALLBACK)
+    {
+        handle->read_buf = data;
+        handle->read_size = size;
+        handle->read_count = 0;
+        uart_callback_read(port);
+        return 0;
+    }
+
+    while(count < size)
+    {
+        if(uart_fifo_pop(port, &data[count]))
+            count++;
+        else if(!Semaphore_pend(&port->rx_sem, handle->params.readTimeout))
+            break;
+    }
+    return (int)count;
+}
+
+void UART_readCancel(UART_Handle handle)
+{
+    uint8_t *buf = handle->read_buf;
+
+    if(buf == NULL)
+        return;
+    handle->read_buf = NULL;
+    handle->params.readCallback(handle, buf, handle->read_count);
+}
+
+static void uart_rx_event(void *arg)
+{
+    struct uart_rx_byte *rx = arg;
+    struct uart_port *port = &uarts[rx->index];
+    unsigned int next = (port->head + 1) & (UART_FIFO_SIZE - 1);
+
+    if(port->config.open && next != port->tail)
+    {
+        // at the wrong baud rate, the receiver samples noise
+        port->fifo[port->head] = rx->baud == port->config.params.baudRate ? rx->byte : (uint8_t)~rx->byte;
+        port->head = next;
+        if(port->config.params.readMode == UART_MODE_CALLBACK)
+            uart_callback_read(port);
+        else
+            Semaphore_post(&port->rx_sem);
+    }
+    free(rx);
+}
+
+uint64_t sim_uart_open_us(unsigned int index)
+{
+    const struct uart_port *port = &uarts[index];
+
+    if(port->config.open)
+        return port->open_us + sim_time_us() - port->open_since;
+    return port->open_us;
+}
+
+void sim_uart_attach(unsigned int index, const struct sim_uart_device *dev)
+{
+    if(index < MAX_UARTS)
+        uarts[index].dev = dev;
+}
+
+void sim_uart_send(unsigned int index, const uint8_t *data, size_t n, uint32_t baud)
+{
+    struct uart_port *port = &uarts[index];
+    uint64_t t = port->rx_busy_until > sim_time_us() ? port->rx_busy_until : sim_time_us();
+    size_t i;
+
+    for(i = 0; i < n; i++)
+    {
+        struct uart_rx_byte *rx = malloc(sizeof(*rx));
+        if(rx == NULL)
+            abort();
+        rx->index = index;
+        rx->byte = data[i];
+        rx->baud = baud;
+        t += uart_wire_us(1, baud);
+        sim_at(t, uart_rx_event, rx);
+    }
+    port->rx_busy_until = t;
+}
+
+/* ======== SPI ======== */
+
+static SPI_Config spis[MAX_SPIS];
+static sim_spi_fxn spi_devices[MAX_SPIS];
+
+void SPI_init()
+{
+    unsigned int i;
+
+    for(i = 0; i < MAX_SPIS; i++)
+        spis[i].index = i;
+}
+
+void SPI_Params_init(SPI_Params *params)
+{
+    memset(params, 0, sizeof(*params));
+    params->transferMode = SPI_MODE_BLOCKING;
+    params->transferTimeout = BIOS_WAIT_FOREVER;
+    params->mode = SPI_MASTER;
+    params->bitRate = 1000000;
+    params->dataSize = 8;
+    params->frameFormat = SPI_POL0_PHA0;
+}
+
+SPI_Handle SPI_open(unsigned int index, SPI_Params *params)
+{
+    if(index >= MAX_SPIS || spis[index].open)
+        return NULL;
+    if(params != NULL)
+        spis[index].params = *params;
+    else
+        SPI_Params_init(&spis[index].params);
+    spis[index].open = 1;
+    return &spis[index];
+}
+
+void SPI_close(SPI_Handle handle)
+{
+    handle->open = 0;
+}
+
+// a few bytes at MHz rates: no wire time
+bool SPI_transfer(SPI_Handle handle, SPI_Transaction *transaction)
+{
+    uint8_t tx[64];
+    uint8_t rx[64];
+    size_t n = transaction->count;
+
+    if(!handle->open || n > sizeof(tx))
+        return false;
+
+    if(transaction->txBuf != NULL)
+        memcpy(tx, transaction->txBuf, n);
+    else
+        memset(tx, 0, n);
+    memset(rx, 0xff, n);
+    if(spi_devices[handle->index] != NULL)
+        spi_devices[handle->index](tx, rx, n);
+    if(transaction->rxBuf != NULL)
+        memcpy(transaction->rxBuf, rx, n);
+    return true;
+}
+
+void sim_spi_attach(unsigned int index, sim_spi_fxn fxn)
+{
+    if(index < MAX_SPIS)
+        spi_devices[index] = fxn;
+}
+
+/* ======== CS, FRAMCtl, CRC ======== */
+
+#define DCO_FREQ    8000000
+#define LFXT_FREQ   32768
+
+static uint32_t mclk = DCO_FREQ;
+
+void CS_initClockSignal(uint8_t selectedClockSignal, uint16_t clockSource, uint16_t clockSourceDivider)
+{
+    (void)clockSource; // DCO
+    if(selectedClockSignal == CS_MCLK)
+        mclk = DCO_FREQ >> clockSourceDivider;
+}
+
+uint32_t CS_getACLK()
+{
+    return LFXT_FREQ;
+}
+
+uint32_t CS_getSMCLK()
+{
+    return DCO_FREQ;
+}
+
+uint32_t CS_getMCLK()
+{
+    return mclk;
+}
+
+void FRAMCtl_configureWaitStateControl(uint8_t waitState)
+{
+    (void)waitState;
+}
+
+// CRC16-CCITT as the CRC module computes it (CRCDI: low byte first, bit reversed)
+static uint16_t crc_result;
+
+void CRC_setSeed(uint16_t baseAddress, uint16_t seed)
+{
+    (void)baseAddress;
+    crc_result = seed;
+}
+
+void CRC_set8BitData(uint16_t baseAddress, uint8_t dataIn)
+{
+    unsigned int i;
+    (void)baseAddress;
+
+    for(i = 0; i < 8; i++)
+    {
+        int fb = ((crc_result >> 15) ^ (dataIn >> i)) & 1;
+        crc_result <<= 1;
+        if(fb)
+            crc_result ^= 0x1021;
+    }
+}
+
+void CRC_set16BitData(uint16_t baseAddress, uint16_t dataIn)
+{
+    CRC_set8BitData(baseAddress, dataIn & 0xff);
+    CRC_set8BitData(baseAddress, dataIn >> 8);
+}
+
+uint16_t CRC_getResult(uint16_t baseAddress)
+{
+    (void)baseAddress;
+    return crc_result;
+}
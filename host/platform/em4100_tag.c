@@ -0,0 +1,147 @@
+/*
+ * em4100_tag.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  EM4100 tag in the field of the EM4095 reader (rfid_reader.c with EM_READER). While
+ *  the 5 V rail powers the reader and a tag is in range, the demodulated data on
+ *  nbox_lf_data is captured by TB0 CCR2 on its falling edges: the model calls the
+ *  timer interrupt with the capture register set, like the hardware.
+ *
+ *  The tag repeats its 64 bit frame (9 header ones, 10 rows of 4 data bits with even
+ *  parity, 4 column parity bits, stop bit 0) at RF/64. Manchester code as the decoder
+ *  (rfid_decode_edge()) expects it: a one falls in the middle of the bit, a zero rises,
+ *  so the falling edges are in the middle of every one and between two zeros.
+ */
+
+#include <msp430.h>
+
+#include "sim.h"
+#include "models.h"
+#include "nestbox_init.h"
+#include "fw/em4095_lib/EM4095.h"
+
+#define TAG_BIT_US          512     // 64 carrier periods at 125 kHz
+#define TAG_FRAME_BITS      64
+#define TAG_POWER_UP_US     3000    // field to the first bit
+#define TIMER_US_PER_COUNT  8       // TB0 on SMCLK / 64
+#define TIMER_MC            (MC__UP | MC__CONTINUOUS)
+
+static uint8_t frame[TAG_FRAME_BITS];
+static int present = 0;
+static int field = 0;
+static uint32_t generation = 0;     // events of an earlier power up are stale
+static uint64_t frame_start_us;     // bit 0 of the frame sequence
+static uint32_t bit_index;          // bit of the next edge, counting from frame_start_us
+
+static void frame_build(uint64_t id)
+{
+    uint8_t column[4] = { 0, };
+    unsigned int n = 0;
+    int row;
+    int i;
+
+    for(i = 0; i < 9; i++)
+        frame[n++] = 1;
+    for(row = 0; row < 10; row++)
+    {
+        uint8_t nibble = (id >> (4 * (9 - row))) & 0xf;
+        uint8_t parity = 0;
+        for(i = 0; i < 4; i++)
+        {
+            uint8_t bit = (nibble >> (3 - i)) & 1;
+            frame[n++] = bit;
+            parity ^= bit;
+            column[i] ^= bit;
+        }
+        frame[n++] = parity;
+    }
+    for(i = 0; i < 4; i++)
+        frame[n++] = column[i];
+    frame[n++] = 0;
+}
+
+static uint8_t frame_bit(uint32_t index)
+{
+    return frame[index % TAG_FRAME_BITS];
+}
+
+// time of the falling edge in bit index, 0 if the bit has none
+static uint64_t edge_time(uint32_t index)
+{
+    uint64_t start = frame_start_us + (uint64_t)index * TAG_BIT_US;
+
+    if(frame_bit(index))
+        return start + TAG_BIT_US / 2;
+    if(index > 0 && !frame_bit(index - 1))
+        return start;
+    return 0;
+}
+
+static void edge(void *arg);
+
+static void schedule_next_edge()
+{
+    uint64_t t;
+
+    while((t = edge_time(bit_index)) == 0)
+        bit_index++;
+    sim_at(t, edge, (void *)(uintptr_t)generation);
+}
+
+static void edge(void *arg)
+{
+    if((uintptr_t)arg != generation || !present || !field)
+        return;
+
+    // CCI2A on P1.5, capture on the falling edge with the interrupt enabled
+    if((TB0CTL & TIMER_MC) != MC__STOP && (P1SEL0 & BIT5) &&
+       (TB0CCTL2 & (CAP | CCIE | CM_2)) == (CAP | CCIE | CM_2))
+    {
+        TB0CCR2 = (uint16_t)(sim_time_us() / TIMER_US_PER_COUNT);
+        TB0IV = TB0IV_TB0CCR2;
+        Timer0_B1_ISR();
+        TB0IV = 0;
+    }
+
+    bit_index++;
+    schedule_next_edge();
+}
+
+// the tag starts talking somewhere in its frame once the field has charged it
+static void tag_start()
+{
+    generation++;
+    if(!present || !field)
+        return;
+    frame_start_us = sim_time_us() + TAG_POWER_UP_US;
+    bit_index = (uint32_t)(sim_time_us() / TAG_BIT_US) % TAG_FRAME_BITS;
+    frame_start_us -= (uint64_t)bit_index * TAG_BIT_US;
+    schedule_next_edge();
+}
+
+static void reader_power(unsigned int index, int level)
+{
+    (void)index;
+    field = level;
+    tag_start();
+}
+
+void em4100_tag_attach()
+{
+    sim_gpio_watch(nbox_5v_enable, reader_power);
+}
+
+void em4100_tag_enter(uint64_t id)
+{
+    frame_build(id);
+    present = 1;
+    tag_start();
+}
+
+void em4100_tag_leave()
+{
+    present = 0;
+    generation++;
+}
@@ -0,0 +1,54 @@
+/*
+ * fram.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  The log lives at fixed FRAM addresses (logger.c: header at 0x12FF0, entries from
+ *  0x13000). The host maps the same addresses before main() runs; the memory starts
+ *  erased (0xFF) like a fresh device.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "host.h"
+#include "fw/logger.h"
+
+#define FRAM_BASE   0x12000
+#define FRAM_SIZE   0x2000
+
+// logger.c
+#define LOG_POS_VALID_PW        0x1234
+#define LOG_NEXT_POS_VALID      0x12FFC
+#define LOG_NEXT_POS_OFS        0x12FFE
+#define LOG_TIMESTAMP           0x12FF8
+#define LOG_RTC_ALARM_TIMES     0x12FF0
+#define LOG_BACKUP_PERIOD       (T_LOG_FLUSH_CHECK/1000)
+
+// default pause 8:00, resume 16:00 UTC (rtc_get_pause_times_compact)
+#define DEFAULT_PAUSE_TIMES     0x00100008
+
+__attribute__((constructor)) static void fram_map()
+{
+    void *p = mmap((void *)FRAM_BASE, FRAM_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if(p != (void *)FRAM_BASE)
+    {
+        perror("sim: FRAM at 0x12000");
+        exit(1);
+    }
+    memset(p, 0xff, FRAM_SIZE);
+}
+
+void fram_preset_log(uint32_t unix_time)
+{
+    *(uint16_t *)LOG_NEXT_POS_VALID = LOG_POS_VALID_PW;
+    *(uint16_t *)LOG_NEXT_POS_OFS = 0;
+    // log_startup() adds half a backup period
+    *(uint32_t *)LOG_TIMESTAMP = unix_time - LOG_BACKUP_PERIOD/2;
+    *(uint32_t *)LOG_RTC_ALARM_TIMES = DEFAULT_PAUSE_TIMES;
+}
@@ -0,0 +1,22 @@
+/*
+ * host.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Internal interfaces between the parts of the host platform.
+ */
+
+#ifndef HOST_HOST_H_
+#define HOST_HOST_H_
+
+#include <stdint.h>
+
+// msp430_regs.c: start the peripherals the firmware triggered by a register write
+// (called by the kernel after each task switch and model event)
+void host_hw_poll(void);
+
+// fram.c: log header as left by a box whose clock was set before this power up
+void fram_preset_log(uint32_t unix_time);
+
+#endif /* HOST_HOST_H_ */
@@ -0,0 +1,20 @@
+/*
+ * crc.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  CRC16-CCITT module (CRCDI input, bits in reverse order as on the device).
+ */
+
+#ifndef HOST_CRC_H_
+#define HOST_CRC_H_
+
+#include <stdint.h>
+
+void CRC_setSeed(uint16_t baseAddress, uint16_t seed);
+void CRC_set16BitData(uint16_t baseAddress, uint16_t dataIn);
+void CRC_set8BitData(uint16_t baseAddress, uint8_t dataIn);
+uint16_t CRC_getResult(uint16_t baseAddress);
+
+#endif /* HOST_CRC_H_ */
@@ -0,0 +1,33 @@
+/*
+ * cs.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Clock system: only the MCLK divider is simulated (clock_policy.c).
+ */
+
+#ifndef HOST_CS_H_
+#define HOST_CS_H_
+
+#include <stdint.h>
+
+#define CS_ACLK                 0x01
+#define CS_MCLK                 0x04
+#define CS_SMCLK                0x02
+
+#define CS_DCOCLK_SELECT        0x0003
+
+#define CS_CLOCK_DIVIDER_1      0x0000
+#define CS_CLOCK_DIVIDER_2      0x0001
+#define CS_CLOCK_DIVIDER_4      0x0002
+#define CS_CLOCK_DIVIDER_8      0x0003
+#define CS_CLOCK_DIVIDER_16     0x0004
+#define CS_CLOCK_DIVIDER_32     0x0005
+
+void CS_initClockSignal(uint8_t selectedClockSignal, uint16_t clockSource, uint16_t clockSourceDivider);
+uint32_t CS_getACLK(void);
+uint32_t CS_getSMCLK(void);
+uint32_t CS_getMCLK(void);
+
+#endif /* HOST_CS_H_ */
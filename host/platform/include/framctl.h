@@ -0,0 +1,18 @@
+/*
+ * framctl.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef HOST_FRAMCTL_H_
+#define HOST_FRAMCTL_H_
+
+#include <stdint.h>
+
+#define FRAMCTL_ACCESS_TIME_CYCLES_0    0x00
+#define FRAMCTL_ACCESS_TIME_CYCLES_1    0x10
+
+void FRAMCtl_configureWaitStateControl(uint8_t waitState);
+
+#endif /* HOST_FRAMCTL_H_ */
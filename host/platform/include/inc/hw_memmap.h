@@ -0,0 +1,20 @@
+/*
+ * inc/hw_memmap.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef HOST_INC_HW_MEMMAP_H_
+#define HOST_INC_HW_MEMMAP_H_
+
+#define SFR_BASE        (0x0100)
+#define CRC_BASE        (0x0150)
+#define CS_BASE         (0x0160)
+#define FRAM_BASE       (0x0140)
+#define WDT_A_BASE      (0x015C)
+#define EUSCI_A0_BASE   (0x05C0)
+#define EUSCI_A1_BASE   (0x05E0)
+#define EUSCI_B0_BASE   (0x0640)
+
+#endif /* HOST_INC_HW_MEMMAP_H_ */
@@ -0,0 +1,180 @@
+/*
+ * msp430.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  The MSP430FR5969 registers used by the firmware as plain variables
+ *  (host/platform/msp430_regs.c). The RTC, ADC12 and Timer0_B models read and write
+ *  them in virtual time and call the interrupt routines; all other registers only
+ *  hold what was written. Bit values are those of the device header.
+ */
+
+#ifndef HOST_MSP430_H_
+#define HOST_MSP430_H_
+
+#include <stdint.h>
+
+#define BIT0        (0x0001)
+#define BIT1        (0x0002)
+#define BIT2        (0x0004)
+#define BIT3        (0x0008)
+#define BIT4        (0x0010)
+#define BIT5        (0x0020)
+#define BIT6        (0x0040)
+#define BIT7        (0x0080)
+#define BIT8        (0x0100)
+#define BIT9        (0x0200)
+#define BITA        (0x0400)
+#define BITB        (0x0800)
+#define BITC        (0x1000)
+#define BITD        (0x2000)
+#define BITE        (0x4000)
+#define BITF        (0x8000)
+
+/* status register */
+#define GIE         (0x0008)
+#define CPUOFF      (0x0010)
+#define OSCOFF      (0x0020)
+#define SCG0        (0x0040)
+#define SCG1        (0x0080)
+#define LPM0_bits   (CPUOFF)
+#define LPM3_bits   (SCG1+SCG0+CPUOFF)
+#define LPM4_bits   (SCG1+SCG0+OSCOFF+CPUOFF)
+
+void host_bis_SR_register(uint16_t bits);
+#define __bis_SR_register(x)            host_bis_SR_register(x)
+#define __bic_SR_register(x)            ((void)(x))
+#define __bic_SR_register_on_exit(x)    ((void)(x))
+#define __even_in_range(x, y)           (x)
+#define __no_operation()                ((void)0)
+#define __delay_cycles(x)               ((void)(x))
+#define __interrupt
+
+/* ports */
+extern volatile uint8_t P1IN, P1OUT, P1DIR, P1REN, P1SEL0, P1SEL1, P1IES, P1IE, P1IFG;
+extern volatile uint8_t P2IN, P2OUT, P2DIR, P2REN, P2SEL0, P2SEL1, P2IES, P2IE, P2IFG;
+extern volatile uint8_t P3IN, P3OUT, P3DIR, P3REN, P3SEL0, P3SEL1, P3IES, P3IE, P3IFG;
+extern volatile uint8_t P4IN, P4OUT, P4DIR, P4REN, P4SEL0, P4SEL1, P4IES, P4IE, P4IFG;
+extern volatile uint8_t PJIN, PJOUT, PJDIR, PJREN, PJSEL0, PJSEL1;
+
+/* PMM, SYS */
+extern volatile uint16_t PMMCTL0;
+extern volatile uint16_t PMMIFG;
+extern volatile uint16_t PM5CTL0;
+extern volatile uint16_t SYSRSTIV;
+#define PMMCTL0_L   (((volatile uint8_t *)&PMMCTL0)[0])
+#define PMMCTL0_H   (((volatile uint8_t *)&PMMCTL0)[1])
+
+#define PMMPW       (0xA500)
+#define PMMPW_H     (0xA5)
+#define PMMSWBOR    (0x0004)
+#define PMMSWPOR    (0x0008)
+#define PMMREGOFF   (0x0010)
+#define PMMLPM5IFG  (0x8000)
+#define LOCKLPM5    (0x0001)
+
+#define SYSRSTIV_NONE       (0x0000)
+#define SYSRSTIV_BOR        (0x0002)
+#define SYSRSTIV_RSTNMI     (0x0004)
+#define SYSRSTIV_DOBOR      (0x0006)
+#define SYSRSTIV_LPM5WU     (0x0008)
+
+/* CS */
+extern volatile uint16_t CSCTL0, CSCTL1, CSCTL2, CSCTL3, CSCTL4, CSCTL5, CSCTL6;
+#define CSCTL0_H    (((volatile uint8_t *)&CSCTL0)[1])
+
+#define CSKEY       (0xA500)
+#define LFXTOFF     (0x0001)
+#define SMCLKOFF    (0x0002)
+#define VLOOFF      (0x0008)
+#define HFXTOFF     (0x0100)
+
+/* REF */
+extern volatile uint16_t REFCTL0;
+#define REFON       (0x0001)
+#define REFVSEL_2   (0x0020)
+
+/* ADC12_B */
+extern volatile uint16_t ADC12CTL0, ADC12CTL1, ADC12CTL2, ADC12CTL3;
+extern volatile uint16_t ADC12MCTL0, ADC12MEM0;
+extern volatile uint16_t ADC12IER0, ADC12IFGR0, ADC12IV;
+
+#define ADC12SC         (0x0001)
+#define ADC12ENC        (0x0002)
+#define ADC12ON         (0x0010)
+#define ADC12MSC        (0x0080)
+#define ADC12SHT0_2     (0x0200)
+#define ADC12SHP        (0x0200)
+#define ADC12PDIV_0     (0x0000)
+#define ADC12SSEL_0     (0x0000)
+#define ADC12CONSEQ_0   (0x0000)
+#define ADC12RES_2      (0x0020)
+#define ADC12VRSEL_1    (0x0100)
+#define ADC12EOS        (0x0080)
+#define ADC12INCH_6     (0x0006)
+#define ADC12IE0        (0x0001)
+#define ADC12IFG0       (0x0001)
+
+/* Timer_A, Timer_B */
+extern volatile uint16_t TA0CTL, TA1CTL, TA2CTL, TA3CTL;
+extern volatile uint16_t TB0CTL, TB0EX0, TB0CCTL2, TB0CCR2, TB0IV, TB0R;
+
+#define MC__STOP        (0x0000)
+#define MC__UP          (0x0010)
+#define MC__CONTINUOUS  (0x0020)
+#define TASSEL__SMCLK   (0x0200)
+#define TBSSEL__SMCLK   (0x0200)
+#define CNTL__16        (0x0000)
+#define ID__8           (0x00C0)
+#define TBCLR           (0x0004)
+#define TBIDEX__8       (0x0007)
+#define CM_0            (0x0000)
+#define CM_2            (0x8000)
+#define CCIE            (0x0010)
+#define SCS             (0x0800)
+#define CCIS_0          (0x0000)
+#define CAP             (0x0100)
+#define OUTMOD_0        (0x0000)
+#define OUTMOD_7        (0x00E0)
+
+#define TA0IV_TA0CCR1   (0x0002)
+#define TA0IV_TA0IFG    (0x000E)
+#define TB0IV_TB0CCR2   (0x0004)
+#define TB0IV_TBIFG     (0x000E)
+
+/* RTC_B */
+extern volatile uint16_t RTCCTL01, RTCCTL23, RTCIV, RTCYEAR;
+extern volatile uint8_t RTCSEC, RTCMIN, RTCHOUR, RTCDOW, RTCDAY, RTCMON;
+extern volatile uint8_t RTCAMIN, RTCAHOUR, RTCADOW, RTCADAY;
+
+#define RTCRDYIFG       (0x0001)
+#define RTCAIFG         (0x0002)
+#define RTCTEVIFG       (0x0004)
+#define RTCOFIFG        (0x0008)
+#define RTCRDYIE        (0x0010)
+#define RTCAIE          (0x0020)
+#define RTCTEVIE        (0x0040)
+#define RTCOFIE         (0x0080)
+#define RTCRDY          (0x1000)
+#define RTCHOLD         (0x4000)
+#define RTCBCD          (0x8000)
+#define RTCAE           (0x80)
+
+#define RTCCAL0         (0x0001)
+#define RTCCAL1         (0x0002)
+#define RTCCAL2         (0x0004)
+#define RTCCAL3         (0x0008)
+#define RTCCAL4         (0x0010)
+#define RTCCAL5         (0x0020)
+#define RTCCALS         (0x0080)
+
+#define RTCIV_NONE      (0x0000)
+#define RTCIV_RTCRDYIFG (0x0002)
+#define RTCIV_RTCTEVIFG (0x0004)
+#define RTCIV_RTCAIFG   (0x0006)
+#define RTCIV_RT0PSIFG  (0x0008)
+#define RTCIV_RT1PSIFG  (0x000A)
+#define RTCIV_RTCOFIFG  (0x000C)
+
+#endif /* HOST_MSP430_H_ */
@@ -0,0 +1,86 @@
+/*
+ * ti/drivers/GPIO.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  GPIO driver on the simulated pins (host/platform/drivers.c). The pin table is in the
+ *  host board file (host/platform/nestbox_host.c).
+ */
+
+#ifndef HOST_TI_DRIVERS_GPIO_H_
+#define HOST_TI_DRIVERS_GPIO_H_
+
+#include <stdint.h>
+
+typedef uint32_t GPIO_PinConfig;
+typedef void (*GPIO_CallbackFxn)(unsigned int index);
+
+// pin configuration flags; the port and bit are in the low 16 bits (GPIOMSP430_Px_y)
+#define GPIO_CFG_OUT_STD        0x00010000
+#define GPIO_CFG_OUT_STR_LOW    0
+#define GPIO_CFG_OUT_STR_HIGH   0
+#define GPIO_CFG_OUT_LOW        0
+#define GPIO_CFG_OUT_HIGH       0x00020000
+#define GPIO_CFG_IN_NOPULL      0
+#define GPIO_CFG_IN_PU          0x00040000
+#define GPIO_CFG_IN_PD          0x00080000
+#define GPIO_CFG_IN_INT_NONE    0
+#define GPIO_CFG_IN_INT_RISING  0x00100000
+#define GPIO_CFG_IN_INT_FALLING 0x00200000
+
+#define GPIOMSP430_PORT(cfg)    (((cfg) >> 8) & 0xff)
+#define GPIOMSP430_BIT(cfg)     ((cfg) & 0xff)
+
+// port 1..4, J = 5
+#define GPIOMSP430_P(port, bit) (((port) << 8) | (1 << (bit)))
+#define GPIOMSP430_P1_0     GPIOMSP430_P(1, 0)
+#define GPIOMSP430_P1_1     GPIOMSP430_P(1, 1)
+#define GPIOMSP430_P1_2     GPIOMSP430_P(1, 2)
+#define GPIOMSP430_P1_3     GPIOMSP430_P(1, 3)
+#define GPIOMSP430_P1_4     GPIOMSP430_P(1, 4)
+#define GPIOMSP430_P1_5     GPIOMSP430_P(1, 5)
+#define GPIOMSP430_P2_0     GPIOMSP430_P(2, 0)
+#define GPIOMSP430_P2_1     GPIOMSP430_P(2, 1)
+#define GPIOMSP430_P2_4     GPIOMSP430_P(2, 4)
+#define GPIOMSP430_P2_7     GPIOMSP430_P(2, 7)
+#define GPIOMSP430_P3_0     GPIOMSP430_P(3, 0)
+#define GPIOMSP430_P3_1     GPIOMSP430_P(3, 1)
+#define GPIOMSP430_P3_2     GPIOMSP430_P(3, 2)
+#define GPIOMSP430_P3_3     GPIOMSP430_P(3, 3)
+#define GPIOMSP430_P3_4     GPIOMSP430_P(3, 4)
+#define GPIOMSP430_P3_5     GPIOMSP430_P(3, 5)
+#define GPIOMSP430_P3_6     GPIOMSP430_P(3, 6)
+#define GPIOMSP430_P3_7     GPIOMSP430_P(3, 7)
+#define GPIOMSP430_P4_0     GPIOMSP430_P(4, 0)
+#define GPIOMSP430_P4_1     GPIOMSP430_P(4, 1)
+#define GPIOMSP430_P4_2     GPIOMSP430_P(4, 2)
+#define GPIOMSP430_P4_3     GPIOMSP430_P(4, 3)
+#define GPIOMSP430_P4_4     GPIOMSP430_P(4, 4)
+#define GPIOMSP430_P4_5     GPIOMSP430_P(4, 5)
+#define GPIOMSP430_P4_6     GPIOMSP430_P(4, 6)
+#define GPIOMSP430_PJ_0     GPIOMSP430_P(5, 0)
+#define GPIOMSP430_PJ_1     GPIOMSP430_P(5, 1)
+#define GPIOMSP430_PJ_2     GPIOMSP430_P(5, 2)
+#define GPIOMSP430_PJ_3     GPIOMSP430_P(5, 3)
+#define GPIOMSP430_PJ_6     GPIOMSP430_P(5, 6)
+#define GPIOMSP430_PJ_7     GPIOMSP430_P(5, 7)
+
+// board pin table (as GPIOMSP430_Config on the target)
+typedef struct GPIOMSP430_Config {
+    GPIO_PinConfig *pinConfigs;
+    GPIO_CallbackFxn *callbacks;
+    unsigned int numberOfPinConfigs;
+    unsigned int numberOfCallbacks;
+} GPIOMSP430_Config;
+
+void GPIO_init(void);
+unsigned int GPIO_read(unsigned int index);
+void GPIO_write(unsigned int index, unsigned int value);
+void GPIO_toggle(unsigned int index);
+void GPIO_enableInt(unsigned int index);
+void GPIO_disableInt(unsigned int index);
+void GPIO_clearInt(unsigned int index);
+void GPIO_setCallback(unsigned int index, GPIO_CallbackFxn callback);
+
+#endif /* HOST_TI_DRIVERS_GPIO_H_ */
@@ -0,0 +1,69 @@
+/*
+ * ti/drivers/SPI.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Blocking SPI master; transfers go to the simulated device (host/platform/drivers.c).
+ */
+
+#ifndef HOST_TI_DRIVERS_SPI_H_
+#define HOST_TI_DRIVERS_SPI_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct SPI_Config *SPI_Handle;
+
+typedef enum SPI_Mode {
+    SPI_MASTER,
+    SPI_SLAVE
+} SPI_Mode;
+
+typedef enum SPI_TransferMode {
+    SPI_MODE_BLOCKING,
+    SPI_MODE_CALLBACK
+} SPI_TransferMode;
+
+typedef enum SPI_FrameFormat {
+    SPI_POL0_PHA0,
+    SPI_POL0_PHA1,
+    SPI_POL1_PHA0,
+    SPI_POL1_PHA1,
+    SPI_TI,
+    SPI_MW
+} SPI_FrameFormat;
+
+typedef struct SPI_Transaction {
+    size_t count;
+    void *txBuf;
+    void *rxBuf;
+    void *arg;
+} SPI_Transaction;
+
+typedef void (*SPI_CallbackFxn)(SPI_Handle handle, SPI_Transaction *transaction);
+
+typedef struct SPI_Params {
+    SPI_TransferMode transferMode;
+    uint32_t transferTimeout;
+    SPI_CallbackFxn transferCallbackFxn;
+    SPI_Mode mode;
+    uint32_t bitRate;
+    uint32_t dataSize;
+    SPI_FrameFormat frameFormat;
+} SPI_Params;
+
+typedef struct SPI_Config {
+    unsigned int index;
+    int open;
+    SPI_Params params;
+} SPI_Config;
+
+void SPI_init(void);
+void SPI_Params_init(SPI_Params *params);
+SPI_Handle SPI_open(unsigned int index, SPI_Params *params);
+void SPI_close(SPI_Handle handle);
+bool SPI_transfer(SPI_Handle handle, SPI_Transaction *transaction);
+
+#endif /* HOST_TI_DRIVERS_SPI_H_ */
@@ -0,0 +1,97 @@
+/*
+ * ti/drivers/UART.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  UART driver with the simulated devices on the other end (host/platform/drivers.c).
+ *  Writes block the calling task for the time on the wire.
+ */
+
+#ifndef HOST_TI_DRIVERS_UART_H_
+#define HOST_TI_DRIVERS_UART_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define UART_ERROR      (-1)
+#define UART_WAIT_FOREVER   (~((uint32_t)0))
+
+typedef struct UART_Config *UART_Handle;
+
+typedef void (*UART_Callback)(UART_Handle handle, void *buf, size_t count);
+
+typedef enum UART_Mode {
+    UART_MODE_BLOCKING,
+    UART_MODE_CALLBACK
+} UART_Mode;
+
+typedef enum UART_ReturnMode {
+    UART_RETURN_FULL,
+    UART_RETURN_NEWLINE
+} UART_ReturnMode;
+
+typedef enum UART_DataMode {
+    UART_DATA_BINARY,
+    UART_DATA_TEXT
+} UART_DataMode;
+
+typedef enum UART_Echo {
+    UART_ECHO_OFF,
+    UART_ECHO_ON
+} UART_Echo;
+
+typedef enum UART_LEN {
+    UART_LEN_5,
+    UART_LEN_6,
+    UART_LEN_7,
+    UART_LEN_8
+} UART_LEN;
+
+typedef enum UART_STOP {
+    UART_STOP_ONE,
+    UART_STOP_TWO
+} UART_STOP;
+
+typedef enum UART_PAR {
+    UART_PAR_NONE,
+    UART_PAR_EVEN,
+    UART_PAR_ODD
+} UART_PAR;
+
+typedef struct UART_Params {
+    UART_Mode readMode;
+    UART_Mode writeMode;
+    uint32_t readTimeout;
+    uint32_t writeTimeout;
+    UART_Callback readCallback;
+    UART_Callback writeCallback;
+    UART_ReturnMode readReturnMode;
+    UART_DataMode readDataMode;
+    UART_DataMode writeDataMode;
+    UART_Echo readEcho;
+    uint32_t baudRate;
+    UART_LEN dataLength;
+    UART_STOP stopBits;
+    UART_PAR parityType;
+} UART_Params;
+
+typedef struct UART_Config {
+    unsigned int index;
+    int open;
+    UART_Params params;
+    // pending read in callback mode
+    uint8_t *read_buf;
+    size_t read_size;
+    size_t read_count;
+} UART_Config;
+
+void UART_init(void);
+void UART_Params_init(UART_Params *params);
+UART_Handle UART_open(unsigned int index, UART_Params *params);
+void UART_close(UART_Handle handle);
+int UART_read(UART_Handle handle, void *buffer, size_t size);
+int UART_write(UART_Handle handle, const void *buffer, size_t size);
+void UART_readCancel(UART_Handle handle);
+
+#endif /* HOST_TI_DRIVERS_UART_H_ */
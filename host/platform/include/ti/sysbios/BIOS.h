@@ -0,0 +1,24 @@
+/*
+ * ti/sysbios/BIOS.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  BIOS_start() runs the virtual time scheduler (host/platform/kernel.c) and returns
+ *  when the simulation ends, unlike on the target.
+ */
+
+#ifndef HOST_TI_SYSBIOS_BIOS_H_
+#define HOST_TI_SYSBIOS_BIOS_H_
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+
+#define BIOS_WAIT_FOREVER   (~((UInt32)0))
+#define BIOS_NO_WAIT        ((UInt32)0)
+
+Void BIOS_start(void);
+Void BIOS_getCpuFreq(Types_FreqHz *freq);
+Void BIOS_setCpuFreq(Types_FreqHz *freq);
+
+#endif /* HOST_TI_SYSBIOS_BIOS_H_ */
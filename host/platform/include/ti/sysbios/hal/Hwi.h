@@ -0,0 +1,27 @@
+/*
+ * ti/sysbios/hal/Hwi.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Interrupts (device models) only run between tasks or from a driver call, never in the
+ *  middle of task code, so disabling them is a no-op.
+ */
+
+#ifndef HOST_TI_SYSBIOS_HAL_HWI_H_
+#define HOST_TI_SYSBIOS_HAL_HWI_H_
+
+#include <xdc/std.h>
+
+typedef struct Hwi_StackInfo {
+    size_t hwiStackPeak;
+    size_t hwiStackSize;
+    Ptr hwiStackBase;
+} Hwi_StackInfo;
+
+static inline UInt Hwi_disable(void) { return 0; }
+static inline Void Hwi_restore(UInt key) { (void)key; }
+
+Bool Hwi_getStackInfo(Hwi_StackInfo *stkInfo, Bool computeStackDepth);
+
+#endif /* HOST_TI_SYSBIOS_HAL_HWI_H_ */
@@ -0,0 +1,19 @@
+/*
+ * ti/sysbios/hal/Seconds.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  SecondsClock as configured in nestbox_rtos.cfg: counts Clock ticks, so it stands
+ *  still while the tick is stopped.
+ */
+
+#ifndef HOST_TI_SYSBIOS_HAL_SECONDS_H_
+#define HOST_TI_SYSBIOS_HAL_SECONDS_H_
+
+#include <xdc/std.h>
+
+UInt32 Seconds_get(void);
+Void Seconds_set(UInt32 seconds);
+
+#endif /* HOST_TI_SYSBIOS_HAL_SECONDS_H_ */
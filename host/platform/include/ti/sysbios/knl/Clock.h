@@ -0,0 +1,20 @@
+/*
+ * ti/sysbios/knl/Clock.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  1 ms tick in virtual time (Clock.tickPeriod = 1000 in nestbox_rtos.cfg).
+ */
+
+#ifndef HOST_TI_SYSBIOS_KNL_CLOCK_H_
+#define HOST_TI_SYSBIOS_KNL_CLOCK_H_
+
+#include <xdc/std.h>
+
+UInt32 Clock_getTicks(void);
+Void Clock_tickStop(void);
+Void Clock_tickStart(void);
+Bool Clock_tickReconfig(void);
+
+#endif /* HOST_TI_SYSBIOS_KNL_CLOCK_H_ */
@@ -0,0 +1,33 @@
+/*
+ * ti/sysbios/knl/Event.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef HOST_TI_SYSBIOS_KNL_EVENT_H_
+#define HOST_TI_SYSBIOS_KNL_EVENT_H_
+
+#include <xdc/std.h>
+
+#define Event_Id_NONE   0
+#define Event_Id_00     0x1
+#define Event_Id_01     0x2
+#define Event_Id_02     0x4
+#define Event_Id_03     0x8
+#define Event_Id_04     0x10
+#define Event_Id_05     0x20
+#define Event_Id_06     0x40
+#define Event_Id_07     0x80
+
+typedef struct Event_Object {
+    UInt posted;
+} Event_Object;
+
+typedef Event_Object *Event_Handle;
+
+// returns the consumed events: all of andMask or any of orMask; 0 on timeout
+UInt Event_pend(Event_Handle event, UInt andMask, UInt orMask, UInt32 timeout);
+Void Event_post(Event_Handle event, UInt eventMask);
+
+#endif /* HOST_TI_SYSBIOS_KNL_EVENT_H_ */
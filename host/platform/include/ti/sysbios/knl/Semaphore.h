@@ -0,0 +1,38 @@
+/*
+ * ti/sysbios/knl/Semaphore.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_
+#define HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+
+typedef enum Semaphore_Mode {
+    Semaphore_Mode_COUNTING,
+    Semaphore_Mode_BINARY
+} Semaphore_Mode;
+
+typedef struct Semaphore_Params {
+    Semaphore_Mode mode;
+} Semaphore_Params;
+
+typedef struct Semaphore_Object {
+    Int count;
+    Semaphore_Mode mode;
+} Semaphore_Object;
+
+typedef Semaphore_Object Semaphore_Struct;
+typedef Semaphore_Object *Semaphore_Handle;
+
+Void Semaphore_Params_init(Semaphore_Params *params);
+Semaphore_Handle Semaphore_create(Int count, const Semaphore_Params *params, Error_Block *eb);
+Bool Semaphore_pend(Semaphore_Handle sem, UInt32 timeout);
+Void Semaphore_post(Semaphore_Handle sem);
+Void Semaphore_reset(Semaphore_Handle sem, Int count);
+Int Semaphore_getCount(Semaphore_Handle sem);
+
+#endif /* HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_ */
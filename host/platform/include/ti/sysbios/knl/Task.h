@@ -0,0 +1,80 @@
+/*
+ * ti/sysbios/knl/Task.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Each task is a coroutine with its own host stack (host/platform/kernel.c):
+ *  priorities and preemption as in SYS/BIOS.
+ */
+
+#ifndef HOST_TI_SYSBIOS_KNL_TASK_H_
+#define HOST_TI_SYSBIOS_KNL_TASK_H_
+
+#include <ucontext.h>
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+#include <ti/sysbios/knl/Clock.h>
+
+typedef void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef enum Task_Mode {
+    Task_Mode_RUNNING,
+    Task_Mode_READY,
+    Task_Mode_BLOCKED,
+    Task_Mode_TERMINATED,
+    Task_Mode_INACTIVE
+} Task_Mode;
+
+typedef struct Task_Params {
+    UArg arg0;
+    UArg arg1;
+    Int priority;
+    Ptr stack;
+    size_t stackSize;
+    CString instance_name;
+} Task_Params;
+
+typedef struct Task_Stat {
+    Int priority;
+    Ptr stack;
+    size_t stackSize;
+    size_t used;
+    Task_Mode mode;
+} Task_Stat;
+
+typedef struct Task_Object {
+    Task_FuncPtr fxn;
+    UArg arg0;
+    UArg arg1;
+    Int priority;
+    size_t stackSize;
+    Task_Mode mode;
+    ucontext_t context;
+    void *host_stack;
+    uint32_t ready_seq;     // FIFO order within a priority
+    uint32_t pend_seq;      // FIFO order of the waiters of one object
+    void *pend_obj;         // Semaphore or Event the task waits for
+    UInt pend_and;
+    UInt pend_or;
+    UInt pend_events;       // Event_pend() result
+    int pend_timed;         // timeout is running
+    uint32_t pend_timeout;  // tick at which the wait ends
+    int pend_ok;
+    struct Task_Object *next;
+} Task_Object;
+
+typedef Task_Object Task_Struct;
+typedef Task_Object *Task_Handle;
+
+#define Task_handle(s)      ((Task_Handle)(s))
+
+Void Task_Params_init(Task_Params *params);
+Void Task_construct(Task_Struct *obj, Task_FuncPtr fxn, const Task_Params *params, Error_Block *eb);
+Task_Handle Task_create(Task_FuncPtr fxn, const Task_Params *params, Error_Block *eb);
+Void Task_sleep(UInt32 ticks);
+Void Task_yield(void);
+Task_Handle Task_self(void);
+Void Task_stat(Task_Handle task, Task_Stat *stat);
+
+#endif /* HOST_TI_SYSBIOS_KNL_TASK_H_ */
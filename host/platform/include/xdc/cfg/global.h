@@ -0,0 +1,30 @@
+/*
+ * xdc/cfg/global.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  The statically created objects of nestbox_rtos.cfg, defined in
+ *  host/platform/nestbox_rtos.c.
+ */
+
+#ifndef HOST_XDC_CFG_GLOBAL_H_
+#define HOST_XDC_CFG_GLOBAL_H_
+
+#include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/knl/Event.h>
+
+extern const Semaphore_Handle semReader;
+extern const Semaphore_Handle semButton;
+extern const Semaphore_Handle semPIRwakeup;
+extern const Semaphore_Handle semLB1;
+extern const Semaphore_Handle semLB2;
+extern const Semaphore_Handle semSerial;
+extern const Semaphore_Handle semSPI;
+extern const Semaphore_Handle semLoadCell;
+extern const Semaphore_Handle semSystemPause;
+extern const Semaphore_Handle semWifiRx;
+
+extern const Event_Handle evtService;
+
+#endif /* HOST_XDC_CFG_GLOBAL_H_ */
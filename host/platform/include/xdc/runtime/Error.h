@@ -0,0 +1,20 @@
+/*
+ * xdc/runtime/Error.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef HOST_XDC_RUNTIME_ERROR_H_
+#define HOST_XDC_RUNTIME_ERROR_H_
+
+#include <xdc/std.h>
+
+typedef struct Error_Block {
+    UInt16 id;
+} Error_Block;
+
+#define Error_init(eb)      do { (eb)->id = 0; } while(0)
+#define Error_check(eb)     ((eb) != NULL && (eb)->id != 0)
+
+#endif /* HOST_XDC_RUNTIME_ERROR_H_ */
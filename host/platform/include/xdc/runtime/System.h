@@ -0,0 +1,19 @@
+/*
+ * xdc/runtime/System.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef HOST_XDC_RUNTIME_SYSTEM_H_
+#define HOST_XDC_RUNTIME_SYSTEM_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <xdc/std.h>
+
+#define System_printf       printf
+#define System_flush()      fflush(stdout)
+#define System_abort(msg)   do { fprintf(stderr, "%s\n", msg); abort(); } while(0)
+
+#endif /* HOST_XDC_RUNTIME_SYSTEM_H_ */
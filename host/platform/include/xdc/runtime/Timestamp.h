@@ -0,0 +1,19 @@
+/*
+ * xdc/runtime/Timestamp.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Free running 32768 Hz time stamp (ACLK) in virtual time.
+ */
+
+#ifndef HOST_XDC_RUNTIME_TIMESTAMP_H_
+#define HOST_XDC_RUNTIME_TIMESTAMP_H_
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+
+UInt32 Timestamp_get32(void);
+Void Timestamp_getFreq(Types_FreqHz *freq);
+
+#endif /* HOST_XDC_RUNTIME_TIMESTAMP_H_ */
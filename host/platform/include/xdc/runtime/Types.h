@@ -0,0 +1,20 @@
+/*
+ * xdc/runtime/Types.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef HOST_XDC_RUNTIME_TYPES_H_
+#define HOST_XDC_RUNTIME_TYPES_H_
+
+#include <xdc/std.h>
+
+typedef struct xdc_runtime_Types_FreqHz {
+    UInt32 hi;
+    UInt32 lo;
+} xdc_runtime_Types_FreqHz;
+
+#define Types_FreqHz    xdc_runtime_Types_FreqHz
+
+#endif /* HOST_XDC_RUNTIME_TYPES_H_ */
@@ -0,0 +1,49 @@
+/*
+ * xdc/std.h (host)
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  XDCtools base types for the host build. Sizes follow the host compiler, not the
+ *  MSP430 (Int and UInt are 32 bit here).
+ */
+
+#ifndef HOST_XDC_STD_H_
+#define HOST_XDC_STD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef char            Char;
+typedef unsigned char   UChar;
+typedef short           Short;
+typedef unsigned short  UShort;
+typedef int             Int;
+typedef unsigned int    UInt;
+typedef long            Long;
+typedef unsigned long   ULong;
+typedef int8_t          Int8;
+typedef uint8_t         UInt8;
+typedef int16_t         Int16;
+typedef uint16_t        UInt16;
+typedef int32_t         Int32;
+typedef uint32_t        UInt32;
+typedef float           Float;
+typedef double          Double;
+typedef unsigned short  Bool;
+typedef void            Void;
+typedef void           *Ptr;
+typedef const char     *String;
+typedef const char     *CString;
+typedef uintptr_t       UArg;
+typedef void          (*Fxn)(void);
+
+#ifndef TRUE
+#define TRUE    1
+#endif
+#ifndef FALSE
+#define FALSE   0
+#endif
+
+#endif /* HOST_XDC_STD_H_ */
@@ -0,0 +1,661 @@
+/*
+ * kernel.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  SYS/BIOS on the host: Task, Semaphore, Event, Clock, Seconds and Timestamp in virtual
+ *  time, plus the event queue of the device models (sim.h).
+ *
+ *  Every task is a coroutine (ucontext) on its own host stack, so only one of them
+ *  executes at a time (current). The context that calls BIOS_start() becomes the
+ *  scheduler: it switches to the ready task of highest priority (FIFO within a
+ *  priority) and gets control back when that task blocks. When no task is ready, it runs
+ *  the idle functions once, then advances the virtual time to the next tick or model
+ *  event. Model events run on the scheduler context, i.e. in interrupt context.
+ *
+ *  With fast forward (the default), the ticks in between that wake up no task are
+ *  counted in one step: the time jumps to the next model event or task timeout. The
+ *  firmware sees the same tick counts at the same times as with every tick simulated.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/knl/Event.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/hal/Seconds.h>
+#include <xdc/runtime/Timestamp.h>
+
+#include "sim.h"
+#include "host.h"
+
+#define MAX_TASKS       16
+#define TIMESTAMP_FREQ  32768   // ACLK
+#define HOST_STACK_SIZE (256 * 1024) // the target stack sizes are far too small for host code
+
+struct sim_event {
+    uint64_t time;
+    sim_fxn fxn;
+    void *arg;
+    struct sim_event *next;
+};
+
+// idle functions of nestbox_rtos.cfg (nestbox_rtos.c)
+extern void (*const host_idle_fxns[])(void);
+
+static ucontext_t scheduler;
+
+static Task_Object *tasks[MAX_TASKS];
+static unsigned int n_tasks = 0;
+static Task_Object *current = NULL;
+static uint32_t ready_seq = 0;
+static uint32_t pend_seq = 0;
+
+static struct sim_event *events = NULL;
+static uint64_t now_us = 0;
+static uint64_t end_us = UINT64_MAX;
+static int stop = 0;
+static const char *halt_reason = NULL;
+
+static uint32_t ticks = 0;
+static int tick_running = 1;
+static uint64_t tick_stopped_us = 0;    // finished periods with the tick stopped
+static uint64_t tick_stopped_since;
+static uint64_t next_tick_us = SIM_US_PER_TICK;
+static int fast_forward = 1;
+
+static uint32_t seconds_base = 0;
+static uint32_t seconds_tick = 0;
+
+static uint32_t idle_count = 0;
+static int bios_started = 0;
+
+static void kernel_error(const char *msg)
+{
+    fprintf(stderr, "sim: %s\n", msg);
+    abort();
+}
+
+static int in_task()
+{
+    return current != NULL;
+}
+
+/* ======== scheduling ======== */
+
+static void make_ready(Task_Object *t)
+{
+    t->mode = Task_Mode_READY;
+    t->ready_seq = ready_seq++;
+    t->pend_obj = NULL;
+    t->pend_timed = 0;
+}
+
+static Task_Object *pick_ready()
+{
+    Task_Object *best = NULL;
+    unsigned int i;
+
+    for(i = 0; i < n_tasks; i++)
+    {
+        Task_Object *t = tasks[i];
+        if(t->mode != Task_Mode_READY)
+            continue;
+        if(best == NULL || t->priority > best->priority ||
+           (t->priority == best->priority && t->ready_seq < best->ready_seq))
+            best = t;
+    }
+    return best;
+}
+
+// back to the scheduler; returns when the task runs again
+static void switch_out(Task_Object *self)
+{
+    current = NULL;
+    swapcontext(&self->context, &scheduler);
+}
+
+// a post from task context made a task of higher priority ready
+static void preempt_check()
+{
+    Task_Object *t;
+
+    if(!in_task())
+        return;
+    t = pick_ready();
+    if(t != NULL && t->priority > current->priority)
+    {
+        Task_Object *self = current;
+        self->mode = Task_Mode_READY; // keeps its ready_seq: first of its priority
+        switch_out(self);
+    }
+}
+
+static void block(Task_Object *self, void *obj, UInt32 timeout)
+{
+    self->mode = Task_Mode_BLOCKED;
+    self->pend_obj = obj;
+    self->pend_ok = 0;
+    self->pend_seq = pend_seq++;
+    self->pend_timed = (timeout != BIOS_WAIT_FOREVER);
+    self->pend_timeout = ticks + timeout;
+    switch_out(self);
+}
+
+static void run_task(Task_Object *t)
+{
+    current = t;
+    t->mode = Task_Mode_RUNNING;
+    swapcontext(&scheduler, &t->context);
+    host_hw_poll();
+}
+
+// makecontext() passes int arguments only
+static void task_entry(int index)
+{
+    Task_Object *self = tasks[index];
+
+    self->fxn(self->arg0, self->arg1);
+
+    self->mode = Task_Mode_TERMINATED;
+    current = NULL;
+    // uc_link: back to the scheduler
+}
+
+/* ======== Task ======== */
+
+Void Task_Params_init(Task_Params *params)
+{
+    memset(params, 0, sizeof(*params));
+    params->priority = 1;
+    params->stackSize = 1024;
+}
+
+Void Task_construct(Task_Struct *obj, Task_FuncPtr fxn, const Task_Params *params, Error_Block *eb)
+{
+    Task_Params defaults;
+    (void)eb;
+
+    if(params == NULL)
+    {
+        Task_Params_init(&defaults);
+        params = &defaults;
+    }
+    if(n_tasks >= MAX_TASKS)
+        kernel_error("too many tasks");
+
+    memset(obj, 0, sizeof(*obj));
+    obj->fxn = fxn;
+    obj->arg0 = params->arg0;
+    obj->arg1 = params->arg1;
+    obj->priority = params->priority;
+    obj->stackSize = params->stackSize;
+    obj->host_stack = malloc(HOST_STACK_SIZE);
+    if(obj->host_stack == NULL || getcontext(&obj->context) != 0)
+        kernel_error("task context");
+    obj->context.uc_stack.ss_sp = obj->host_stack;
+    obj->context.uc_stack.ss_size = HOST_STACK_SIZE;
+    obj->context.uc_link = &scheduler;
+    makecontext(&obj->context, (void (*)(void))task_entry, 1, (int)n_tasks);
+    make_ready(obj);
+    tasks[n_tasks++] = obj;
+    preempt_check();
+}
+
+Task_Handle Task_create(Task_FuncPtr fxn, const Task_Params *params, Error_Block *eb)
+{
+    Task_Object *obj = malloc(sizeof(*obj));
+    if(obj == NULL)
+        kernel_error("out of memory");
+    Task_construct(obj, fxn, params, eb);
+    return obj;
+}
+
+Void Task_sleep(UInt32 nticks)
+{
+    if(!in_task())
+        kernel_error("Task_sleep outside of a task");
+    if(nticks == 0)
+    {
+        Task_yield();
+        return;
+    }
+    block(current, NULL, nticks);
+}
+
+Void Task_yield()
+{
+    Task_Object *self = current;
+
+    if(!in_task())
+        return;
+    make_ready(self);
+    switch_out(self);
+}
+
+Task_Handle Task_self()
+{
+    return in_task() ? current : NULL;
+}
+
+Void Task_stat(Task_Handle task, Task_Stat *stat)
+{
+    stat->priority = task->priority;
+    stat->stack = NULL;
+    stat->stackSize = task->stackSize;
+    stat->used = 0; // the host stacks say nothing about the target
+    stat->mode = task->mode;
+}
+
+/* ======== Semaphore ======== */
+
+Void Semaphore_Params_init(Semaphore_Params *params)
+{
+    params->mode = Semaphore_Mode_COUNTING;
+}
+
+Semaphore_Handle Semaphore_create(Int count, const Semaphore_Params *params, Error_Block *eb)
+{
+    Semaphore_Object *sem = malloc(sizeof(*sem));
+    (void)eb;
+
+    if(sem == NULL)
+        kernel_error("out of memory");
+    sem->mode = params != NULL ? params->mode : Semaphore_Mode_COUNTING;
+    sem->count = (sem->mode == Semaphore_Mode_BINARY && count > 1) ? 1 : count;
+    return sem;
+}
+
+// first waiter on the object
+static Task_Object *first_waiter(void *obj)
+{
+    Task_Object *first = NULL;
+    unsigned int i;
+
+    for(i = 0; i < n_tasks; i++)
+    {
+        Task_Object *t = tasks[i];
+        if(t->mode == Task_Mode_BLOCKED && t->pend_obj == obj &&
+           (first == NULL || t->pend_seq < first->pend_seq))
+            first = t;
+    }
+    return first;
+}
+
+Bool Semaphore_pend(Semaphore_Handle sem, UInt32 timeout)
+{
+    Task_Object *self = current;
+
+    if(sem->count > 0)
+    {
+        sem->count--;
+        return TRUE;
+    }
+    if(timeout == BIOS_NO_WAIT)
+        return FALSE;
+    if(!in_task())
+        kernel_error("blocking Semaphore_pend outside of a task");
+
+    block(self, sem, timeout);
+    return self->pend_ok ? TRUE : FALSE;
+}
+
+Void Semaphore_post(Semaphore_Handle sem)
+{
+    Task_Object *t = first_waiter(sem);
+
+    if(t != NULL)
+    {
+        make_ready(t);
+        t->pend_ok = 1;
+        preempt_check();
+        return;
+    }
+    if(sem->mode == Semaphore_Mode_BINARY)
+        sem->count = 1;
+    else
+        sem->count++;
+}
+
+Void Semaphore_reset(Semaphore_Handle sem, Int count)
+{
+    sem->count = count;
+}
+
+Int Semaphore_getCount(Semaphore_Handle sem)
+{
+    return sem->count;
+}
+
+/* ======== Event ======== */
+
+static UInt event_match(Event_Handle event, UInt andMask, UInt orMask)
+{
+    if(andMask != 0 && (event->posted & andMask) == andMask)
+        return andMask | (event->posted & orMask);
+    return event->posted & orMask;
+}
+
+UInt Event_pend(Event_Handle event, UInt andMask, UInt orMask, UInt32 timeout)
+{
+    Task_Object *self = current;
+    UInt matched = event_match(event, andMask, orMask);
+
+    if(matched != 0)
+    {
+        event->posted &= ~matched;
+        return matched;
+    }
+    if(timeout == BIOS_NO_WAIT)
+        return 0;
+    if(!in_task())
+        kernel_error("blocking Event_pend outside of a task");
+
+    self->pend_and = andMask;
+    self->pend_or = orMask;
+    self->pend_events = 0;
+    block(self, event, timeout);
+    return self->pend_events;
+}
+
+Void Event_post(Event_Handle event, UInt eventMask)
+{
+    Task_Object *t = first_waiter(event);
+
+    event->posted |= eventMask;
+    if(t != NULL)
+    {
+        UInt matched = event_match(event, t->pend_and, t->pend_or);
+        if(matched != 0)
+        {
+            event->posted &= ~matched;
+            make_ready(t);
+            t->pend_ok = 1;
+            t->pend_events = matched;
+            preempt_check();
+        }
+    }
+}
+
+/* ======== Clock, Seconds, Timestamp ======== */
+
+UInt32 Clock_getTicks()
+{
+    return ticks;
+}
+
+Void Clock_tickStop()
+{
+    if(tick_running)
+        tick_stopped_since = now_us;
+    tick_running = 0;
+}
+
+Void Clock_tickStart()
+{
+    if(!tick_running)
+    {
+        tick_stopped_us += now_us - tick_stopped_since;
+        tick_running = 1;
+        next_tick_us = now_us + SIM_US_PER_TICK;
+    }
+}
+
+Bool Clock_tickReconfig()
+{
+    return TRUE;
+}
+
+UInt32 Seconds_get()
+{
+    return seconds_base + (ticks - seconds_tick) / 1000;
+}
+
+Void Seconds_set(UInt32 seconds)
+{
+    seconds_base = seconds;
+    seconds_tick = ticks;
+}
+
+UInt32 Timestamp_get32()
+{
+    return (UInt32)(now_us * TIMESTAMP_FREQ / SIM_US_PER_SEC);
+}
+
+Void Timestamp_getFreq(Types_FreqHz *freq)
+{
+    freq->hi = 0;
+    freq->lo = TIMESTAMP_FREQ;
+}
+
+Bool Hwi_getStackInfo(Hwi_StackInfo *info, Bool computeStackDepth)
+{
+    (void)computeStackDepth;
+    memset(info, 0, sizeof(*info));
+    return FALSE;
+}
+
+/* ======== BIOS ======== */
+
+static Types_FreqHz cpu_freq = { 0, 8000000 };
+
+Void BIOS_getCpuFreq(Types_FreqHz *freq)
+{
+    *freq = cpu_freq;
+}
+
+Void BIOS_setCpuFreq(Types_FreqHz *freq)
+{
+    cpu_freq = *freq;
+}
+
+/* ======== virtual time ======== */
+
+uint64_t sim_time_us()
+{
+    return now_us;
+}
+
+uint32_t sim_idle_count()
+{
+    return idle_count;
+}
+
+uint64_t sim_tick_stopped_us()
+{
+    if(!tick_running)
+        return tick_stopped_us + now_us - tick_stopped_since;
+    return tick_stopped_us;
+}
+
+void sim_at(uint64_t time_us, sim_fxn fxn, void *arg)
+{
+    struct sim_event *e = malloc(sizeof(*e));
+    struct sim_event **p = &events;
+
+    if(e == NULL)
+        kernel_error("out of memory");
+    if(time_us < now_us)
+        time_us = now_us;
+    e->time = time_us;
+    e->fxn = fxn;
+    e->arg = arg;
+    while(*p != NULL && (*p)->time <= time_us)
+        p = &(*p)->next;
+    e->next = *p;
+    *p = e;
+}
+
+void sim_after(uint64_t delay_us, sim_fxn fxn, void *arg)
+{
+    sim_at(now_us + delay_us, fxn, arg);
+}
+
+void sim_set_fast_forward(int on)
+{
+    fast_forward = on;
+}
+
+void sim_set_end(uint64_t time_us)
+{
+    end_us = time_us;
+}
+
+void sim_stop()
+{
+    stop = 1;
+}
+
+void sim_halt(const char *reason)
+{
+    if(halt_reason == NULL)
+        halt_reason = reason;
+    stop = 1;
+    if(in_task())
+    {
+        // the CPU is off: this task never runs again
+        Task_Object *self = current;
+        self->mode = Task_Mode_INACTIVE;
+        switch_out(self);
+    }
+}
+
+const char *sim_halt_reason()
+{
+    return halt_reason;
+}
+
+static void wait_done(void *arg)
+{
+    make_ready(arg);
+}
+
+void sim_task_wait_us(uint64_t us)
+{
+    Task_Object *self = current;
+
+    if(!in_task() || !bios_started)
+        return;
+    sim_after(us, wait_done, self);
+    self->mode = Task_Mode_BLOCKED;
+    self->pend_obj = NULL;
+    self->pend_timed = 0;
+    switch_out(self);
+}
+
+void sim_isr_exit()
+{
+    preempt_check();
+}
+
+// the ticks up to and including the one at time_us (>= next_tick_us) with their timeouts
+static void tick_until(uint64_t time_us)
+{
+    uint32_t n = (uint32_t)((time_us - next_tick_us) / SIM_US_PER_TICK) + 1;
+    uint32_t from = ticks;
+    unsigned int i;
+
+    ticks += n;
+    next_tick_us += (uint64_t)n * SIM_US_PER_TICK;
+    for(i = 0; i < n_tasks; i++)
+    {
+        Task_Object *t = tasks[i];
+        if(t->mode == Task_Mode_BLOCKED && t->pend_timed && t->pend_timeout - from <= n)
+            make_ready(t); // pend_ok stays 0: timeout
+    }
+}
+
+// time of the tick at which the first timeout expires, UINT64_MAX if no task waits for one
+static uint64_t next_timeout_us()
+{
+    uint32_t first = 0;
+    unsigned int i;
+
+    for(i = 0; i < n_tasks; i++)
+    {
+        Task_Object *t = tasks[i];
+        if(t->mode == Task_Mode_BLOCKED && t->pend_timed &&
+           (first == 0 || t->pend_timeout - ticks < first))
+            first = t->pend_timeout - ticks;
+    }
+    if(first == 0)
+        return UINT64_MAX;
+    return next_tick_us + (uint64_t)(first - 1) * SIM_US_PER_TICK;
+}
+
+static void run_events()
+{
+    while(events != NULL && events->time <= now_us && !stop)
+    {
+        struct sim_event *e = events;
+        events = e->next;
+        e->fxn(e->arg);
+        free(e);
+        host_hw_poll();
+    }
+}
+
+Void BIOS_start()
+{
+    int active = 1;
+
+    bios_started = 1;
+    if(tick_running)
+        next_tick_us = now_us + SIM_US_PER_TICK;
+
+    while(!stop)
+    {
+        Task_Object *t = pick_ready();
+        uint64_t next;
+
+        if(t != NULL)
+        {
+            run_task(t);
+            active = 1;
+            continue;
+        }
+        if(active)
+        {
+            // back to low power mode
+            unsigned int i;
+            for(i = 0; host_idle_fxns[i] != NULL; i++)
+                host_idle_fxns[i]();
+            idle_count++;
+            active = 0;
+            continue;
+        }
+
+        if(events == NULL && !tick_running)
+        {
+            sim_halt("nothing left to wake up the CPU");
+            break;
+        }
+        next = events != NULL ? events->time : UINT64_MAX;
+        if(tick_running)
+        {
+            uint64_t tick_us = fast_forward ? next_timeout_us() : next_tick_us;
+            if(tick_us < next)
+                next = tick_us;
+        }
+        if(next > end_us)
+        {
+            if(tick_running && end_us >= next_tick_us)
+                tick_until(end_us);
+            now_us = end_us;
+            break;
+        }
+
+        now_us = next;
+        if(tick_running && now_us >= next_tick_us)
+            tick_until(now_us);
+        run_events();
+    }
+    bios_started = 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * log_unpack.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  A compressed flush is the 'H' line followed by 'Z' blocks:
+ *
+ *    Z,<log bytes>,<LZSS bytes>\n  then the LZSS bytes (fw/lzss.c), or the log bytes
+ *                                  themselves if <LZSS bytes> is 0
+ *
+ *  The blocks of one flush are joined (a block may end within an entry) and printed the
+ *  way log_send_data_via_uart() prints the entries from FRAM.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_unpack.h"
+#include "lzss.h"
+
+#define LOG_SHORT_LEN       8
+#define LOG_LONG_LEN        12
+#define MAX_BLOCK           4096
+
+static uint32_t get32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static int is_long_entry(uint8_t logchar)
+{
+    return strchr("XOSARWGVo", logchar) != NULL && logchar != '\0';
+}
+
+static size_t append(char **text, size_t len, const char *s, size_t n)
+{
+    *text = realloc(*text, len + n + 1);
+    if(*text == NULL)
+        abort();
+    memcpy(*text + len, s, n);
+    (*text)[len + n] = '\0';
+    return len + n;
+}
+
+size_t log_format_entries(const uint8_t *log, size_t n, char **text, size_t len)
+{
+    size_t i = 0;
+
+    while(i < n)
+    {
+        const uint8_t *e = &log[i];
+        char line[64];
+        int k;
+
+        if(n - i < LOG_SHORT_LEN || (is_long_entry(e[4]) && n - i < LOG_LONG_LEN))
+            return 0;
+
+        // the layout of logger.c: time (32 bit), logchar, then the values in 16 bit words
+        if(e[4] == 'R')
+            k = snprintf(line, sizeof(line), "R,%lu,%X%08lX\n", (unsigned long)get32(e),
+                         e[6], (unsigned long)get32(&e[8]));
+        else if(is_long_entry(e[4]))
+            k = snprintf(line, sizeof(line), "%c,%lu,%lu,%u\n", e[4], (unsigned long)get32(e),
+                         (unsigned long)get32(&e[8]), get16(&e[6]));
+        else if(e[4] == 'D')
+            k = snprintf(line, sizeof(line), "D,%lu,%lu\n", (unsigned long)get32(e),
+                         (unsigned long)get16(&e[6]) << 8);
+        else
+            k = snprintf(line, sizeof(line), "%c,%lu,%u\n", e[4], (unsigned long)get32(e), get16(&e[6]));
+
+        len = append(text, len, line, k);
+        i += is_long_entry(e[4]) ? LOG_LONG_LEN : LOG_SHORT_LEN;
+    }
+    return len;
+}
+
+char *log_unpack(const uint8_t *data, size_t n, size_t *text_len)
+{
+    static uint8_t block[MAX_BLOCK];
+    uint8_t *log = NULL;
+    size_t log_len = 0;
+    char *text = NULL;
+    size_t len = append(&text, 0, "", 0);
+    size_t i = 0;
+
+    while(i < n)
+    {
+        const uint8_t *eol = memchr(&data[i], '\n', n - i);
+        size_t line_len = eol != NULL ? (size_t)(eol - &data[i]) + 1 : n - i;
+        unsigned int raw, packed;
+        char head[32];
+
+        memcpy(head, &data[i], line_len < sizeof(head) - 1 ? line_len : sizeof(head) - 1);
+        head[line_len < sizeof(head) - 1 ? line_len : sizeof(head) - 1] = '\0';
+
+        if(eol != NULL && sscanf(head, "Z,%u,%u\n", &raw, &packed) == 2)
+        {
+            size_t stored = packed > 0 ? packed : raw;
+
+            i += line_len;
+            if(raw == 0 || raw > MAX_BLOCK || stored > n - i)
+                goto corrupt;
+            if(packed > 0)
+            {
+                if(lzss_decompress(&data[i], packed, block, raw) != raw)
+                    goto corrupt;
+            }
+            else
+                memcpy(block, &data[i], raw);
+            i += stored;
+
+            log = realloc(log, log_len + raw);
+            if(log == NULL)
+                abort();
+            memcpy(log + log_len, block, raw);
+            log_len += raw;
+            continue;
+        }
+
+        // the end of the blocks of a flush
+        if(log_len > 0)
+        {
+            if((len = log_format_entries(log, log_len, &text, len)) == 0)
+                goto corrupt;
+            log_len = 0;
+        }
+        len = append(&text, len, (const char *)&data[i], line_len);
+        i += line_len;
+    }
+    if(log_len > 0 && (len = log_format_entries(log, log_len, &text, len)) == 0)
+        goto corrupt;
+
+    free(log);
+    *text_len = len;
+    return text;
+
+corrupt:
+    free(log);
+    free(text);
+    return NULL;
+}
@@ -0,0 +1,26 @@
+/*
+ * log_unpack.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Decoder of the SD card content: the 'Z' blocks of a compressed log flush
+ *  (PARAM_SD_COMPRESS, fw/logger.c) become the text lines the firmware prints without
+ *  compression, all other lines are kept as they are.
+ */
+
+#ifndef HOST_LOG_UNPACK_H_
+#define HOST_LOG_UNPACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// returns the text (malloc'ed, NUL terminated) and its length in *text_len, NULL if a
+// block is corrupt or cut off
+char *log_unpack(const uint8_t *data, size_t n, size_t *text_len);
+
+// text lines of n log bytes as they are in FRAM (whole entries), appended to text;
+// returns the new length of text, 0 if the bytes do not end with a whole entry
+size_t log_format_entries(const uint8_t *log, size_t n, char **text, size_t len);
+
+#endif /* HOST_LOG_UNPACK_H_ */
@@ -0,0 +1,78 @@
+/*
+ * models.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Models of the devices around the MCU, for the host simulation (sim.h).
+ */
+
+#ifndef HOST_MODELS_H_
+#define HOST_MODELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* SD logger (OpenLog) on the debug UART, powered by nbox_sdcard_enable_n low: sends its
+ * "12<" prompt after booting and stores what it receives at its baud rate. */
+void sd_logger_attach(uint32_t baud);
+// everything stored since power up of the simulation
+const char *sd_logger_data(size_t *n);
+// power ups, and bytes lost to a wrong baud rate
+unsigned int sd_logger_sessions(void);
+size_t sd_logger_garbled(void);
+
+/* EM4100 tag in front of the EM4095 reader: while the reader is powered (nbox_5v_enable)
+ * and a tag is in range, its frame is captured by TB0 (Timer0_B1_ISR()). */
+void em4100_tag_attach(void);
+void em4100_tag_enter(uint64_t id);
+void em4100_tag_leave(void);
+
+/* ADS1220 load cell ADC on SPI 0 with DRDY, powered by nbox_loadcell_ldo_enable. The
+ * signals give the load on the perch (g) and the temperature (degC) at a time; NULL: an
+ * empty perch at 20 degC. */
+typedef double (*sim_signal_fxn)(uint64_t time_us);
+void ads1220_sim_attach(sim_signal_fxn grams, sim_signal_fxn temperature);
+// zero offset change of the bridge in ADC counts per degC (at gain 128), 0 by default
+void ads1220_sim_set_offset_drift(double counts_per_degc);
+// total time spent converting (single shot or continuous)
+uint64_t ads1220_sim_converting_us(void);
+
+/* Supply current of the board: a current per power state, integrated over the time the
+ * firmware spent in it since power up (no events, read at any time). The states are
+ * taken from the pins, the UARTs, the tick and the ADS1220 model. */
+enum power_state {
+    POWER_BASE = 0,         // MCU in LPM3 with the tick running, regulators, sensors idle
+    POWER_PAUSE,            // tick stopped until the RTC alarm (instead of POWER_BASE)
+    POWER_CPU,              // CPU active: per task wake up and per tick interrupt
+    POWER_5V,               // 5 V rail (nbox_5v_enable): RFID reader
+    POWER_LOADCELL_LDO,     // nbox_loadcell_ldo_enable, ADS1220 powered down
+    POWER_ADS_CONVERTING,   // ADS1220 converting, bridge excited
+    POWER_SD_CARD,          // nbox_sdcard_enable_n low
+    POWER_DEBUG_UART,       // debug UART open (SMCLK keeps running)
+    POWER_WIFI,             // wifi UART open: ESP module on
+    POWER_LEDS,             // per LED on
+    POWER_VBAT_TEST,        // battery voltage divider
+    POWER_STATE_COUNT
+};
+
+struct power_model {
+    double ua[POWER_STATE_COUNT];   // POWER_CPU: on top of POWER_BASE while active
+    double wakeup_us;               // CPU active per task wake up
+    double tick_us;                 // CPU active per tick interrupt
+    double battery_mah;
+};
+
+// estimates of the hardware (as in fw/energy.c); replace them with measurements
+extern const struct power_model power_model_default;
+
+// time in each state and the charge drawn since power up
+struct power_report {
+    uint64_t elapsed_us;
+    uint64_t us[POWER_STATE_COUNT];
+    double uah[POWER_STATE_COUNT];
+    double total_uah;
+};
+void power_sim_report(const struct power_model *model, struct power_report *report);
+
+#endif /* HOST_MODELS_H_ */
@@ -0,0 +1,210 @@
+/*
+ * msp430_regs.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  MSP430FR5969 registers and the models of the peripherals the firmware drives through
+ *  them directly: the RTC (calendar, alarm), the ADC12 (battery voltage) and the low power
+ *  modes. The RTC registers hold what rtc_set_clock() writes: on the host, time_t counts
+ *  from 1970, so the calendar runs 70 years ahead, like the firmware's own conversion.
+ */
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <msp430.h>
+
+#include "sim.h"
+#include "host.h"
+#include "nestbox_init.h"
+#include "fw/battery_monitor.h"
+
+#define RTC_EPOCH_OFFSET    2208988800ULL   // rtc.c
+#define ADC_CONVERSION_US   10              // sample and hold plus 12 bit conversion
+#define ADC_VREF_MV         2500
+#define VBAT_DIVIDER_NUM    47              // 82k over 47k
+#define VBAT_DIVIDER_DEN    (82 + 47)
+
+void rtc_isr(void);
+
+volatile uint8_t P1IN, P1OUT, P1DIR, P1REN, P1SEL0, P1SEL1, P1IES, P1IE, P1IFG;
+volatile uint8_t P2IN, P2OUT, P2DIR, P2REN, P2SEL0, P2SEL1, P2IES, P2IE, P2IFG;
+volatile uint8_t P3IN, P3OUT, P3DIR, P3REN, P3SEL0, P3SEL1, P3IES, P3IE, P3IFG;
+volatile uint8_t P4IN, P4OUT, P4DIR, P4REN, P4SEL0, P4SEL1, P4IES, P4IE, P4IFG;
+volatile uint8_t PJIN, PJOUT, PJDIR, PJREN, PJSEL0, PJSEL1;
+
+volatile uint16_t PMMCTL0, PMMIFG, PM5CTL0, SYSRSTIV;
+volatile uint16_t CSCTL0, CSCTL1, CSCTL2, CSCTL3, CSCTL4, CSCTL5, CSCTL6;
+volatile uint16_t REFCTL0;
+volatile uint16_t ADC12CTL0, ADC12CTL1, ADC12CTL2, ADC12CTL3;
+volatile uint16_t ADC12MCTL0, ADC12MEM0;
+volatile uint16_t ADC12IER0, ADC12IFGR0, ADC12IV;
+volatile uint16_t TA0CTL, TA1CTL, TA2CTL, TA3CTL;
+volatile uint16_t TB0CTL, TB0EX0, TB0CCTL2, TB0CCR2, TB0IV, TB0R;
+volatile uint16_t RTCCTL01, RTCCTL23, RTCIV, RTCYEAR;
+volatile uint8_t RTCSEC, RTCMIN, RTCHOUR, RTCDOW, RTCDAY, RTCMON;
+volatile uint8_t RTCAMIN, RTCAHOUR, RTCADOW, RTCADAY;
+
+static uint32_t start_unix = 0;
+static uint16_t vbat_mv = 5000;
+static int adc_busy = 0;
+
+/* ======== RTC ======== */
+
+static void rtc_write(time_t t)
+{
+    struct tm tm;
+
+    gmtime_r(&t, &tm);
+    RTCYEAR = tm.tm_year + 1900;
+    RTCMON = tm.tm_mon + 1;
+    RTCDAY = tm.tm_mday;
+    RTCDOW = tm.tm_wday;
+    RTCHOUR = tm.tm_hour;
+    RTCMIN = tm.tm_min;
+    RTCSEC = tm.tm_sec;
+}
+
+static time_t rtc_read()
+{
+    struct tm tm = { 0 };
+
+    tm.tm_year = RTCYEAR - 1900;
+    tm.tm_mon = RTCMON - 1;
+    tm.tm_mday = RTCDAY;
+    tm.tm_hour = RTCHOUR;
+    tm.tm_min = RTCMIN;
+    tm.tm_sec = RTCSEC;
+    return timegm(&tm);
+}
+
+// enabled alarm registers (RTCAE) all match; none enabled: no alarm
+static int rtc_alarm_match()
+{
+    int enabled = 0;
+
+    if(RTCAMIN & RTCAE)
+    {
+        enabled = 1;
+        if((RTCAMIN & ~RTCAE) != RTCMIN)
+            return 0;
+    }
+    if(RTCAHOUR & RTCAE)
+    {
+        enabled = 1;
+        if((RTCAHOUR & ~RTCAE) != RTCHOUR)
+            return 0;
+    }
+    if(RTCADOW & RTCAE)
+    {
+        enabled = 1;
+        if((RTCADOW & ~RTCAE) != RTCDOW)
+            return 0;
+    }
+    if(RTCADAY & RTCAE)
+    {
+        enabled = 1;
+        if((RTCADAY & ~RTCAE) != RTCDAY)
+            return 0;
+    }
+    return enabled;
+}
+
+// the 32768 Hz crystal: one second, independent of the CPU
+static void rtc_second(void *arg)
+{
+    (void)arg;
+    sim_after(SIM_US_PER_SEC, rtc_second, NULL);
+
+    if(RTCCTL01 & RTCHOLD)
+        return;
+    rtc_write(rtc_read() + 1);
+
+    if(RTCSEC == 0 && rtc_alarm_match())
+    {
+        RTCCTL01 |= RTCAIFG;
+        if(RTCCTL01 & RTCAIE)
+        {
+            RTCIV = RTCIV_RTCAIFG;
+            rtc_isr();
+            // reading RTCIV cleared the flag
+            RTCIV = RTCIV_NONE;
+            RTCCTL01 &= ~RTCAIFG;
+        }
+    }
+}
+
+uint32_t sim_unix_time()
+{
+    return start_unix + (uint32_t)(sim_time_us() / SIM_US_PER_SEC);
+}
+
+/* ======== ADC12 ======== */
+
+static void adc_conversion_done(void *arg)
+{
+    uint32_t mv = 0;
+    (void)arg;
+
+    adc_busy = 0;
+    if(!(ADC12CTL0 & ADC12ON))
+        return;
+
+    // A6 sees the battery through the divider only while the test switch is on
+    if(sim_gpio_get_output(nbox_vbat_test_enable))
+        mv = (uint32_t)vbat_mv * VBAT_DIVIDER_NUM / VBAT_DIVIDER_DEN;
+    if(mv > ADC_VREF_MV)
+        mv = ADC_VREF_MV;
+    ADC12MEM0 = (uint16_t)(mv * 4095 / ADC_VREF_MV);
+    ADC12IFGR0 |= ADC12IFG0;
+    if(ADC12IER0 & ADC12IE0)
+    {
+        ADC12IFGR0 &= ~ADC12IFG0;
+        ADC_ISR();
+    }
+}
+
+void sim_set_battery_mv(uint16_t mv)
+{
+    vbat_mv = mv;
+}
+
+/* ======== low power modes ======== */
+
+void host_bis_SR_register(uint16_t bits)
+{
+    if((bits & LPM3_bits) == LPM3_bits && (PMMCTL0 & PMMREGOFF))
+        sim_halt("LPM3.5");
+    else if((bits & LPM4_bits) == LPM4_bits)
+        sim_halt("LPM4");
+    else if(bits & CPUOFF)
+        sim_halt("LPM without wake up source");
+}
+
+void host_hw_poll()
+{
+    // start conversion: SC clears itself when sampling starts
+    if((ADC12CTL0 & (ADC12SC | ADC12ENC | ADC12ON)) == (ADC12SC | ADC12ENC | ADC12ON) && !adc_busy)
+    {
+        ADC12CTL0 &= ~ADC12SC;
+        adc_busy = 1;
+        sim_after(ADC_CONVERSION_US, adc_conversion_done, NULL);
+    }
+}
+
+/* ======== power up ======== */
+
+void sim_init(uint32_t unix_time)
+{
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    start_unix = unix_time;
+    SYSRSTIV = SYSRSTIV_BOR;
+    PM5CTL0 = LOCKLPM5;
+    RTCCTL01 = RTCHOLD;
+    rtc_write((time_t)(unix_time + RTC_EPOCH_OFFSET));
+    sim_after(SIM_US_PER_SEC, rtc_second, NULL);
+    fram_preset_log(unix_time);
+}
@@ -0,0 +1,202 @@
+/*
+ * nestbox_host.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Board file of the host build, in place of nestbox_init.c: the same pin table,
+ *  interrupt callbacks and UART baud rate table, on the simulated drivers.
+ */
+
+#include <xdc/std.h>
+#include <msp430.h>
+#include <cs.h>
+#include <nestbox_init.h>
+
+#include <ti/drivers/GPIO.h>
+#include <ti/drivers/SPI.h>
+#include <ti/drivers/UART.h>
+
+#include "fw/user_button.h"
+#include "fw/load_cell.h"
+#include "fw/PIR_wakeup.h"
+#include "fw/lightbarrier.h"
+#include "fw/rfid_reader.h"
+
+/*
+ *  =============================== General ===============================
+ */
+void nbox_initGeneral(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+}
+
+/*
+ *  =============================== GPIO ===============================
+ *  Same order as nbox_GPIOName (nestbox_init.h) and nestbox_init.c.
+ */
+static GPIO_PinConfig gpioPinConfigs[] = {
+    /* NESTBOX_WIFI_SENSE */
+    GPIOMSP430_P1_0 | GPIO_CFG_IN_NOPULL | GPIO_CFG_IN_INT_RISING,
+    /* nestbox user button */
+    GPIOMSP430_P4_2 | GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_FALLING,
+#if USE_LB
+    /* NESTBOX_LIGHTBARRIER_IN_EXT */
+    GPIOMSP430_P1_4 | GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_RISING,
+    /* NESTBOX_LIGHTBARRIER_IN_INT */
+    GPIOMSP430_P1_3 | GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_RISING,
+#endif
+    /* NESTBOX_LOADCELL_DRDY */
+    GPIOMSP430_P3_4 | GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_FALLING,
+#if USE_PIR
+    /* NESTBOX_PIR_IN1 */
+    GPIOMSP430_P3_0 | GPIO_CFG_IN_NOPULL | GPIO_CFG_IN_INT_RISING,
+    /* NESTBOX_PIR_IN2 */
+    GPIOMSP430_P3_1 | GPIO_CFG_IN_NOPULL | GPIO_CFG_IN_INT_RISING,
+#endif
+#ifdef EM_READER
+    /* NESTBOX_LF_DATA */
+    GPIOMSP430_P1_5 | GPIO_CFG_IN_NOPULL | GPIO_CFG_IN_INT_NONE,
+    /* NESTBOX_LF_CLK */
+    GPIOMSP430_P4_3 | GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_NONE,
+#else
+    /* NESTBOX_LF_CLK */
+    GPIOMSP430_P1_5 | GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_RISING,
+    /* NESTBOX_LF_DATA */
+    GPIOMSP430_P4_3 | GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_NONE,
+#endif
+    /* NESTBOX_WIFI_ENABLE_N */
+    GPIOMSP430_PJ_3 | GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_NONE,
+
+    /************ Output pins ***********/
+    /* NESTBOX_LED_BLUE */
+    GPIOMSP430_P4_1 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW,
+    /* NESTBOX_LED_GREEN */
+    GPIOMSP430_P4_0 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW,
+    /* NESTBOX_LF_MODUL */
+    GPIOMSP430_P1_2 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_HIGH,
+    /* NESTBOX_LOADCELL_SPI_CS_N */
+    GPIOMSP430_P3_5 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_HIGH,
+    /* NESTBOX_LOADCELL_EXC_A_P */
+    GPIOMSP430_P3_6 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_HIGH,
+    /* NESTBOX_LOADCELL_EXC_A_N */
+    GPIOMSP430_P3_7 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW,
+    /* NESTBOX_LOADCELL_EXC_B_P */
+    GPIOMSP430_P4_5 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_HIGH,
+    /* NESTBOX_LOADCELL_EXC_B_N */
+    GPIOMSP430_P4_6 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW,
+    /* NESTBOX_LOADCELL_LDO_EN */
+    GPIOMSP430_PJ_1 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW,
+    /* NESTBOX_5V_EN */
+    GPIOMSP430_PJ_0 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW,
+    /* NESTBOX_SD_ENABLE_N ---> IS SD_SPI_CS currently! */
+    GPIOMSP430_PJ_2 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_HIGH,
+    /* NESTBOX_VBAT_TEST_ENABLE */
+    GPIOMSP430_P2_7 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW,
+    /* NESTBOX_PIR_ENABLE */
+    GPIOMSP430_P1_1 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW,
+};
+
+static GPIO_CallbackFxn gpioCallbackFunctions[] = {
+    wifi_sense_isr,
+    user_button_isr,
+#if USE_LB
+    lightbarrier_input_isr,
+    lightbarrier_input_isr,
+#endif
+    load_cell_isr,
+#if USE_PIR
+    PIR_wakeup_isr,
+    PIR_wakeup_isr,
+#endif
+};
+
+const GPIOMSP430_Config GPIOMSP430_config = {
+    .pinConfigs = gpioPinConfigs,
+    .callbacks = gpioCallbackFunctions,
+    .numberOfPinConfigs = sizeof(gpioPinConfigs)/sizeof(GPIO_PinConfig),
+    .numberOfCallbacks = sizeof(gpioCallbackFunctions)/sizeof(GPIO_CallbackFxn)
+};
+
+void nbox_initGPIO(void)
+{
+    GPIO_init();
+}
+
+/*
+ *  =============================== SPI ===============================
+ */
+void nbox_initSPI(void)
+{
+    SPI_init();
+}
+
+/*
+ *  =============================== UART ===============================
+ */
+struct baudrate_config {
+    unsigned long outputBaudrate;
+    unsigned long inputClockFreq;
+};
+
+// the rates of uartEUSCIABaudrates in nestbox_init.c
+static const struct baudrate_config uartBaudrates[] = {
+    {115200, 8000000},
+    {230400, 8000000},
+    {460800, 8000000},
+    {9600, 8000000},
+    {9600, 32768},
+};
+
+void nbox_initUART(void)
+{
+    P2OUT &= ~BIT0;
+    P2SEL1 &= ~BIT0;
+
+    UART_init();
+}
+
+int nbox_uart_baudrate_supported(unsigned long baudrate)
+{
+    unsigned int i;
+    unsigned long smclk = CS_getSMCLK();
+
+    for(i = 0; i < sizeof(uartBaudrates)/sizeof(uartBaudrates[0]); i++)
+    {
+        if(uartBaudrates[i].outputBaudrate == baudrate &&
+           uartBaudrates[i].inputClockFreq == smclk)
+            return 1;
+    }
+    return 0;
+}
+
+void nbox_uart_tx_pin(nbox_UARTName uart, int enable)
+{
+    unsigned char pin = (uart == nbox_UARTA0) ? BIT0 : BIT5;
+
+    if(enable)
+    {
+        P2OUT |= pin;
+        P2SEL1 |= pin;
+    }
+    else
+    {
+        P2OUT &= ~pin;
+        P2SEL1 &= ~pin;
+    }
+}
+
+void nbox_wifi_sense_edge(int falling)
+{
+    if(falling)
+        P1IES |= BIT0;
+    else
+        P1IES &= ~BIT0;
+}
+
+/*
+ *  =============================== Watchdog ===============================
+ */
+void nbox_initWatchdog(void)
+{
+}
@@ -0,0 +1,47 @@
+/*
+ * nestbox_rtos.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  The statically created objects of nestbox_rtos.cfg for the host build. The
+ *  interrupts (Hwi) are called directly by the device models.
+ */
+
+#include <stddef.h>
+#include <xdc/std.h>
+#include <xdc/cfg/global.h>
+
+#include "fw/stack_monitor.h"
+#include "fw/energy.h"
+
+static Semaphore_Object semReader_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semButton_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semPIRwakeup_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semLB1_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semLB2_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semSerial_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semSPI_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semLoadCell_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semSystemPause_obj = { 0, Semaphore_Mode_COUNTING };
+static Semaphore_Object semWifiRx_obj = { 0, Semaphore_Mode_BINARY };
+static Event_Object evtService_obj = { 0 };
+
+const Semaphore_Handle semReader = &semReader_obj;
+const Semaphore_Handle semButton = &semButton_obj;
+const Semaphore_Handle semPIRwakeup = &semPIRwakeup_obj;
+const Semaphore_Handle semLB1 = &semLB1_obj;
+const Semaphore_Handle semLB2 = &semLB2_obj;
+const Semaphore_Handle semSerial = &semSerial_obj;
+const Semaphore_Handle semSPI = &semSPI_obj;
+const Semaphore_Handle semLoadCell = &semLoadCell_obj;
+const Semaphore_Handle semSystemPause = &semSystemPause_obj;
+const Semaphore_Handle semWifiRx = &semWifiRx_obj;
+const Event_Handle evtService = &evtService_obj;
+
+// Idle.addFunc()
+void (*const host_idle_fxns[])(void) = {
+    stack_monitor_idle,
+    energy_idle,
+    NULL
+};
@@ -0,0 +1,64 @@
+/*
+ * power_sim.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Supply current of the board (models.h): the time in each power state comes from the
+ *  host platform (pins, UARTs, tick, ADS1220 model), the charge is the time multiplied
+ *  with the current of the state. The firmware takes no virtual time, so the CPU is
+ *  counted as a fixed active time per wake up and per tick.
+ */
+
+#include "sim.h"
+#include "models.h"
+#include "nestbox_init.h"
+
+const struct power_model power_model_default = {
+    .ua = {
+        [POWER_BASE]            = 120,      // fw/energy.c ENERGY_BASE_UA
+        [POWER_PAUSE]           = 15,       // LPM3, RTC only
+        [POWER_CPU]             = 1500,     // active at 8 MHz
+        [POWER_5V]              = 25000,    // boost converter and EM4095 field
+        [POWER_LOADCELL_LDO]    = 60,       // LDO quiescent current
+        [POWER_ADS_CONVERTING]  = 3800,     // 350 Ohm bridge at 1.2 V reference + ADS1220 normal mode
+        [POWER_SD_CARD]         = 20000,
+        [POWER_DEBUG_UART]      = 250,
+        [POWER_WIFI]            = 80000,
+        [POWER_LEDS]            = 2000,
+        [POWER_VBAT_TEST]       = 25,
+    },
+    .wakeup_us = 300,
+    .tick_us = 10,
+    .battery_mah = 2000,                    // 4 x AA NiMH
+};
+
+void power_sim_report(const struct power_model *model, struct power_report *report)
+{
+    uint64_t elapsed = sim_time_us();
+    uint64_t paused = sim_tick_stopped_us();
+    uint64_t ticks = (elapsed - paused) / SIM_US_PER_TICK;
+    uint64_t ldo = sim_gpio_high_us(nbox_loadcell_ldo_enable);
+    uint64_t converting = ads1220_sim_converting_us();
+    unsigned int i;
+
+    report->elapsed_us = elapsed;
+    report->us[POWER_BASE] = elapsed - paused;
+    report->us[POWER_PAUSE] = paused;
+    report->us[POWER_CPU] = (uint64_t)(sim_idle_count() * model->wakeup_us + ticks * model->tick_us);
+    report->us[POWER_5V] = sim_gpio_high_us(nbox_5v_enable);
+    report->us[POWER_LOADCELL_LDO] = ldo > converting ? ldo - converting : 0;
+    report->us[POWER_ADS_CONVERTING] = converting;
+    report->us[POWER_SD_CARD] = elapsed - sim_gpio_high_us(nbox_sdcard_enable_n);
+    report->us[POWER_DEBUG_UART] = sim_uart_open_us(nbox_UARTA1);
+    report->us[POWER_WIFI] = sim_uart_open_us(nbox_UARTA0);
+    report->us[POWER_LEDS] = sim_gpio_high_us(nbox_led_status) + sim_gpio_high_us(nbox_led_data);
+    report->us[POWER_VBAT_TEST] = sim_gpio_high_us(nbox_vbat_test_enable);
+
+    report->total_uah = 0;
+    for(i = 0; i < POWER_STATE_COUNT; i++)
+    {
+        report->uah[i] = report->us[i] * model->ua[i] / (3600.0 * SIM_US_PER_SEC);
+        report->total_uah += report->uah[i];
+    }
+}
@@ -0,0 +1,608 @@
+/*
+ * scenario.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Scenario files (scenario.h): parser, and the model events that play a scenario. The
+ *  visits are scheduled one after the other (arrival, then departure), so a month with
+ *  thousands of visits keeps the event queue short.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+#include "models.h"
+#include "scenario.h"
+#include "nestbox_init.h"
+
+#define MAX_DEPTH           8       // nested repeat blocks
+#define MAX_ON_PERCH        8       // visits at the same time
+#define BATTERY_UPDATE_US   (60 * SIM_US_PER_SEC)
+#define DEFAULT_DURATION_US (24 * 3600 * SIM_US_PER_SEC)
+#define DEFAULT_CELSIUS     20.0
+
+// perch load of a bird, relative to its weight
+#define LANDING_OVERSHOOT   0.7     // first swing of the perch after the landing
+#define LANDING_TAU_US      250000
+#define LANDING_HZ          5.0
+#define PREENING_SHIFT      0.1     // weight shifts up to +-10 % ...
+#define PREENING_US         (3 * SIM_US_PER_SEC)    // ... every 3 s
+#define PREENING_WOBBLE     0.03
+#define PREENING_HZ         1.5
+#define HOP_US              (10 * SIM_US_PER_SEC)   // a hop every 10 s ...
+#define HOP_AIR_US          400000                  // ... 400 ms off the perch
+// wind, relative to its amplitude
+#define WIND_HZ_1           2.3
+#define WIND_HZ_2           6.1
+
+struct parser {
+    struct scenario *s;
+    char **lines;
+    size_t n_lines;
+    size_t visits_size;
+    size_t battery_size;
+    size_t temperature_size;
+    size_t wind_size;
+    size_t buttons_size;
+};
+
+// param statement, same order as enum param_id
+static const char *const param_names[PARAM_COUNT] = {
+    "weight_threshold",
+    "t_loadcell_poll",
+    "rfid_timeout",
+    "t_rfid_retry",
+    "bat_test_interval",
+    "n_averages",
+    "sample_tolerance",
+    "sd_baudrate",
+    "sd_compress",
+};
+
+static const struct scenario *playing = NULL;
+static size_t next_visit = 0;
+static const struct scenario_visit *on_perch[MAX_ON_PERCH];
+static unsigned int n_on_perch = 0;
+
+/* ======== parser ======== */
+
+static int parse_error(size_t line, const char *msg)
+{
+    fprintf(stderr, "scenario:%zu: %s\n", line + 1, msg);
+    return (int)line + 1;
+}
+
+static void *grow(void *array, size_t *size, size_t n, size_t elem)
+{
+    if(n < *size)
+        return array;
+    *size = *size ? *size * 2 : 16;
+    array = realloc(array, *size * elem);
+    if(array == NULL)
+        abort();
+    return array;
+}
+
+// offset from the power up: 90, 1h30m, 250ms
+static int parse_time(const char *tok, uint64_t *us)
+{
+    const char *p = tok;
+
+    *us = 0;
+    if(*p != '\0' && strspn(p, "0123456789") == strlen(p))
+    {
+        *us = strtoull(p, NULL, 10) * SIM_US_PER_SEC;
+        return 1;
+    }
+    while(*p)
+    {
+        char *end;
+        unsigned long long n = strtoull(p, &end, 10);
+        if(end == p)
+            return 0;
+        p = end;
+        if(strncmp(p, "ms", 2) == 0)
+        {
+            *us += n * 1000ULL;
+            p += 2;
+            continue;
+        }
+        switch(*p++)
+        {
+        case 'd': *us += n * 24 * 3600 * SIM_US_PER_SEC; break;
+        case 'h': *us += n * 3600 * SIM_US_PER_SEC; break;
+        case 'm': *us += n * 60 * SIM_US_PER_SEC; break;
+        case 's': *us += n * SIM_US_PER_SEC; break;
+        default: return 0;
+        }
+    }
+    return p != tok;
+}
+
+static int parse_start(const char *args, uint32_t *start)
+{
+    struct tm tm = { 0 };
+    unsigned long unix_time;
+    char extra;
+
+    if(sscanf(args, "%d-%d-%d %d:%d:%d %c", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+              &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &extra) == 6)
+    {
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        *start = (uint32_t)timegm(&tm);
+        return 1;
+    }
+    if(sscanf(args, "%lu %c", &unix_time, &extra) == 1)
+    {
+        *start = (uint32_t)unix_time;
+        return 1;
+    }
+    return 0;
+}
+
+static struct scenario_point *add_point(struct scenario_point *points, size_t *n, size_t *size,
+                                        uint64_t at_us, double value)
+{
+    points = grow(points, size, *n, sizeof(*points));
+    points[*n].at_us = at_us;
+    points[*n].value = value;
+    (*n)++;
+    return points;
+}
+
+// statements from line *i up to "end" (depth > 0) or the end of the text
+static int parse_block(struct parser *p, size_t *i, uint64_t base, int depth)
+{
+    struct scenario *s = p->s;
+
+    for(; *i < p->n_lines; (*i)++)
+    {
+        char word[16], a[32] = "", b[32] = "", c[32] = "", d[32] = "", e[32] = "";
+        const char *line = p->lines[*i];
+        const char *args;
+        int n;
+        uint64_t t, t2;
+
+        n = sscanf(line, "%15s %31s %31s %31s %31s %31s", word, a, b, c, d, e);
+        if(n <= 0)
+            continue;
+        args = strstr(line, word) + strlen(word);
+
+        if(strcmp(word, "end") == 0)
+        {
+            if(depth == 0)
+                return parse_error(*i, "end without repeat");
+            return 0;
+        }
+        else if(strcmp(word, "repeat") == 0)
+        {
+            unsigned long count;
+            unsigned long k;
+            size_t first = *i + 1;
+            size_t after = first;
+            char *end;
+
+            count = strtoul(a, &end, 10);
+            if(n != 3 || *end != '\0' || count == 0 || !parse_time(b, &t))
+                return parse_error(*i, "repeat <count> <period>");
+            if(depth + 1 >= MAX_DEPTH)
+                return parse_error(*i, "repeat nested too deep");
+            for(k = 0; k < count; k++)
+            {
+                size_t j = first;
+                int err = parse_block(p, &j, base + k * t, depth + 1);
+                if(err)
+                    return err;
+                if(j >= p->n_lines)
+                    return parse_error(*i, "repeat without end");
+                after = j;
+            }
+            *i = after;
+        }
+        else if(strcmp(word, "start") == 0)
+        {
+            if(!parse_start(args, &s->start))
+                return parse_error(*i, "start <YYYY-MM-DD HH:MM:SS> or start <unix time>");
+        }
+        else if(strcmp(word, "duration") == 0)
+        {
+            if(n != 2 || !parse_time(a, &t))
+                return parse_error(*i, "duration <time>");
+            s->duration_us = base + t;
+        }
+        else if(strcmp(word, "sd_baud") == 0)
+        {
+            char *end;
+            s->sd_baud = strtoul(a, &end, 10);
+            if(n != 2 || *end != '\0' || s->sd_baud == 0)
+                return parse_error(*i, "sd_baud <baud>");
+        }
+        else if(strcmp(word, "battery") == 0 || strcmp(word, "temperature") == 0 || strcmp(word, "wind") == 0)
+        {
+            char *end;
+            double value = strtod(b, &end);
+            if(n != 3 || *end != '\0' || !parse_time(a, &t))
+                return parse_error(*i, "battery <time> <mV> / temperature <time> <degC> / wind <time> <g>");
+            if(word[0] == 'b')
+                s->battery = add_point(s->battery, &s->n_battery, &p->battery_size, base + t, value);
+            else if(word[0] == 't')
+                s->temperature = add_point(s->temperature, &s->n_temperature, &p->temperature_size, base + t, value);
+            else
+                s->wind = add_point(s->wind, &s->n_wind, &p->wind_size, base + t, value);
+        }
+        else if(strcmp(word, "param") == 0)
+        {
+            char *end;
+            long value = strtol(b, &end, 10);
+            int id;
+            for(id = 0; id < PARAM_COUNT; id++)
+                if(strcmp(a, param_names[id]) == 0)
+                    break;
+            if(n != 3 || *end != '\0')
+                return parse_error(*i, "param <name> <value>");
+            if(id == PARAM_COUNT)
+                return parse_error(*i, "unknown param");
+            s->params[id] = (int32_t)value;
+            s->params_given |= 1UL << id;
+        }
+        else if(strcmp(word, "offset_drift") == 0)
+        {
+            char *end;
+            s->offset_drift = strtod(a, &end);
+            if(n != 2 || *end != '\0')
+                return parse_error(*i, "offset_drift <counts per degC>");
+        }
+        else if(strcmp(word, "visit") == 0)
+        {
+            struct scenario_visit *v;
+            char *end_tag;
+            char *end_grams;
+            uint64_t tag = strtoull(c, &end_tag, 16);
+            double grams = strtod(d, &end_grams);
+            enum scenario_behaviour behaviour = VISIT_SITTING;
+
+            if(n < 5 || !parse_time(a, &t) || !parse_time(b, &t2) || *end_tag != '\0' || *end_grams != '\0')
+                return parse_error(*i, "visit <time> <stay> <tag> <grams> [sitting|preening|hopping]");
+            if(tag >> 40)
+                return parse_error(*i, "EM4100 tags have 40 bits");
+            if(n == 6 && strcmp(e, "preening") == 0)
+                behaviour = VISIT_PREENING;
+            else if(n == 6 && strcmp(e, "hopping") == 0)
+                behaviour = VISIT_HOPPING;
+            else if(n == 6 && strcmp(e, "sitting") != 0)
+                return parse_error(*i, "the bird is sitting, preening or hopping");
+            s->visits = grow(s->visits, &p->visits_size, s->n_visits, sizeof(*s->visits));
+            v = &s->visits[s->n_visits++];
+            v->at_us = base + t;
+            v->duration_us = t2;
+            v->tag = tag;
+            v->grams = grams;
+            v->behaviour = behaviour;
+        }
+        else if(strcmp(word, "button") == 0)
+        {
+            if(n != 2 || !parse_time(a, &t))
+                return parse_error(*i, "button <time>");
+            s->buttons = grow(s->buttons, &p->buttons_size, s->n_buttons, sizeof(*s->buttons));
+            s->buttons[s->n_buttons++] = base + t;
+        }
+        else
+            return parse_error(*i, "unknown statement");
+    }
+    return 0;
+}
+
+static int visit_cmp(const void *a, const void *b)
+{
+    const struct scenario_visit *va = a;
+    const struct scenario_visit *vb = b;
+
+    if(va->at_us != vb->at_us)
+        return va->at_us < vb->at_us ? -1 : 1;
+    if(va->tag != vb->tag)
+        return va->tag < vb->tag ? -1 : 1;
+    if(va->duration_us != vb->duration_us)
+        return va->duration_us < vb->duration_us ? -1 : 1;
+    if(va->behaviour != vb->behaviour)
+        return va->behaviour < vb->behaviour ? -1 : 1;
+    return (va->grams > vb->grams) - (va->grams < vb->grams);
+}
+
+static int point_cmp(const void *a, const void *b)
+{
+    const struct scenario_point *pa = a;
+    const struct scenario_point *pb = b;
+
+    if(pa->at_us != pb->at_us)
+        return pa->at_us < pb->at_us ? -1 : 1;
+    return (pa->value > pb->value) - (pa->value < pb->value);
+}
+
+static int u64_cmp(const void *a, const void *b)
+{
+    uint64_t ua = *(const uint64_t *)a;
+    uint64_t ub = *(const uint64_t *)b;
+
+    return ua < ub ? -1 : (ua > ub);
+}
+
+int scenario_parse(struct scenario *s, const char *text)
+{
+    struct parser p = { s, NULL, 0, 0, 0, 0, 0, 0 };
+    size_t lines_size = 0;
+    char *copy = strdup(text);
+    char *line = copy;
+    size_t i = 0;
+    int err;
+
+    if(copy == NULL)
+        abort();
+    memset(s, 0, sizeof(*s));
+    s->duration_us = DEFAULT_DURATION_US;
+    s->sd_baud = 115200;
+
+    while(line != NULL)
+    {
+        char *next = strchr(line, '\n');
+        char *comment;
+        if(next != NULL)
+            *next++ = '\0';
+        if((comment = strchr(line, '#')) != NULL)
+            *comment = '\0';
+        p.lines = grow(p.lines, &lines_size, p.n_lines, sizeof(*p.lines));
+        p.lines[p.n_lines++] = line;
+        line = next;
+    }
+
+    err = parse_block(&p, &i, 0, 0);
+    free(p.lines);
+    free(copy);
+    if(err)
+    {
+        scenario_free(s);
+        return err;
+    }
+
+    // qsort is not stable: ties are broken on all fields, so the order is always the same
+    qsort(s->visits, s->n_visits, sizeof(*s->visits), visit_cmp);
+    qsort(s->battery, s->n_battery, sizeof(*s->battery), point_cmp);
+    qsort(s->temperature, s->n_temperature, sizeof(*s->temperature), point_cmp);
+    qsort(s->wind, s->n_wind, sizeof(*s->wind), point_cmp);
+    qsort(s->buttons, s->n_buttons, sizeof(*s->buttons), u64_cmp);
+    return 0;
+}
+
+int scenario_load(struct scenario *s, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char *text = NULL;
+    size_t len = 0;
+    size_t r;
+    char buf[4096];
+    int err;
+
+    if(f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    while((r = fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        text = realloc(text, len + r + 1);
+        if(text == NULL)
+            abort();
+        memcpy(text + len, buf, r);
+        len += r;
+    }
+    fclose(f);
+    if(text == NULL)
+        text = strdup("");
+    else
+        text[len] = '\0';
+
+    err = scenario_parse(s, text);
+    free(text);
+    return err;
+}
+
+void scenario_free(struct scenario *s)
+{
+    free(s->visits);
+    free(s->battery);
+    free(s->temperature);
+    free(s->wind);
+    free(s->buttons);
+    s->visits = NULL;
+    s->battery = s->temperature = s->wind = NULL;
+    s->buttons = NULL;
+    s->n_visits = s->n_battery = s->n_temperature = s->n_wind = s->n_buttons = 0;
+}
+
+/* ======== playing ======== */
+
+// piecewise linear, constant before the first and after the last point
+static double curve(const struct scenario_point *points, size_t n, uint64_t t, double none)
+{
+    size_t i;
+
+    if(n == 0)
+        return none;
+    if(t <= points[0].at_us)
+        return points[0].value;
+    for(i = 1; i < n; i++)
+    {
+        if(t < points[i].at_us)
+        {
+            double f = (double)(t - points[i-1].at_us) / (double)(points[i].at_us - points[i-1].at_us);
+            return points[i-1].value + f * (points[i].value - points[i-1].value);
+        }
+    }
+    return points[n-1].value;
+}
+
+// splitmix64: the random choices of a visit, the same in every run
+static uint64_t visit_hash(const struct scenario_visit *v, uint64_t n)
+{
+    uint64_t z = v->at_us ^ (v->tag << 20) ^ (n * 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static double seconds(uint64_t us)
+{
+    return us / (double)SIM_US_PER_SEC;
+}
+
+// load of one bird on the perch, since_us after it arrived
+static double bird_grams(const struct scenario_visit *v, uint64_t since_us)
+{
+    uint64_t landed_us = 0;
+    double load;
+
+    if(v->behaviour == VISIT_HOPPING && since_us >= HOP_US)
+    {
+        uint64_t hop = since_us / HOP_US;
+        if(since_us - hop * HOP_US < HOP_AIR_US)
+            return 0;
+        landed_us = hop * HOP_US + HOP_AIR_US;
+    }
+
+    load = 1 + LANDING_OVERSHOOT * exp(-(double)(since_us - landed_us) / LANDING_TAU_US) *
+               cos(2 * M_PI * LANDING_HZ * seconds(since_us - landed_us));
+    if(v->behaviour == VISIT_PREENING)
+    {
+        uint64_t shift = visit_hash(v, 1 + since_us / PREENING_US);
+        load += PREENING_SHIFT * ((shift & 0xffff) / 32768.0 - 1);
+        double phase = (visit_hash(v, 0) & 0xffff) / 65536.0 * 2 * M_PI;
+        load += PREENING_WOBBLE * sin(2 * M_PI * PREENING_HZ * seconds(since_us) + phase);
+    }
+    return v->grams * load;
+}
+
+double scenario_perch_grams(uint64_t time_us)
+{
+    double grams = 0;
+    unsigned int i;
+
+    for(i = 0; i < n_on_perch; i++)
+        grams += bird_grams(on_perch[i], time_us - on_perch[i]->at_us);
+    if(playing != NULL && playing->n_wind > 0)
+    {
+        double wind = curve(playing->wind, playing->n_wind, time_us, 0);
+        grams += wind * (0.7 * sin(2 * M_PI * WIND_HZ_1 * seconds(time_us)) +
+                         0.3 * sin(2 * M_PI * WIND_HZ_2 * seconds(time_us) + 1));
+    }
+    return grams;
+}
+
+double scenario_birds_grams(uint64_t time_us)
+{
+    double grams = 0;
+    unsigned int i;
+    (void)time_us;
+
+    for(i = 0; i < n_on_perch; i++)
+        grams += on_perch[i]->grams;
+    return grams;
+}
+
+double scenario_celsius(uint64_t time_us)
+{
+    if(playing == NULL)
+        return DEFAULT_CELSIUS;
+    return curve(playing->temperature, playing->n_temperature, time_us, DEFAULT_CELSIUS);
+}
+
+static void battery_update(void *arg)
+{
+    (void)arg;
+    sim_set_battery_mv((uint16_t)(curve(playing->battery, playing->n_battery, sim_time_us(), 5000) + 0.5));
+    if(playing->n_battery > 1 && sim_time_us() < playing->battery[playing->n_battery-1].at_us)
+        sim_after(BATTERY_UPDATE_US, battery_update, NULL);
+}
+
+// the tag of the bird that came last is read
+static void visit_leave(void *arg)
+{
+    const struct scenario_visit *v = arg;
+    unsigned int i;
+
+    for(i = 0; i < n_on_perch; i++)
+    {
+        if(on_perch[i] == v)
+        {
+            memmove(&on_perch[i], &on_perch[i+1], (n_on_perch - i - 1) * sizeof(on_perch[0]));
+            n_on_perch--;
+            break;
+        }
+    }
+    if(n_on_perch > 0)
+        em4100_tag_enter(on_perch[n_on_perch-1]->tag);
+    else
+        em4100_tag_leave();
+}
+
+static void visit_arrive(void *arg)
+{
+    const struct scenario_visit *v = &playing->visits[next_visit++];
+    (void)arg;
+
+    if(n_on_perch < MAX_ON_PERCH)
+    {
+        on_perch[n_on_perch++] = v;
+        em4100_tag_enter(v->tag);
+        sim_after(v->duration_us, visit_leave, (void *)v);
+    }
+    if(next_visit < playing->n_visits)
+        sim_at(playing->visits[next_visit].at_us, visit_arrive, NULL);
+}
+
+static void button_release(void *arg)
+{
+    (void)arg;
+    sim_gpio_set_input(nbox_button, 1);
+}
+
+static void button_press(void *arg)
+{
+    (void)arg;
+    sim_gpio_set_input(nbox_button, 0);
+    sim_after(200 * 1000, button_release, NULL);
+}
+
+void scenario_start(const struct scenario *s)
+{
+    size_t i;
+
+    playing = s;
+    next_visit = 0;
+    n_on_perch = 0;
+
+    sim_init(s->start);
+    // stored in FRAM before this power up
+    params_init();
+    params_set(PARAM_SD_BAUDRATE, s->sd_baud);
+    for(i = 0; i < PARAM_COUNT; i++)
+        if((s->params_given & (1UL << i)) && !params_set(i, s->params[i]))
+            fprintf(stderr, "scenario: param %s %ld out of range, default kept\n", param_names[i], (long)s->params[i]);
+    sd_logger_attach(s->sd_baud);
+    em4100_tag_attach();
+    ads1220_sim_attach(scenario_perch_grams, scenario_celsius);
+    ads1220_sim_set_offset_drift(s->offset_drift);
+
+    if(s->n_battery > 0)
+        battery_update(NULL);
+    if(s->n_visits > 0)
+        sim_at(s->visits[0].at_us, visit_arrive, NULL);
+    for(i = 0; i < s->n_buttons; i++)
+        sim_at(s->buttons[i], button_press, NULL);
+    sim_set_end(s->duration_us);
+}
@@ -0,0 +1,99 @@
+/*
+ * scenario.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Scenario files for the host simulation: when the box is powered up, how long it runs,
+ *  and what happens around it. One statement per line, '#' starts a comment:
+ *
+ *    start 2026-10-18 18:00:00     power up (UTC), or a unix time
+ *    duration 30d                  simulated time
+ *    sd_baud 115200                baud rate of the SD logger (and PARAM_SD_BAUDRATE)
+ *    param t_loadcell_poll 2000    firmware parameter (fw/params.h, name in lower case
+ *                                  without PARAM_), as if set over wifi before
+ *    battery 0 5000                battery voltage (mV) at a time; linear in between
+ *    temperature 12h 8.5           perch temperature (degC) at a time; linear in between
+ *    visit 3h 45s 59004529B6 162   bird at a time: stay, EM4100 tag (hex), weight (g),
+ *    visit 4h 2m 580053A0AF 595 preening   and optionally how it behaves on the perch:
+ *                                  sitting (default), preening or hopping
+ *    wind 2h 30                    amplitude (g) of the wind on the perch; linear in between
+ *    offset_drift -150             load cell zero offset drift, ADC counts per degC
+ *    button 5m                     user button press
+ *    repeat 30 1d                  the statements up to "end" count times, one period
+ *    end                           apart (may be nested)
+ *
+ *  Times are offsets from the power up: a number with the units d, h, m, s or ms, or a
+ *  sum of them (1h30m); a number alone is seconds.
+ *
+ *  The load on the perch is generated from the visits: every landing overshoots and rings
+ *  out, a sitting bird then keeps still, a preening one shifts its weight every few seconds,
+ *  a hopping one leaves the perch for a moment every few seconds and lands again. Birds
+ *  on the perch at the same time add up, and the wind shakes the perch with or without
+ *  them.
+ */
+
+#ifndef HOST_SCENARIO_H_
+#define HOST_SCENARIO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "params.h"
+
+enum scenario_behaviour {
+    VISIT_SITTING,
+    VISIT_PREENING,
+    VISIT_HOPPING,
+};
+
+struct scenario_visit {
+    uint64_t at_us;
+    uint64_t duration_us;
+    uint64_t tag;
+    double grams;
+    enum scenario_behaviour behaviour;
+};
+
+// point of a piecewise linear curve
+struct scenario_point {
+    uint64_t at_us;
+    double value;
+};
+
+struct scenario {
+    uint32_t start;                 // UTC
+    uint64_t duration_us;
+    uint32_t sd_baud;
+    struct scenario_visit *visits;  // sorted by time
+    size_t n_visits;
+    struct scenario_point *battery; // mV
+    size_t n_battery;
+    struct scenario_point *temperature; // degC
+    size_t n_temperature;
+    struct scenario_point *wind;    // g
+    size_t n_wind;
+    double offset_drift;            // ADC counts per degC
+    uint64_t *buttons;
+    size_t n_buttons;
+    int32_t params[PARAM_COUNT];
+    uint32_t params_given;          // bit mask of the params set
+};
+
+// 0, or the number of the first line with an error (the error is printed to stderr)
+int scenario_parse(struct scenario *s, const char *text);
+// as scenario_parse(), -1 if the file cannot be read
+int scenario_load(struct scenario *s, const char *path);
+void scenario_free(struct scenario *s);
+
+// power up at the start time with the device models attached (SD logger, tag, load cell)
+// and the events of the scenario scheduled; then run nestbox_main()
+void scenario_start(const struct scenario *s);
+
+// what the sensor models see at a time
+double scenario_perch_grams(uint64_t time_us);
+double scenario_celsius(uint64_t time_us);
+// the weight of the birds on the perch at a time, without their movements and the wind
+double scenario_birds_grams(uint64_t time_us);
+
+#endif /* HOST_SCENARIO_H_ */
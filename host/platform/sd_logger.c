@@ -0,0 +1,92 @@
+/*
+ * sd_logger.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  OpenLog style SD logger on the debug UART (logger.c: sd_logger_open()).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "models.h"
+#include "nestbox_init.h"
+
+#define SD_BOOT_US      (300 * 1000)    // card init until the prompt
+
+static const uint8_t prompt[] = "12<";
+
+static uint32_t sd_baud;
+static int powered = 0;
+static unsigned int sessions = 0;
+static char *data = NULL;
+static size_t data_len = 0;
+static size_t data_size = 0;
+static size_t garbled = 0;
+
+static void sd_boot(void *arg)
+{
+    // still the same power up?
+    if(powered && (uintptr_t)arg == sessions)
+        sim_uart_send(nbox_UARTA1, prompt, sizeof(prompt) - 1, sd_baud);
+}
+
+static void sd_power(unsigned int index, int level)
+{
+    (void)index;
+    powered = !level; // enable_n
+    if(powered)
+    {
+        sessions++;
+        sim_after(SD_BOOT_US, sd_boot, (void *)(uintptr_t)sessions);
+    }
+}
+
+static void sd_rx(const uint8_t *bytes, size_t n, uint32_t baud)
+{
+    if(!powered)
+        return;
+    if(baud != sd_baud)
+    {
+        garbled += n;
+        return;
+    }
+    if(data_len + n > data_size)
+    {
+        data_size = (data_len + n) * 2;
+        data = realloc(data, data_size + 1);
+        if(data == NULL)
+            abort();
+    }
+    memcpy(data + data_len, bytes, n);
+    data_len += n;
+    data[data_len] = '\0';
+}
+
+static const struct sim_uart_device sd_device = { sd_rx, NULL, NULL };
+
+void sd_logger_attach(uint32_t baud)
+{
+    sd_baud = baud;
+    sim_uart_attach(nbox_UARTA1, &sd_device);
+    sim_gpio_watch(nbox_sdcard_enable_n, sd_power);
+}
+
+const char *sd_logger_data(size_t *n)
+{
+    if(n != NULL)
+        *n = data_len;
+    return data != NULL ? data : "";
+}
+
+unsigned int sd_logger_sessions()
+{
+    return sessions;
+}
+
+size_t sd_logger_garbled()
+{
+    return garbled;
+}
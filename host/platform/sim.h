@@ -0,0 +1,98 @@
+/*
+ * sim.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Host simulation of the nest box: the unmodified firmware (main.c and the tasks in fw/)
+ *  runs on the SYS/BIOS and driver layer in host/platform, in virtual time.
+ *
+ *  Only one task executes at a time (coroutines), so a run is deterministic: the same
+ *  scenario gives the same log, byte for byte. Firmware code takes no virtual time;
+ *  time advances while all tasks are blocked, from one 1 ms tick (or model event) to the
+ *  next; with fast forward straight to the next event or task timeout. Device models
+ *  schedule their events with sim_at() and run them in interrupt context: they may post
+ *  semaphores and call the firmware interrupt routines.
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include <stdint.h>
+
+#define SIM_US_PER_TICK     1000ULL     // Clock.tickPeriod
+#define SIM_US_PER_SEC      1000000ULL
+
+typedef void (*sim_fxn)(void *arg);
+
+// power up at the given UTC time: RTC registers, power up reset cause, and a log header
+// in FRAM as left by a box whose clock was set before (the firmware starts at that time)
+void sim_init(uint32_t unix_time);
+// battery voltage the ADC measures
+void sim_set_battery_mv(uint16_t mv);
+
+// virtual time since power up
+uint64_t sim_time_us(void);
+// real time of day (the RTC crystal), independent of the firmware
+uint32_t sim_unix_time(void);
+
+// model event at an absolute virtual time / after a delay (FIFO for equal times)
+void sim_at(uint64_t time_us, sim_fxn fxn, void *arg);
+void sim_after(uint64_t delay_us, sim_fxn fxn, void *arg);
+
+// skip the ticks that wake up no task (default); off: every 1 ms tick is simulated
+void sim_set_fast_forward(int on);
+
+// end BIOS_start() at the given time, or at the current one
+void sim_set_end(uint64_t time_us);
+void sim_stop(void);
+
+// the firmware stopped the CPU for good (LPM4, LPM3.5); does not return to the task
+void sim_halt(const char *reason);
+// NULL while running
+const char *sim_halt_reason(void);
+
+// block the running task for a time that is not counted in ticks (UART wire time)
+void sim_task_wait_us(uint64_t us);
+// end of an interrupt raised from task context (driver call): preempts the task if the
+// interrupt made a task of higher priority ready
+void sim_isr_exit(void);
+
+// idle loop passes since power up (= returns to low power mode)
+uint32_t sim_idle_count(void);
+// virtual time since power up with the tick stopped (Clock_tickStop(): RTC pause)
+uint64_t sim_tick_stopped_us(void);
+
+/* ======== device model hooks (drivers.c) ======== */
+
+#include <stddef.h>
+
+// external level on an input pin: latches the interrupt flag on the configured edge
+void sim_gpio_set_input(unsigned int index, int level);
+// level the firmware drives on an output pin
+int sim_gpio_get_output(unsigned int index);
+// called in the firmware's context when it changes an output pin (several models may
+// watch the same pin)
+typedef void (*sim_gpio_fxn)(unsigned int index, int level);
+void sim_gpio_watch(unsigned int index, sim_gpio_fxn fxn);
+// virtual time since power up the firmware drove the output pin high
+uint64_t sim_gpio_high_us(unsigned int index);
+
+// device on the other end of a UART
+struct sim_uart_device {
+    void (*rx)(const uint8_t *data, size_t n, uint32_t baud);    // firmware wrote
+    void (*open)(uint32_t baud);
+    void (*close)(void);
+};
+void sim_uart_attach(unsigned int index, const struct sim_uart_device *dev);
+// device sends to the firmware, one byte per wire time; the bytes are garbled if the
+// UART is open at another baud rate and lost if it is closed
+void sim_uart_send(unsigned int index, const uint8_t *data, size_t n, uint32_t baud);
+// virtual time since power up the UART was open
+uint64_t sim_uart_open_us(unsigned int index);
+
+// device on the SPI bus: full duplex transfer of n bytes
+typedef void (*sim_spi_fxn)(const uint8_t *tx, uint8_t *rx, size_t n);
+void sim_spi_attach(unsigned int index, sim_spi_fxn fxn);
+
+#endif /* HOST_SIM_H_ */
@@ -0,0 +1,52 @@
+/*
+ * test.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ */
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// minimal checks for the host tests: print every failure, the exit code tells make
+
+static int test_failures = 0;
+static int test_checks = 0;
+
+#define CHECK(cond) do { \
+        test_checks++; \
+        if(!(cond)) { \
+            test_failures++; \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while(0)
+
+#define CHECK_EQ(a, b) do { \
+        long long a_ = (long long)(a), b_ = (long long)(b); \
+        test_checks++; \
+        if(a_ != b_) { \
+            test_failures++; \
+            printf("%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #a, a_, b_); \
+        } \
+    } while(0)
+
+#define CHECK_NEAR(a, b, tol) do { \
+        long long a_ = (long long)(a), b_ = (long long)(b); \
+        test_checks++; \
+        if(llabs(a_ - b_) > (long long)(tol)) { \
+            test_failures++; \
+            printf("%s:%d: %s == %lld, expected %lld +- %lld\n", __FILE__, __LINE__, #a, a_, b_, (long long)(tol)); \
+        } \
+    } while(0)
+
+static inline int test_summary(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, test_checks, test_failures);
+    return test_failures ? 1 : 0;
+}
+
+#endif /* HOST_TEST_H_ */
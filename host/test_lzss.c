@@ -0,0 +1,377 @@
+/*
+ * test_lzss.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Host test of the LZSS compressor (fw/lzss.c) with its decoder: edge cases, corrupt
+ *  input, and simulated nights of the FRAM log (battery checks, visits with tag reads,
+ *  weight series and load cell polls), compressed in blocks like the SD flush of
+ *  logger.c and unpacked again by platform/log_unpack.c to the text lines of the
+ *  uncompressed flush.
+ *
+ *    test_lzss -b   compression ratio and throughput (MB/s on this host) per block size,
+ *                   over the simulated nights
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+#include "lzss.h"
+#include "log_unpack.h"
+
+#define SD_CHUNK        240     // logger.c: LOG_SD_CHUNK
+#define NIGHT_BYTES     8192    // the FRAM log region
+#define BENCH_SECONDS   0.3
+#define T0              1792346400UL
+
+static uint32_t lcg = 1;
+
+static uint32_t random_u32()
+{
+    lcg = lcg * 1103515245U + 12345U;
+    return lcg >> 8;
+}
+
+static int32_t noise(int32_t amplitude)
+{
+    return (int32_t)(random_u32() % (2*amplitude + 1)) - amplitude;
+}
+
+/* ======== simulated FRAM log ======== */
+
+struct night {
+    uint8_t log[NIGHT_BYTES];
+    size_t n;
+    uint32_t time;
+};
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+// entries as logger.c writes them: time, logchar, then values in 16 bit words
+static int short_entry(struct night *l, char logchar, uint16_t value)
+{
+    uint8_t *e = &l->log[l->n];
+
+    if(l->n + 8 > NIGHT_BYTES)
+        return 0;
+    put32(e, l->time);
+    e[4] = logchar;
+    e[5] = logchar;
+    e[6] = value;
+    e[7] = value >> 8;
+    l->n += 8;
+    return 1;
+}
+
+static int long_entry(struct night *l, char logchar, uint32_t value, uint16_t stddev)
+{
+    uint8_t *e = &l->log[l->n];
+
+    if(l->n + 12 > NIGHT_BYTES)
+        return 0;
+    put32(e, l->time);
+    e[4] = logchar;
+    e[5] = 0;
+    e[6] = stddev;
+    e[7] = stddev >> 8;
+    put32(&e[8], value);
+    l->n += 12;
+    return 1;
+}
+
+static int rfid_entry(struct night *l, uint64_t uid)
+{
+    uint8_t *e = &l->log[l->n];
+
+    if(l->n + 12 > NIGHT_BYTES)
+        return 0;
+    put32(e, l->time);
+    put32(&e[4], (uint32_t)(uid >> 16));
+    e[4] = 'R';
+    put32(&e[8], (uint32_t)uid);
+    l->n += 12;
+    return 1;
+}
+
+// a bird lands: tag reads, a weight series, the result, then load cell polls while it stays
+static int visit(struct night *l, uint64_t uid, uint32_t grams, unsigned int stay_s)
+{
+    uint32_t counts = 180000 + grams * 1099;
+    unsigned int i;
+    int ok = short_entry(l, 'D', counts >> 8);
+
+    for(i = 0; i < 3; i++)
+        ok &= rfid_entry(l, uid);
+    for(i = 0; i < 20; i++)
+    {
+        l->time += i & 1;
+        ok &= long_entry(l, 'X', counts + noise(20), 40 + random_u32() % 100);
+    }
+    ok &= long_entry(l, 'S', counts, 33);
+    l->time += 3;
+    ok &= short_entry(l, 'T', 2900 + noise(40));
+    ok &= long_entry(l, 'W', counts - 180000, 640);
+    ok &= long_entry(l, 'G', counts, 33);
+    ok &= long_entry(l, 'V', 14749, 2);
+    for(i = 0; i < stay_s; i++)
+    {
+        l->time++;
+        ok &= short_entry(l, 'D', (counts + noise(600)) >> 8);
+    }
+    return ok;
+}
+
+// one FRAM region full: battery checks every 30 s, a visit now and then
+static void night(struct night *l, uint32_t seed)
+{
+    uint16_t mv = 4995;
+    uint64_t tags[2] = { 0x59004529B6ULL, 0x580053A0AFULL };
+    unsigned int i = 0;
+
+    lcg = seed;
+    l->n = 0;
+    l->time = T0;
+    short_entry(l, 'U', 0);
+    short_entry(l, 'E', 111);
+    while(1)
+    {
+        if(random_u32() % 40 == 0)
+        {
+            if(!visit(l, tags[i % 2], 150 + random_u32() % 500, 10 + random_u32() % 120))
+                break;
+        }
+        else if(!short_entry(l, 'P', mv))
+            break;
+        l->time += 30;
+        mv -= random_u32() % 50 == 0;
+        i++;
+    }
+}
+
+/* ======== SD flush ======== */
+
+static uint16_t block_len(const struct night *l, size_t i, uint16_t chunk)
+{
+    return l->n - i < chunk ? l->n - i : chunk;
+}
+
+// the 'Z' blocks of logger.c: log_send_compressed()
+static size_t flush_compressed(const uint8_t *log, size_t n, uint16_t chunk, uint8_t *out)
+{
+    size_t i, len = 0;
+
+    for(i = 0; i < n; i += chunk)
+    {
+        uint16_t m = n - i < chunk ? n - i : chunk;
+        uint16_t n_z = lzss_compress(&log[i], m, &out[len + 16], m - 1);
+        uint8_t *head = &out[len];
+        int k = sprintf((char *)head, "Z,%u,%u\n", m, n_z);
+
+        memmove(&out[len + k], &out[len + 16], n_z);
+        if(n_z == 0)
+            memcpy(&out[len + k], &log[i], m);
+        len += k + (n_z > 0 ? n_z : m);
+    }
+    return len;
+}
+
+/* ======== tests ======== */
+
+static int round_trip(const uint8_t *src, uint16_t n)
+{
+    static uint8_t packed[LZSS_MAX_OUTPUT(65535)];
+    static uint8_t unpacked[65535];
+    uint16_t n_z = lzss_compress(src, n, packed, LZSS_MAX_OUTPUT(n));
+
+    if(n_z == 0 || n_z > LZSS_MAX_OUTPUT(n))
+        return 0;
+    return lzss_decompress(packed, n_z, unpacked, n) == n && memcmp(src, unpacked, n) == 0;
+}
+
+static void test_edge_cases()
+{
+    static uint8_t data[4096];
+    uint8_t packed[LZSS_MAX_OUTPUT(64)];
+    uint8_t out[64];
+    unsigned int i;
+
+    // nothing to compress: the output is empty as well
+    CHECK_EQ(lzss_compress(data, 0, packed, sizeof(packed)), 0);
+    CHECK_EQ(lzss_decompress(packed, 0, out, sizeof(out)), 0);
+    CHECK(round_trip((const uint8_t *)"a", 1));
+    CHECK(round_trip((const uint8_t *)"abababababababababababababab", 28));
+
+    // a run: one literal, then matches of LZSS_MAX_MATCH at distance 1
+    memset(data, 0x55, sizeof(data));
+    CHECK(round_trip(data, sizeof(data)));
+    CHECK(lzss_compress(data, sizeof(data), packed, sizeof(packed)) == 0); // too small
+    CHECK_EQ(lzss_compress(data, 1000, data + 2048, 1000), 1 + 56 * 2 + 8); // 57 items, 8 flag bytes
+
+    // random bytes do not get smaller: the worst case fits, one byte less does not
+    for(i = 0; i < sizeof(data); i++)
+        data[i] = random_u32();
+    CHECK(round_trip(data, sizeof(data)));
+    CHECK_EQ(lzss_compress(data, 64, packed, LZSS_MAX_OUTPUT(64)), LZSS_MAX_OUTPUT(64));
+    CHECK_EQ(lzss_compress(data, 64, packed, LZSS_MAX_OUTPUT(64) - 1), 0);
+
+    // matches reach back LZSS_WINDOW bytes, not further
+    memcpy(&data[LZSS_WINDOW], data, 32);
+    CHECK_EQ(lzss_compress(data, LZSS_WINDOW + 32, data + 2048, 1024), LZSS_WINDOW + LZSS_WINDOW / 8 + 1 + 2 * 2);
+    memcpy(&data[LZSS_WINDOW + 1], data, 32);
+    CHECK_EQ(lzss_compress(data, LZSS_WINDOW + 33, data + 2048, 1024), LZSS_MAX_OUTPUT(LZSS_WINDOW + 33));
+    CHECK(round_trip(data, LZSS_WINDOW + 33));
+}
+
+static void test_corrupt()
+{
+    const uint8_t far[] = { 0x01, 'a', 0x05, 0x00 };     // match at distance 6 after 1 byte
+    const uint8_t cut[] = { 0x01, 'a', 0x00 };           // match without its length
+    const uint8_t run[] = { 0x01, 'a', 0x00, 0x0f };     // 18 bytes
+    uint8_t out[32];
+
+    CHECK_EQ(lzss_decompress(far, sizeof(far), out, sizeof(out)), 0);
+    CHECK_EQ(lzss_decompress(cut, sizeof(cut), out, sizeof(out)), 0);
+    CHECK_EQ(lzss_decompress(run, sizeof(run), out, sizeof(out)), 19);
+    CHECK_EQ(lzss_decompress(run, sizeof(run), out, 18), 0);  // does not fit
+}
+
+// simulated nights: every block round trips, the SD flush unpacks to the text flush
+static void test_nights()
+{
+    static struct night l;
+    static uint8_t sd[2 * NIGHT_BYTES];
+    uint32_t seed;
+    size_t n, len;
+    int wrong = 0;
+
+    for(seed = 1; seed <= 20; seed++)
+    {
+        char *expected = NULL;
+        char *text;
+        size_t expected_len;
+        size_t i;
+
+        night(&l, seed);
+        for(i = 0; i < l.n; i += SD_CHUNK)
+            if(!round_trip(&l.log[i], block_len(&l, i, SD_CHUNK)))
+                wrong++;
+
+        expected_len = log_format_entries(l.log, l.n, &expected, 0);
+        n = flush_compressed(l.log, l.n, SD_CHUNK, sd);
+        text = log_unpack(sd, n, &len);
+        if(text == NULL || len != expected_len || memcmp(text, expected, len) != 0)
+            wrong++;
+        // less than a third of the bytes of the text lines
+        if(n * 3 > expected_len)
+            wrong++;
+        free(text);
+        free(expected);
+    }
+    CHECK_EQ(wrong, 0);
+
+    // a flush cut off within a block
+    n = flush_compressed(l.log, l.n, SD_CHUNK, sd);
+    CHECK(log_unpack(sd, n - 1, &len) == NULL);
+}
+
+/* ======== benchmark ======== */
+
+static double seconds()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+
+// bytes per night as text lines, as log entries and as 'Z' blocks; MB/s of log bytes
+static void bench(uint16_t chunk)
+{
+    static struct night nights[8];
+    static uint8_t sd[2 * NIGHT_BYTES];
+    static uint8_t packed[8][LZSS_MAX_OUTPUT(NIGHT_BYTES)];
+    static uint16_t packed_len[8][NIGHT_BYTES / 8];
+    static uint8_t unpacked[NIGHT_BYTES];
+    size_t raw = 0, text = 0, z = 0;
+    unsigned long bytes = 0;
+    double compress, decompress;
+    double t0;
+    unsigned int k;
+
+    for(k = 0; k < 8; k++)
+    {
+        char *lines = NULL;
+        night(&nights[k], 100 + k);
+        raw += nights[k].n;
+        text += log_format_entries(nights[k].log, nights[k].n, &lines, 0);
+        z += flush_compressed(nights[k].log, nights[k].n, chunk, sd);
+        free(lines);
+    }
+
+    t0 = seconds();
+    do
+    {
+        for(k = 0; k < 8; k++)
+        {
+            size_t i, b = 0, out = 0;
+            for(i = 0; i < nights[k].n; i += chunk, b++)
+            {
+                packed_len[k][b] = lzss_compress(&nights[k].log[i], block_len(&nights[k], i, chunk),
+                                                 &packed[k][out], LZSS_MAX_OUTPUT(chunk));
+                out += packed_len[k][b];
+            }
+            bytes += nights[k].n;
+        }
+    } while(seconds() - t0 < BENCH_SECONDS);
+    compress = bytes / (seconds() - t0) / 1e6;
+
+    bytes = 0;
+    t0 = seconds();
+    do
+    {
+        for(k = 0; k < 8; k++)
+        {
+            size_t i, b = 0, in = 0;
+            for(i = 0; i < nights[k].n; i += chunk, b++)
+            {
+                lzss_decompress(&packed[k][in], packed_len[k][b], unpacked, block_len(&nights[k], i, chunk));
+                in += packed_len[k][b];
+            }
+            bytes += nights[k].n;
+        }
+    } while(seconds() - t0 < BENCH_SECONDS);
+    decompress = bytes / (seconds() - t0) / 1e6;
+
+    printf("%5u B  %6zu %6zu %6zu    %5.2f %5.2f   %7.1f %7.1f\n", chunk, text / 8, raw / 8, z / 8,
+           (double)z / raw, (double)z / text, compress, decompress);
+}
+
+int main(int argc, char **argv)
+{
+    if(argc > 1 && strcmp(argv[1], "-b") == 0)
+    {
+        printf("%7s  %20s    %11s   %15s\n", "", "bytes per night", "Z bytes /", "MB/s");
+        printf("%7s  %6s %6s %6s    %5s %5s   %7s %7s\n", "block", "text", "log", "Z", "log", "text",
+               "compr.", "decomp.");
+        bench(96);
+        bench(SD_CHUNK);
+        bench(1024);
+        bench(NIGHT_BYTES);
+        return 0;
+    }
+
+    test_edge_cases();
+    test_corrupt();
+    test_nights();
+
+    return test_summary("test_lzss");
+}
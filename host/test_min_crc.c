@@ -0,0 +1,310 @@
+/*
+ * test_min_crc.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Host test of the CRC32 variants of MIN (fw/min/min.c): built once per variant
+ *  (test_min_crc_bitwise, test_min_crc_table, test_min_crc_slice4), each is checked
+ *  against a reference CRC32 here: check value, blocks of all lengths and alignments,
+ *  byte steps followed by a block (the transmit path), frames on the wire, and queued
+ *  transport frames that wrap around in the payload ring buffer, received by a second
+ *  context.
+ *
+ *    test_min_crc_<variant> -b   checksum throughput (MB/s) of the variant on this host,
+ *                                for payload blocks (transmit) and byte steps (receive)
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+#include "../fw/min/min.c"
+
+#if defined(MIN_CRC32_BITWISE)
+#define VARIANT         "bitwise"
+#elif defined(MIN_CRC32_SLICE_BY_4)
+#define VARIANT         "slice-by-4"
+#else
+#define VARIANT         "table"
+#endif
+
+#define WIRE_SIZE       8192
+#define BENCH_SIZE      (1 << 20)
+#define BENCH_SECONDS   0.3
+
+UART_Handle wifi_uart;
+
+static uint8_t wire[WIRE_SIZE];
+static size_t wire_len = 0;
+static uint32_t ticks = 0;
+
+static uint8_t received[64][MAX_PAYLOAD];
+static uint8_t received_len[64];
+static unsigned int n_received = 0;
+
+int uart_serial_putc(UART_Handle *dev, uint8_t c)
+{
+    (void)dev;
+    if(wire_len < WIRE_SIZE)
+        wire[wire_len++] = c;
+    return 1;
+}
+
+uint32_t uart_wifi_get_baudrate()
+{
+    return 115200;
+}
+
+UInt32 Clock_getTicks()
+{
+    return ticks;
+}
+
+void min_application_handler(uint8_t min_id, uint8_t *min_payload, uint8_t len_payload, uint8_t port)
+{
+    (void)min_id;
+    (void)port;
+    if(n_received < 64)
+    {
+        memcpy(received[n_received], min_payload, len_payload);
+        received_len[n_received++] = len_payload;
+    }
+}
+
+static uint32_t lcg = 1;
+
+static uint8_t random_byte()
+{
+    lcg = lcg * 1103515245U + 12345U;
+    return (uint8_t)(lcg >> 16);
+}
+
+// reference: reflected polynomial 0xedb88320, bit by bit
+static uint32_t reference_crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xffffffffU;
+    size_t i;
+    int k;
+
+    for(i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for(k = 0; k < 8; k++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320U : crc >> 1;
+    }
+    return ~crc;
+}
+
+static uint32_t block_crc32(const uint8_t *data, uint16_t len)
+{
+    struct crc32_context c;
+
+    crc32_init_context(&c);
+    crc32_block(&c, data, len);
+    return crc32_finalize(&c);
+}
+
+static void test_check_value()
+{
+    const uint8_t check[] = "123456789";
+
+    CHECK_EQ(reference_crc32(check, 9), 0xcbf43926U);
+    CHECK_EQ(block_crc32(check, 9), 0xcbf43926U);
+    CHECK_EQ(block_crc32(check, 0), 0);
+}
+
+// all lengths of a frame at all alignments (slice-by-4 has a 4 byte main loop and a tail)
+static void test_blocks()
+{
+    uint8_t data[MAX_PAYLOAD + 8];
+    unsigned int len, offset, i;
+    int wrong = 0;
+
+    for(i = 0; i < sizeof(data); i++)
+        data[i] = random_byte();
+    for(offset = 0; offset < 4; offset++)
+        for(len = 0; len <= MAX_PAYLOAD; len++)
+            if(block_crc32(&data[offset], len) != reference_crc32(&data[offset], len))
+                wrong++;
+    CHECK_EQ(wrong, 0);
+}
+
+// header bytes one by one, then the payload in two blocks (ring buffer wrap)
+static void test_steps_then_blocks()
+{
+    uint8_t data[MAX_PAYLOAD + 3];
+    unsigned int len, split, i;
+    int wrong = 0;
+
+    for(i = 0; i < sizeof(data); i++)
+        data[i] = random_byte();
+    for(len = 0; len <= MAX_PAYLOAD; len += 7)
+    {
+        for(split = 0; split <= len; split += 5)
+        {
+            struct crc32_context c;
+            crc32_init_context(&c);
+            for(i = 0; i < 3; i++)
+                crc32_step(&c, data[i]);
+            crc32_block(&c, &data[3], split);
+            crc32_block(&c, &data[3 + split], len - split);
+            if(crc32_finalize(&c) != reference_crc32(data, 3 + len))
+                wrong++;
+        }
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+// remove the stuff bytes after two header bytes in a frame body
+static size_t unstuff(const uint8_t *in, size_t n, uint8_t *out)
+{
+    size_t i, m = 0;
+    int headers = 0;
+
+    for(i = 0; i < n; i++)
+    {
+        if(headers == 2 && in[i] == STUFF_BYTE)
+        {
+            headers = 0;
+            continue;
+        }
+        headers = in[i] == HEADER_BYTE ? headers + 1 : 0;
+        out[m++] = in[i];
+    }
+    return m;
+}
+
+// the checksum on the wire is the reference CRC of ID, length and payload (big endian)
+static void test_wire()
+{
+    struct min_context tx;
+    uint8_t payload[MAX_PAYLOAD];
+    uint8_t body[WIRE_SIZE];
+    unsigned int len;
+    int wrong = 0;
+
+    min_init_context(&tx, 0);
+    for(len = 0; len <= MAX_PAYLOAD; len += 17)
+    {
+        size_t n, i;
+        uint32_t crc;
+        for(i = 0; i < len; i++)
+            payload[i] = (i % 5 == 0) ? HEADER_BYTE : random_byte(); // some stuffing
+        wire_len = 0;
+        min_send_frame(&tx, 0x21, payload, (uint8_t)len);
+        // header (3), body, EOF
+        n = unstuff(wire + 3, wire_len - 4, body);
+        crc = ((uint32_t)body[n-4] << 24) | ((uint32_t)body[n-3] << 16) | ((uint32_t)body[n-2] << 8) | body[n-1];
+        if(n != len + 6 || crc != reference_crc32(body, n - 4) || memcmp(body + 2, payload, len) != 0)
+            wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+// transport frames through the payload ring buffer (wraps after 512 bytes) to a receiver
+static void test_transport()
+{
+    static uint8_t sent[40][MAX_PAYLOAD];
+    static uint8_t sent_len[40];
+    struct min_context tx, rx;
+    uint8_t out[WIRE_SIZE];
+    size_t n;
+    unsigned int i, k;
+    int wrong = 0;
+
+    min_init_context(&tx, 0);
+    min_init_context(&rx, 1);
+    wire_len = 0;
+    n_received = 0;
+
+    for(i = 0; i < 40; i++)
+    {
+        sent_len[i] = 1 + random_byte() % MAX_PAYLOAD;
+        for(k = 0; k < sent_len[i]; k++)
+            sent[i][k] = random_byte();
+        CHECK(min_queue_frame(&tx, 0x12, sent[i], sent_len[i]));
+
+        // sender puts the frame on the wire, the receiver answers with an ACK
+        ticks += 10;
+        min_poll(&tx, NULL, 0);
+        n = wire_len;
+        memcpy(out, wire, n);
+        wire_len = 0;
+        min_poll(&rx, out, n);
+        n = wire_len;
+        memcpy(out, wire, n);
+        wire_len = 0;
+        min_poll(&tx, out, n);
+        wire_len = 0;
+    }
+
+    CHECK_EQ(n_received, 40);
+    CHECK_EQ(rx.transport_fifo.sequence_mismatch_drop, 0);
+    for(i = 0; i < n_received && i < 40; i++)
+        if(received_len[i] != sent_len[i] || memcmp(received[i], sent[i], sent_len[i]) != 0)
+            wrong++;
+    CHECK_EQ(wrong, 0);
+}
+
+static double seconds()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// MB/s over 1 MB in chunks of one payload (blocks), or byte by byte (steps)
+static void bench(unsigned int chunk, int steps)
+{
+    static uint8_t data[BENCH_SIZE];
+    volatile uint32_t sink = 0;
+    unsigned long bytes = 0;
+    double t0 = seconds();
+    double t;
+    unsigned int i;
+
+    for(i = 0; i < BENCH_SIZE; i++)
+        data[i] = random_byte();
+    do
+    {
+        struct crc32_context c;
+        crc32_init_context(&c);
+        for(i = 0; i + chunk <= BENCH_SIZE; i += chunk)
+        {
+            if(steps)
+            {
+                unsigned int k;
+                for(k = 0; k < chunk; k++)
+                    crc32_step(&c, data[i + k]);
+            }
+            else
+                crc32_block(&c, &data[i], chunk);
+        }
+        sink ^= crc32_finalize(&c);
+        bytes += i;
+        t = seconds() - t0;
+    } while(t < BENCH_SECONDS);
+
+    printf("%-11s %-6s %4u B  %8.1f MB/s\n", VARIANT, steps ? "steps" : "blocks", chunk, bytes / t / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+    if(argc > 1 && strcmp(argv[1], "-b") == 0)
+    {
+        bench(16, 0);
+        bench(MAX_PAYLOAD, 0);
+        bench(MAX_PAYLOAD, 1);
+        return 0;
+    }
+
+    test_check_value();
+    test_blocks();
+    test_steps_then_blocks();
+    test_wire();
+    test_transport();
+
+    return test_summary("test_min_crc (" VARIANT ")");
+}
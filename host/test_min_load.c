@@ -0,0 +1,205 @@
+/*
+ * test_min_load.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Load test of the wifi command handler (fw/wifi_commands.c) and the MIN link against
+ *  the host MIN peer (min_peer.h): scripted and random command mixes and log downloads,
+ *  on a clean link and with lost and damaged frames. Every command must be answered (the
+ *  ESP sends it again after a timeout), every download must arrive complete and in order.
+ *
+ *    test_min_load -b   round trip percentiles and resend / retransmit rates per link
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "min_peer.h"
+
+#define LOG_BYTES       8064    // 672 log entries, 32 'g' frames
+#define RANDOM_COMMANDS 2000
+
+// the commands that only read (no WRITE_REQ), as the app polls them
+static const char read_commands[] = "HZSBWODRfQAPEK";
+
+static uint8_t log_bytes[LOG_BYTES];
+static uint8_t received[MIN_PEER_MAX_LOG];
+static uint32_t lcg = 7;
+
+static uint32_t random_below(uint32_t n)
+{
+    lcg = lcg * 1103515245U + 12345U;
+    return ((lcg >> 8) & 0xffffffU) % n;
+}
+
+// long 'W' entries of logger.c: time, 'W', 16 bit, 32 bit weight
+static void make_log()
+{
+    uint32_t t = 1792346400U;
+    unsigned int i;
+
+    for(i = 0; i + 12 <= LOG_BYTES; i += 12)
+    {
+        uint32_t weight = 170000U + random_below(20000);
+        t += 20 + random_below(600);
+        memcpy(&log_bytes[i], &t, 4);
+        log_bytes[i + 4] = 'W';
+        log_bytes[i + 5] = 0;
+        log_bytes[i + 6] = random_below(256);
+        log_bytes[i + 7] = 0;
+        memcpy(&log_bytes[i + 8], &weight, 4);
+    }
+}
+
+static void link_init(uint32_t baudrate, unsigned int drop, unsigned int corrupt)
+{
+    struct min_peer_link link = { baudrate, drop, corrupt, 1, 0 };
+
+    min_peer_init(&link, log_bytes, LOG_BYTES);
+}
+
+static int random_command()
+{
+    uint8_t cmd[8];
+    uint8_t answer[MAX_PAYLOAD];
+    uint8_t len = 1 + random_below(3);
+    unsigned int i;
+
+    cmd[0] = read_commands[random_below(sizeof(read_commands) - 1)];
+    for(i = 1; i < len; i++)
+        cmd[i] = random_below(8); // e.g. the parameter number of 'P'
+    return min_peer_command(cmd, len, answer) > 0 && answer[0] == cmd[0];
+}
+
+// every read command once on a clean link: answered at once
+static void test_scripted()
+{
+    struct min_peer_stats stats;
+    uint8_t answer[MAX_PAYLOAD];
+    int wrong = 0;
+    unsigned int i;
+
+    link_init(115200, 0, 0);
+    for(i = 0; read_commands[i] != '\0'; i++)
+    {
+        uint8_t cmd = read_commands[i];
+        if(min_peer_command(&cmd, 1, answer) <= 0 || answer[0] != cmd)
+            wrong++;
+    }
+    min_peer_get_stats(&stats);
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(stats.commands, strlen(read_commands));
+    CHECK_EQ(stats.resent, 0);
+    CHECK(min_peer_latency_percentile(100) < 20);
+    CHECK_EQ(min_peer_nestbox()->rx_checksum_errors, 0);
+}
+
+// 2 % of the frames lost and 2 % damaged, each way: the resends hide it
+static void test_random_lossy()
+{
+    struct min_peer_stats stats;
+    int answered = 0;
+    unsigned int i;
+
+    link_init(115200, 20, 20);
+    for(i = 0; i < RANDOM_COMMANDS; i++)
+        answered += random_command();
+    min_peer_get_stats(&stats);
+
+    CHECK_EQ(answered, RANDOM_COMMANDS);
+    CHECK_EQ(stats.lost, 0);
+    CHECK_EQ(stats.wrong, 0);
+    // a command or its answer is lost or damaged in about 8 % of the round trips
+    CHECK(stats.resent > RANDOM_COMMANDS / 50 && stats.resent < RANDOM_COMMANDS / 6);
+    CHECK(min_peer_latency_percentile(50) < 10);
+    CHECK(min_peer_latency_percentile(99) >= 100 && min_peer_latency_percentile(99) < 400);
+    CHECK(min_peer_nestbox()->rx_checksum_errors > 0);
+    CHECK(min_peer_esp()->rx_checksum_errors > 0);
+}
+
+// a clean link at 9600 baud: no frame is sent twice (retransmit timeout from the wire time)
+static void test_download_clean()
+{
+    link_init(9600, 0, 0);
+    memset(received, 0, sizeof(received));
+    CHECK_EQ(min_peer_download(0, 0, 0, received), LOG_BYTES);
+    CHECK(memcmp(received, log_bytes, LOG_BYTES) == 0);
+    CHECK_EQ(min_peer_nestbox()->transport_fifo.retransmits, 0);
+    CHECK_EQ(min_peer_esp()->transport_fifo.sequence_mismatch_drop, 0);
+}
+
+// lost and damaged frames, raw and compressed: complete, in order, a few retransmits
+static void test_download_lossy()
+{
+    int compressed;
+
+    for(compressed = 0; compressed <= 1; compressed++)
+    {
+        struct min_context *nestbox;
+        link_init(115200, 20, 20);
+        memset(received, 0, sizeof(received));
+        CHECK_EQ(min_peer_download(0, 0, compressed, received), LOG_BYTES);
+        CHECK(memcmp(received, log_bytes, LOG_BYTES) == 0);
+
+        nestbox = min_peer_nestbox();
+        CHECK(nestbox->transport_fifo.retransmits > 0);
+        CHECK(nestbox->transport_fifo.retransmits < min_peer_nestbox_frames() / 4);
+    }
+
+    // resumed from an offset
+    link_init(115200, 20, 20);
+    memset(received, 0, sizeof(received));
+    CHECK_EQ(min_peer_download(1200, 2400, 1, received), 1200);
+    CHECK(memcmp(&received[1200], &log_bytes[1200], 1200) == 0);
+}
+
+static void report(uint32_t baudrate, unsigned int loss)
+{
+    struct min_peer_stats stats;
+    struct min_context *nestbox;
+    unsigned int i;
+    uint32_t t0;
+    int n;
+
+    link_init(baudrate, loss, loss);
+    for(i = 0; i < RANDOM_COMMANDS; i++)
+        random_command();
+    min_peer_get_stats(&stats);
+
+    t0 = min_peer_now();
+    n = min_peer_download(0, 0, 0, received);
+    nestbox = min_peer_nestbox();
+
+    printf("%6lu baud %4.1f%% lost %4.1f%% damaged  commands p50 %4lu ms p99 %4lu ms max %4lu ms resent %5.2f%% lost %lu"
+           "  download %s %6.2f s retransmits %5.2f%%\n",
+           (unsigned long)baudrate, loss / 10.0, loss / 10.0,
+           (unsigned long)min_peer_latency_percentile(50), (unsigned long)min_peer_latency_percentile(99),
+           (unsigned long)min_peer_latency_percentile(100), 100.0 * stats.resent / RANDOM_COMMANDS,
+           (unsigned long)stats.lost, n == LOG_BYTES ? "ok" : "FAILED", (min_peer_now() - t0) / 1000.0,
+           100.0 * nestbox->transport_fifo.retransmits / min_peer_nestbox_frames());
+}
+
+int main(int argc, char **argv)
+{
+    make_log();
+
+    if(argc > 1 && strcmp(argv[1], "-b") == 0)
+    {
+        static const uint32_t rates[] = { 9600, 115200 };
+        static const unsigned int losses[] = { 0, 10, 50 };
+        unsigned int r, l;
+
+        for(r = 0; r < 2; r++)
+            for(l = 0; l < 3; l++)
+                report(rates[r], losses[l]);
+        return 0;
+    }
+
+    test_scripted();
+    test_random_lossy();
+    test_download_clean();
+    test_download_lossy();
+
+    return test_summary("test_min_load");
+}
@@ -0,0 +1,175 @@
+/*
+ * test_segment.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Host test of the perch event segmentation (fw/load_cell_segment.c) with synthetic
+ *  series of averaged samples: a sitting bird, a second bird landing, a hop off and
+ *  back, a step of a few grams, and noise that must not split a segment. The 'G'
+ *  entries go to the stub of log_write_new_weight_entry() below.
+ */
+
+#include "test.h"
+#include "load_cell_segment.h"
+
+#define EMPTY               180000  // zero offset, raw ADC units
+#define BIRD                178000  // 162 g
+#define SECOND_BIRD         653000  // 595 g
+#define MAX_ENTRIES         16
+
+static struct {
+    uint8_t logchar;
+    int32_t mean;
+    uint16_t spread;
+} entries[MAX_ENTRIES];
+static int n_entries = 0;
+
+static uint32_t lcg = 1;
+
+int log_write_new_weight_entry(uint8_t logchar, uint32_t weight, uint16_t stdev)
+{
+    if(n_entries < MAX_ENTRIES)
+    {
+        entries[n_entries].logchar = logchar;
+        entries[n_entries].mean = (int32_t)weight;
+        entries[n_entries].spread = stdev;
+    }
+    n_entries++;
+    return 0;
+}
+
+static int32_t noise(int32_t amplitude)
+{
+    lcg = lcg * 1103515245U + 12345U;
+    return (int32_t)((lcg >> 16) % (2*amplitude + 1)) - amplitude;
+}
+
+static void event_start()
+{
+    n_entries = 0;
+    segment_reset();
+}
+
+static void samples(int n, int32_t level, int32_t amplitude)
+{
+    int i;
+    for(i = 0; i < n; i++)
+        segment_add_sample(level + (amplitude ? noise(amplitude) : 0));
+}
+
+static void one_bird()
+{
+    event_start();
+    samples(20, EMPTY + BIRD, 0);
+    CHECK_EQ(n_entries, 0); // logged at the end of the event
+    segment_flush();
+
+    CHECK_EQ(n_entries, 1);
+    CHECK_EQ(entries[0].logchar, 'G');
+    CHECK_EQ(entries[0].mean, EMPTY + BIRD);
+    CHECK_EQ(entries[0].spread, 0);
+}
+
+// the step sample starts the new segment: neither mean has a sample of the other weight
+static void second_bird_lands()
+{
+    event_start();
+    samples(10, EMPTY + BIRD, 0);
+    samples(10, EMPTY + BIRD + SECOND_BIRD, 0);
+    CHECK_EQ(n_entries, 1); // the first segment is closed by the step
+    segment_flush();
+
+    CHECK_EQ(n_entries, 2);
+    CHECK_EQ(entries[0].mean, EMPTY + BIRD);
+    CHECK_EQ(entries[1].mean, EMPTY + BIRD + SECOND_BIRD);
+    CHECK_EQ(entries[1].spread, 0);
+
+    // and leaves again
+    event_start();
+    samples(8, EMPTY + BIRD + SECOND_BIRD, 0);
+    samples(8, EMPTY + BIRD, 0);
+    segment_flush();
+    CHECK_EQ(n_entries, 2);
+    CHECK_EQ(entries[0].mean, EMPTY + BIRD + SECOND_BIRD);
+    CHECK_EQ(entries[1].mean, EMPTY + BIRD);
+}
+
+// 2 samples off the perch are too short for a segment of their own
+static void hop()
+{
+    event_start();
+    samples(8, EMPTY + BIRD, 0);
+    samples(2, EMPTY, 0);
+    samples(8, EMPTY + BIRD, 0);
+    segment_flush();
+
+    CHECK_EQ(n_entries, 2);
+    CHECK_EQ(entries[0].mean, EMPTY + BIRD);
+    CHECK_EQ(entries[1].mean, EMPTY + BIRD);
+}
+
+// noise and steps below SEGMENT_DRIFT do not accumulate
+static void noise_is_no_step()
+{
+    event_start();
+    samples(30, EMPTY + BIRD, 400);
+    samples(30, EMPTY + BIRD + 300, 400);
+    segment_flush();
+
+    CHECK_EQ(n_entries, 1);
+    CHECK_NEAR(entries[0].mean, EMPTY + BIRD + 150, 150);
+    CHECK(entries[0].spread > 0 && entries[0].spread <= 1100);
+}
+
+// a step of a few grams (3000 units) accumulates: found at its third sample, the first
+// segment keeps two samples of the new weight
+static void small_step()
+{
+    event_start();
+    samples(10, EMPTY + BIRD, 0);
+    samples(10, EMPTY + BIRD + 3000, 0);
+    segment_flush();
+
+    CHECK_EQ(n_entries, 2);
+    CHECK_EQ(entries[0].mean, EMPTY + BIRD + 2*3000/12);
+    CHECK_EQ(entries[0].spread, 3000);
+    CHECK_EQ(entries[1].mean, EMPTY + BIRD + 3000);
+}
+
+static void short_event()
+{
+    event_start();
+    samples(3, EMPTY + BIRD, 0);
+    segment_flush();
+    CHECK_EQ(n_entries, 0);
+
+    // reset drops the running segment
+    event_start();
+    samples(10, EMPTY + BIRD, 0);
+    segment_reset();
+    segment_flush();
+    CHECK_EQ(n_entries, 0);
+
+    // the spread is max - min of the segment
+    event_start();
+    samples(2, EMPTY + BIRD, 0);
+    samples(1, EMPTY + BIRD + 1500, 0);
+    samples(2, EMPTY + BIRD - 1500, 0);
+    segment_flush();
+    CHECK_EQ(n_entries, 1);
+    CHECK_EQ(entries[0].mean, EMPTY + BIRD - 1500/5);
+    CHECK_EQ(entries[0].spread, 3000);
+}
+
+int main()
+{
+    one_bird();
+    second_bird_lands();
+    hop();
+    noise_is_no_step();
+    small_step();
+    short_event();
+
+    return test_summary("test_segment");
+}
@@ -0,0 +1,361 @@
+/*
+ * test_sim.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  main.c and all tasks on the host platform (platform/sim.h), in virtual time: start up,
+ *  log flush to the SD logger with the user button, daytime pause and resume at the RTC
+ *  alarm, birds on the perch (tag and weight), fast forward. Each run needs a fresh
+ *  process (the firmware state is global), so the runs are forked; the child reports what
+ *  the SD logger stored (compressed flushes unpacked, platform/log_unpack.h).
+ *  test_sim_event_loop is the same with the firmware built with USE_EVENT_LOOP=1.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "test.h"
+#include "sim.h"
+#include "models.h"
+#include "scenario.h"
+#include "log_unpack.h"
+
+#define T0              1792346400UL    // 18 Oct 2026 18:00 UTC
+
+#ifndef VARIANT
+#define VARIANT         "tasks"         // test_sim_event_loop: "event loop" (USE_EVENT_LOOP)
+#endif
+
+int nestbox_main(void);
+
+struct run {
+    const char *scenario;       // scenario file text (platform/scenario.h)
+    int ticked;                 // every tick instead of fast forward
+};
+
+static void child(const struct run *run, int fd)
+{
+    struct scenario s;
+    struct power_report power;
+    const char *reason;
+    const uint8_t *data;
+    char *text;
+    size_t n, len;
+    char head[256];
+
+    if(scenario_parse(&s, run->scenario) != 0)
+        _exit(2);
+    sim_set_fast_forward(!run->ticked);
+    scenario_start(&s);
+
+    nestbox_main();
+
+    reason = sim_halt_reason();
+    data = (const uint8_t *)sd_logger_data(&n);
+    text = log_unpack(data, n, &len);
+    if(text == NULL)
+        _exit(2);
+    power_sim_report(&power_model_default, &power);
+    snprintf(head, sizeof(head), "halt=%s sessions=%u garbled=%zu\n"
+             "power pause_ms=%llu 5v_ms=%llu sd_ms=%llu adc_ms=%llu\n"
+             "sd bytes=%zu\n",
+             reason ? reason : "none", sd_logger_sessions(), sd_logger_garbled(),
+             (unsigned long long)power.us[POWER_PAUSE] / 1000, (unsigned long long)power.us[POWER_5V] / 1000,
+             (unsigned long long)power.us[POWER_SD_CARD] / 1000,
+             (unsigned long long)power.us[POWER_ADS_CONVERTING] / 1000, n);
+    if(write(fd, head, strlen(head)) < 0 || write(fd, text, len) < 0)
+        _exit(2);
+    _exit(0);
+}
+
+// report of the child: the simulation state, the time in some power states, the bytes
+// the SD logger received, then the SD card content as text
+static char *run_sim(const struct run *run)
+{
+    int fds[2];
+    pid_t pid;
+    char *out = NULL;
+    size_t len = 0;
+    char buf[4096];
+    ssize_t r;
+
+    fflush(stdout);
+    if(pipe(fds) != 0 || (pid = fork()) < 0)
+        abort();
+    if(pid == 0)
+    {
+        close(fds[0]);
+        child(run, fds[1]);
+    }
+    close(fds[1]);
+    while((r = read(fds[0], buf, sizeof(buf))) > 0)
+    {
+        out = realloc(out, len + r + 1);
+        memcpy(out + len, buf, r);
+        len += r;
+        out[len] = '\0';
+    }
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    if(out == NULL)
+        out = strdup("");
+    if(getenv("TEST_VERBOSE"))
+        printf("%s", out);
+    return out;
+}
+
+// number of log lines with the entry character and value
+static int count_entries(const char *report, char c, long value)
+{
+    const char *p = report;
+    int n = 0;
+
+    while((p = strchr(p, '\n')) != NULL)
+    {
+        unsigned long t;
+        long v;
+        char lc;
+        p++;
+        if(sscanf(p, "%c,%lu,%ld", &lc, &t, &v) == 3 && lc == c && (value < 0 || v == value))
+            n++;
+    }
+    return n;
+}
+
+// number of log lines with the entry character in the time range [from, to)
+static int count_between(const char *report, char c, unsigned long from, unsigned long to)
+{
+    const char *p = report;
+    int n = 0;
+
+    while((p = strchr(p, '\n')) != NULL)
+    {
+        unsigned long t;
+        char lc;
+        p++;
+        if(sscanf(p, "%c,%lu,", &lc, &t) == 2 && lc == c && t >= from && t < to)
+            n++;
+    }
+    return n;
+}
+
+// time stamp of the first log line with the entry character and value, 0 if none
+static unsigned long entry_time(const char *report, char c, long value)
+{
+    const char *p = report;
+
+    while((p = strchr(p, '\n')) != NULL)
+    {
+        unsigned long t;
+        long v;
+        char lc;
+        p++;
+        if(sscanf(p, "%c,%lu,%ld", &lc, &t, &v) == 3 && lc == c && v == value)
+            return t;
+    }
+    return 0;
+}
+
+// value of the first log line with the entry character in the time range [from, to), -1 if none
+static long value_between(const char *report, char c, unsigned long from, unsigned long to)
+{
+    const char *p = report;
+
+    while((p = strchr(p, '\n')) != NULL)
+    {
+        unsigned long t;
+        long v;
+        char lc;
+        p++;
+        if(sscanf(p, "%c,%lu,%ld", &lc, &t, &v) == 3 && lc == c && t >= from && t < to)
+            return v;
+    }
+    return -1;
+}
+
+// time in a power state of the report (power_sim_report()), ms
+static long power_ms(const char *report, const char *state)
+{
+    char key[32];
+    const char *p;
+
+    snprintf(key, sizeof(key), " %s_ms=", state);
+    p = strstr(report, key);
+    return p != NULL ? strtol(p + strlen(key), NULL, 10) : -1;
+}
+
+// bytes the SD logger received
+static long sd_bytes(const char *report)
+{
+    const char *p = strstr(report, "\nsd bytes=");
+
+    return p != NULL ? strtol(p + 10, NULL, 10) : -1;
+}
+
+// number of tag entries with the id
+static int count_tags(const char *report, const char *id)
+{
+    char line[32];
+    const char *p = report;
+    int n = 0;
+
+    snprintf(line, sizeof(line), ",%s\n", id);
+    while((p = strstr(p, "\nR,")) != NULL)
+    {
+        p++;
+        if(strncmp(strchr(p + 2, ','), line, strlen(line)) == 0)
+            n++;
+    }
+    return n;
+}
+
+static void test_startup_and_flush()
+{
+    struct run run = { "start 1792346400\n"
+                       "duration 10m\n"
+                       "button 5m\n", 0 };
+    char *report = run_sim(&run);
+
+    CHECK(strncmp(report, "halt=none sessions=1 garbled=0\n", 31) == 0);
+    // start up entry right after the 2 s start up delay, at the right time of day
+    CHECK_EQ(count_entries(report, 'E', 111), 1);
+    CHECK_NEAR(entry_time(report, 'E', 111), T0 + 2, 1);
+    // battery measurement at start up (5 V simulated battery)
+    CHECK(count_entries(report, 'P', -1) >= 1);
+    CHECK(strstr(report, "\nH,") != NULL);
+    free(report);
+}
+
+// night shift until the pause at 8:00 UTC, resume alarm at 16:00, flush at 16:20
+static void test_pause_and_resume()
+{
+    struct run run = { "start 2026-10-19 07:40:00\n"
+                       "duration 9h\n"
+                       "button 8h40m\n", 0 };
+    char *report = run_sim(&run);
+    unsigned long pause;
+    unsigned long resume;
+
+    CHECK(strncmp(report, "halt=none sessions=2 garbled=0\n", 31) == 0);
+    CHECK_EQ(count_entries(report, 'E', 111), 1);
+    // the end of the night shift flushes the log: pause at the next battery check
+    pause = entry_time(report, 'E', 0);
+    CHECK(pause >= T0 + 14*3600 && pause < T0 + 14*3600 + 60);
+    // no battery checks while paused, the RTC alarm resumes on the minute
+    resume = entry_time(report, 'E', 1);
+    CHECK_NEAR(resume, T0 + 22*3600, 1);
+    CHECK_EQ(count_between(report, 'P', pause, resume), 0);
+    CHECK(count_between(report, 'P', resume, resume + 60) >= 2);
+    // the tick is stopped while paused (after the flush that follows the E entry)
+    CHECK_NEAR(power_ms(report, "pause"), (resume - pause) * 1000, 10000);
+    free(report);
+}
+
+// a bird on the perch starts the reader, its tag is read and the weight measured
+static void test_visits()
+{
+    struct run run = { "start 1792346400\n"
+                       "duration 40m\n"
+                       "visit 10m 60s 59004529B6 162\n"
+                       "visit 20m 3m 580053A0AF 595\n"
+                       "button 35m\n", 0 };
+    char *report = run_sim(&run);
+
+    CHECK(strncmp(report, "halt=none ", 10) == 0 && strstr(report, " garbled=0\n") != NULL);
+    CHECK(count_tags(report, "59004529B6") >= 1);
+    CHECK(count_tags(report, "580053A0AF") >= 1);
+    CHECK_EQ(count_entries(report, 'R', -1), count_tags(report, "59004529B6") + count_tags(report, "580053A0AF"));
+    // 1098.9 ADC counts per gram (params.c) above the zero offset, within 0.5 g (ADC noise)
+    CHECK_NEAR(value_between(report, 'W', T0 + 600, T0 + 660), 178021, 550);
+    CHECK_NEAR(value_between(report, 'W', T0 + 1200, T0 + 1380), 653845, 550);
+    CHECK_EQ(count_entries(report, 'W', -1), 2);
+    // power states: the reader is on for the RFID windows, the ADC for the series and the
+    // polls (1 ms per second), the SD card for the flushes
+    CHECK(power_ms(report, "5v") >= 200 && power_ms(report, "5v") < 10000);
+    CHECK(power_ms(report, "adc") > 2400 + 20000 && power_ms(report, "adc") < 2400 + 300000);
+    CHECK(power_ms(report, "sd") > 0);
+    CHECK_EQ(power_ms(report, "pause"), 0);
+    free(report);
+}
+
+// fast forward skips the ticks that wake up no task: the firmware cannot tell
+static void test_fast_forward()
+{
+    const char *scenario = "start 2026-10-19 07:30:00\n"
+                           "duration 40m\n"
+                           "visit 5m 90s 59004529B6 162\n"
+                           "battery 0 4800\n"
+                           "battery 40m 4700\n"
+                           "button 38m\n";
+    struct run ticked = { scenario, 1 };
+    struct run fast = { scenario, 0 };
+    char *a = run_sim(&ticked);
+    char *b = run_sim(&fast);
+
+    CHECK(count_entries(a, 'W', -1) == 1);
+    CHECK(count_entries(a, 'E', 0) == 1); // the pause at 8:00 stops the tick, the button resumes
+    CHECK(strcmp(a, b) == 0);
+    free(a);
+    free(b);
+}
+
+// the compressed flush ('Z' blocks) unpacks to the lines of the text flush, in fewer bytes
+static void test_compressed_flush()
+{
+    const char *scenario = "start 1792346400\n"
+                           "duration 2h\n"
+                           "visit 10m 2m 59004529B6 162\n"
+                           "visit 40m 3m 580053A0AF 595\n"
+                           "visit 70m 1m 59004529B6 164\n"
+                           "button 1h50m\n";
+    char *compressed_scenario = malloc(strlen(scenario) + 32);
+    struct run text = { scenario, 0 };
+    struct run compressed = { compressed_scenario, 0 };
+    char *a, *b;
+
+    sprintf(compressed_scenario, "%sparam sd_compress 1\n", scenario);
+    a = run_sim(&text);
+    b = run_sim(&compressed);
+
+    // the FRAM log is flushed when a half is full, and at the button
+    CHECK(strncmp(a, "halt=none sessions=3 garbled=0\n", 31) == 0);
+    CHECK(strncmp(b, "halt=none sessions=3 garbled=0\n", 31) == 0);
+    CHECK(count_entries(a, 'P', -1) > 200);
+    CHECK(count_entries(a, 'W', -1) == 3);
+    CHECK(strstr(a, "\nH,") != NULL && strstr(b, "\nH,") != NULL);
+    CHECK(strcmp(strstr(a, "\nH,"), strstr(b, "\nH,")) == 0);
+    CHECK(sd_bytes(b) > 0 && sd_bytes(b) < sd_bytes(a) / 2);
+    CHECK(power_ms(b, "sd") < power_ms(a, "sd"));
+    free(a);
+    free(b);
+    free(compressed_scenario);
+}
+
+// one task runs at a time and all time is virtual: the same run gives the same bytes
+static void test_deterministic()
+{
+    struct run run = { "start 1792346400\n"
+                       "duration 15m\n"
+                       "visit 5m 30s 59004529B6 162\n"
+                       "button 10m\n", 0 };
+    char *a = run_sim(&run);
+    char *b = run_sim(&run);
+
+    CHECK(strlen(a) > 100);
+    CHECK(strcmp(a, b) == 0);
+    free(a);
+    free(b);
+}
+
+int main()
+{
+    test_startup_and_flush();
+    test_pause_and_resume();
+    test_visits();
+    test_fast_forward();
+    test_compressed_flush();
+    test_deterministic();
+    return test_summary("test_sim (" VARIANT ")");
+}
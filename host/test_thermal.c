@@ -0,0 +1,106 @@
+/*
+ * test_thermal.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Host test of the load cell drift model (fw/load_cell_thermal.c) with synthetic
+ *  temperature sweeps: hourly idle points of an empty perch whose zero offset follows
+ *  the temperature linearly, plus ADC noise.
+ */
+
+#include "test.h"
+#include "load_cell_thermal.h"
+
+#define DEGC                32      // ADS1220 temperature units per degC
+#define DRIFT_PER_DEGC      40      // true offset drift, ADC counts per degC
+#define TRUE_SLOPE          (DRIFT_PER_DEGC * 256 / DEGC) // in the units of thermal_get_offset_slope()
+#define BASELINE            120000
+#define NOISE               20      // ADC counts, +-
+
+static uint32_t lcg = 1;
+
+static int32_t noise(int32_t amplitude)
+{
+    lcg = lcg * 1103515245U + 12345U;
+    return (int32_t)((lcg >> 16) % (2*amplitude + 1)) - amplitude;
+}
+
+static int32_t baseline_at(int16_t temperature, int32_t drift_per_degc)
+{
+    return BASELINE + (int32_t)temperature * drift_per_degc / DEGC + noise(NOISE);
+}
+
+// one night: cooling from t_high to t_low in 12 hourly steps
+static void night(int16_t t_high, int16_t t_low, int32_t drift_per_degc)
+{
+    int i;
+    for(i = 0; i < 12; i++)
+    {
+        int16_t t = t_high - (int32_t)(t_high - t_low) * i / 11;
+        thermal_add_idle_point(t, baseline_at(t, drift_per_degc));
+    }
+}
+
+static void sweep_finds_the_slope()
+{
+    int i;
+    for(i = 0; i < 20; i++)
+        night(15*DEGC, 5*DEGC, DRIFT_PER_DEGC);
+
+    CHECK_NEAR(thermal_get_offset_slope(), TRUE_SLOPE, TRUE_SLOPE/10);
+
+    thermal_set_reference(10*DEGC);
+    CHECK_NEAR(thermal_offset_drift(15*DEGC), 5*DRIFT_PER_DEGC, DRIFT_PER_DEGC/2);
+    CHECK_NEAR(thermal_offset_drift(5*DEGC), -5*DRIFT_PER_DEGC, DRIFT_PER_DEGC/2);
+    CHECK_EQ(thermal_offset_drift(10*DEGC), 0);
+
+    // compensated weight of a 1000 count load at 15 degC, tare taken at 10 degC
+    int32_t raw = baseline_at(15*DEGC, DRIFT_PER_DEGC) + 1000;
+    CHECK_NEAR(thermal_compensate(raw, BASELINE + 10*DRIFT_PER_DEGC, 15*DEGC), 1000, 3*NOISE);
+}
+
+// old points fade out: after many nights at a constant temperature, the spread of the
+// points in the fit is too small, and a baseline jump (not temperature related) must not
+// turn into a slope
+static void constant_temperature_keeps_the_slope()
+{
+    int i;
+    int32_t slope = thermal_get_offset_slope();
+
+    for(i = 0; i < 40; i++)
+        night(10*DEGC, 10*DEGC, DRIFT_PER_DEGC);
+    for(i = 0; i < 40; i++)
+    {
+        int16_t t = 10*DEGC + (i & 1); // jump of 3000 counts with 1/32 degC of temperature change
+        thermal_add_idle_point(t, BASELINE + 10*DRIFT_PER_DEGC + 3000*(i & 1));
+    }
+
+    CHECK_NEAR(thermal_get_offset_slope(), slope, TRUE_SLOPE/5);
+}
+
+// a new drift after a while: the model follows once the new points span enough temperature
+static void model_follows_a_new_drift()
+{
+    int i;
+    for(i = 0; i < 30; i++)
+        night(12*DEGC, 2*DEGC, 2*DRIFT_PER_DEGC);
+
+    CHECK_NEAR(thermal_get_offset_slope(), 2*TRUE_SLOPE, 2*TRUE_SLOPE/10);
+}
+
+int main()
+{
+    thermal_set_reference(10*DEGC);
+
+    // not enough points / temperature range yet
+    night(10*DEGC, 10*DEGC + 8, DRIFT_PER_DEGC);
+    CHECK_EQ(thermal_get_offset_slope(), 0);
+    CHECK_EQ(thermal_offset_drift(20*DEGC), 0);
+
+    sweep_finds_the_slope();
+    constant_temperature_keeps_the_slope();
+    model_follows_a_new_drift();
+
+    return test_summary("test_thermal");
+}
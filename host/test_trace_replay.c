@@ -0,0 +1,267 @@
+/*
+ * test_trace_replay.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: agent
+ *
+ *  Replay of a sensor capture (fw/trace.c, built with TRACE_REPLAY) as the SD card stores
+ *  it: the RFID capture timer edges go through rfid_decode_edge() of rfid_reader.c, the
+ *  raw load cell samples are averaged like ads1220_read_average() and split into segments
+ *  of constant weight by load_cell_segment.c ('G' entries).
+ *
+ *  The fixture traces/visit.txt is a capture of the simulated box (platform/sim.h) around
+ *  the perch visits of CAPTURE_SCENARIO, made with
+ *
+ *    test_trace_replay -c > traces/visit.txt
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "sim.h"
+#include "models.h"
+#include "scenario.h"
+#include "log_unpack.h"
+#include "trace.h"
+#include "rfid_reader.h"
+#include "load_cell_segment.h"
+#include "em4095_lib/EM4095.h"
+
+#define FIXTURE             "traces/visit.txt"
+#define COUNTS_PER_GRAM     1098.9  // box calibration of the simulation (platform/ads1220_sim.c)
+#define N_AVERAGES          10      // PARAM_N_AVERAGES default
+#define EVENT_GAP_MS        500     // samples further apart belong to another load cell poll
+#define MAX_IDS             16
+#define MAX_WEIGHTS         16
+
+// two birds, each visit in a capture of its own (the FRAM holds TRACE_BUF_SIZE bytes)
+#define CAPTURE_SCENARIO \
+    "start 2026-10-18 18:00:00\n" \
+    "duration 6m\n" \
+    "visit 1m 40s 59004529B6 162\n" \
+    "visit 4m 30s 580053A0AF 595 preening\n"
+
+static const struct {
+    uint64_t start_us, stop_us;
+} captures[] = {
+    { 55000000ULL, 80000000ULL },
+    { 235000000ULL, 260000000ULL },
+};
+
+// what the replay of each capture must find
+static const struct {
+    uint64_t tag;
+    double grams;
+    double tolerance;
+} expected[] = {
+    { 0x59004529B6ULL, 162, 1 },
+    { 0x580053A0AFULL, 595, 60 },   // preening: shifts its weight by up to 10 %
+};
+
+int nestbox_main(void);
+int __real_log_write_new_weight_entry(uint8_t logchar, uint32_t weight, uint16_t stdev);
+int16_t __real_em4095_read(mlx90109_t *dev, uint8_t input_bit);
+
+static int replaying = 0;
+
+static uint64_t ids[MAX_IDS];
+static int n_ids;
+static int32_t weights[MAX_WEIGHTS];
+static int n_weights;
+
+static int32_t zero;
+static int zero_valid;
+static int32_t avg_sum;
+static int avg_n;
+static uint32_t last_sample_ms;
+
+// the firmware logs as usual while capturing; the replay keeps the segments
+int __wrap_log_write_new_weight_entry(uint8_t logchar, uint32_t weight, uint16_t stdev)
+{
+    if(!replaying)
+        return __real_log_write_new_weight_entry(logchar, weight, stdev);
+    if(logchar == 'G' && n_weights < MAX_WEIGHTS)
+        weights[n_weights++] = weight;
+    return 0;
+}
+
+// a complete frame: the ID as rfid_Task() formats it
+int16_t __wrap_em4095_read(mlx90109_t *dev, uint8_t input_bit)
+{
+    int16_t ret = __real_em4095_read(dev, input_bit);
+
+    if(replaying && ret == MLX90109_DATA_OK)
+    {
+        tagdata tag;
+        em4100_format(dev, &tag);
+        if(n_ids == 0 || ids[n_ids - 1] != tag.tagId)
+        {
+            if(n_ids < MAX_IDS)
+                ids[n_ids++] = tag.tagId;
+        }
+    }
+    return ret;
+}
+
+// the capture starts with an empty perch: its first sample is the zero offset
+static void replay_sample(uint32_t ms, int32_t sample)
+{
+    if(!zero_valid)
+    {
+        zero = sample;
+        zero_valid = 1;
+    }
+    if(ms - last_sample_ms > EVENT_GAP_MS)
+    {
+        segment_flush();
+        avg_n = 0;
+        avg_sum = 0;
+    }
+    last_sample_ms = ms;
+
+    avg_sum += sample;
+    if(++avg_n == N_AVERAGES)
+    {
+        segment_add_sample(avg_sum / N_AVERAGES);
+        avg_n = 0;
+        avg_sum = 0;
+    }
+}
+
+static void capture_start(void *arg)
+{
+    (void)arg;
+    trace_start(TRACE_RFID | TRACE_LOADCELL);
+}
+
+static void capture_stop(void *arg)
+{
+    (void)arg;
+    trace_stop();
+}
+
+// runs the scenario and prints the traces the SD card received
+static int capture()
+{
+    struct scenario s;
+    const uint8_t *data;
+    const char *p;
+    char *text;
+    size_t n, len;
+    unsigned int i;
+
+    if(scenario_parse(&s, CAPTURE_SCENARIO) != 0)
+        return 2;
+    sim_set_fast_forward(1);
+    scenario_start(&s);
+    for(i = 0; i < sizeof(captures) / sizeof(captures[0]); i++)
+    {
+        sim_at(captures[i].start_us, capture_start, NULL);
+        sim_at(captures[i].stop_us, capture_stop, NULL);
+    }
+
+    nestbox_main();
+
+    data = (const uint8_t *)sd_logger_data(&n);
+    text = log_unpack(data, n, &len);
+    if(text == NULL)
+        return 2;
+    for(p = text; p != NULL && *p != '\0'; )
+    {
+        unsigned long t, bytes;
+        const char *next = strchr(p, '\n');
+        if(sscanf(p, "C,%lu,%lu", &t, &bytes) == 2)
+        {
+            // header line and one hex line per TRACE_LINE_BYTES (logger.c)
+            for(i = 0; next != NULL && i < (bytes + 31) / 32; i++)
+                next = strchr(next + 1, '\n');
+            if(next == NULL)
+                return 2;
+            fwrite(p, 1, next + 1 - p, stdout);
+        }
+        p = next != NULL ? next + 1 : NULL;
+    }
+    return 0;
+}
+
+static int hex_value(char c)
+{
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+// next trace of the fixture: the bytes of its hex lines; returns the length, -1 at the end
+static int read_trace(FILE *f, uint8_t *buf, unsigned int size)
+{
+    char line[256];
+    unsigned long t, bytes;
+    unsigned int len = 0;
+
+    while(fgets(line, sizeof(line), f) != NULL)
+        if(sscanf(line, "C,%lu,%lu", &t, &bytes) == 2)
+            break;
+    if(feof(f) || bytes > size)
+        return -1;
+    while(len < bytes && fgets(line, sizeof(line), f) != NULL)
+    {
+        const char *c;
+        for(c = line; hex_value(c[0]) >= 0 && hex_value(c[1]) >= 0 && len < bytes; c += 2)
+            buf[len++] = hex_value(c[0]) << 4 | hex_value(c[1]);
+    }
+    return len == bytes ? (int)len : -1;
+}
+
+static void replay(uint8_t *buf, int len)
+{
+    static const struct trace_replay_handler handler = {
+        rfid_decode_edge, NULL, replay_sample
+    };
+
+    n_ids = 0;
+    zero_valid = 0;
+    n_weights = 0;
+    avg_n = 0;
+    avg_sum = 0;
+    last_sample_ms = 0;
+    segment_reset();
+    CHECK_EQ(trace_replay(buf, len, &handler), len);
+    segment_flush();
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t buf[TRACE_BUF_SIZE];
+    FILE *f;
+    int len, n, i;
+
+    if(argc > 1 && strcmp(argv[1], "-c") == 0)
+        return capture();
+
+    f = fopen(FIXTURE, "r");
+    CHECK(f != NULL);
+    if(f == NULL)
+        return test_summary("test_trace_replay");
+    replaying = 1;
+
+    for(n = 0; (len = read_trace(f, buf, sizeof(buf))) >= 0; n++)
+    {
+        replay(buf, len);
+        if(n >= (int)(sizeof(expected) / sizeof(expected[0])))
+            continue;
+        CHECK_EQ(n_ids, 1);
+        CHECK_EQ(ids[0], expected[n].tag);
+        CHECK(n_weights > 0);
+        for(i = 0; i < n_weights; i++)
+            CHECK_NEAR((weights[i] - zero) / COUNTS_PER_GRAM, expected[n].grams, expected[n].tolerance);
+    }
+    CHECK_EQ(n, sizeof(expected) / sizeof(expected[0]));
+    fclose(f);
+
+    return test_summary("test_trace_replay");
+}
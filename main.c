@@ -42,6 +42,11 @@
 #include "fw/load_cell.h"
 #include "fw/battery_monitor.h"
 #include "fw/PIR_wakeup.h"
+#include "fw/params.h"
+#include "fw/stack_monitor.h"
+#include "fw/service_loop.h"
+#include "fw/clock_policy.h"
+#include "fw/deep_pause.h"
 
 /* Board Header file */
 #include "Board.h"
@@ -69,16 +74,24 @@ Char rfid_task_Stack[RFID_TASKSTACKSIZE];
 Task_Struct button_task_Struct;
 Char button_task_Stack[BUTTON_TASKSTACKSIZE];
 
+#if !USE_EVENT_LOOP
 // log task
 #define LOG_TASKSTACKSIZE   1024
 Task_Struct log_task_Struct;
 Char log_task_Stack[LOG_TASKSTACKSIZE];
+#endif
 
 // load cell task
 #define LOAD_CELL_TASKSTACKSIZE   765
 Task_Struct load_cell_task_Struct;
 Char load_cell_task_Stack[LOAD_CELL_TASKSTACKSIZE];
 
+#if USE_EVENT_LOOP
+// service task: battery, log and PIR (fw/service_loop.c)
+#define SERVICE_TASKSTACKSIZE   1024
+Task_Struct service_task_Struct;
+Char service_task_Stack[SERVICE_TASKSTACKSIZE];
+#else
 // battery task
 #define BATTERY_TASKSTACKSIZE   1024
 Task_Struct bat_task_Struct;
@@ -90,6 +103,7 @@ Char bat_task_Stack[BATTERY_TASKSTACKSIZE];
 Task_Struct pir_task_Struct;
 Char pir_task_Stack[PIR_TASKSTACKSIZE];
 #endif
+#endif
 
 /*
  *  ======== main ========
@@ -101,11 +115,15 @@ int main(void)
 #endif
     Task_Params rfid_taskParams;
     Task_Params button_taskParams;
-    Task_Params log_taskParams;
     Task_Params load_cell_taskParams;
+#if USE_EVENT_LOOP
+    Task_Params service_taskParams;
+#else
+    Task_Params log_taskParams;
     Task_Params bat_taskParams;
 #if USE_PIR
     Task_Params pir_taskParams;
+#endif
 #endif
 
     // disable interrupts if an interrupt could lead to
@@ -126,6 +144,10 @@ int main(void)
     Board_initSPI();
     Board_initUART();
     // Board_initWatchdog();
+    deep_pause_init(); // warm boot after a pause in LPM3.5?
+
+    params_init(); // tuning parameters from FRAM
+    clock_policy_init(); // slow MCLK until RFID, SD card or wifi need the full speed
 
 #ifdef LIGHTBARRIER_VERSION
     /* Construct ligthBarrier Task  thread */
@@ -134,6 +156,7 @@ int main(void)
 	lb_taskParams.stack = &lb_task_Stack;
 	lb_taskParams.priority = 2;
 	Task_construct(&lb_task_Struct, (Task_FuncPtr)lightBarrier_Task, &lb_taskParams, NULL);
+	stack_monitor_add('B', Task_handle(&lb_task_Struct));
 #endif
 
 	/* Construct rfidReader Task  thread */
@@ -142,6 +165,7 @@ int main(void)
 	rfid_taskParams.stack = &rfid_task_Stack;
 	rfid_taskParams.priority = 1; // <--- MUST HAVE LOWER PRIORITY, OTHERWISE THE SPI POLLING MAY GET IT STUCK AND HANG OTHER TASKS.
 	Task_construct(&rfid_task_Struct, (Task_FuncPtr)rfid_Task, &rfid_taskParams, NULL);
+	stack_monitor_add('R', Task_handle(&rfid_task_Struct));
 
 	/* Construct userButton Task  thread */
 	Task_Params_init(&button_taskParams);
@@ -149,13 +173,7 @@ int main(void)
 	button_taskParams.stack = &button_task_Stack;
 	button_taskParams.priority = 3;
 	Task_construct(&button_task_Struct, (Task_FuncPtr)user_button_Task, &button_taskParams, NULL);
-
-	/* Construct logging Task  thread */
-	Task_Params_init(&log_taskParams);
-	log_taskParams.stackSize = LOG_TASKSTACKSIZE;
-	log_taskParams.stack = &log_task_Stack;
-	log_taskParams.priority = 4;
-	Task_construct(&log_task_Struct, (Task_FuncPtr)log_Task, &log_taskParams, NULL);
+	stack_monitor_add('U', Task_handle(&button_task_Struct));
 
 	/* Construct load cell Task  thread */
 	Task_Params_init(&load_cell_taskParams);
@@ -163,6 +181,24 @@ int main(void)
 	load_cell_taskParams.stack = &load_cell_task_Stack;
 	load_cell_taskParams.priority = 2; //
 	Task_construct(&load_cell_task_Struct, (Task_FuncPtr)load_cell_Task, &load_cell_taskParams, NULL);
+	stack_monitor_add('W', Task_handle(&load_cell_task_Struct));
+
+#if USE_EVENT_LOOP
+	/* Construct service Task  thread (battery, log, PIR) */
+	Task_Params_init(&service_taskParams);
+	service_taskParams.stackSize = SERVICE_TASKSTACKSIZE;
+	service_taskParams.stack = &service_task_Stack;
+	service_taskParams.priority = 5;
+	Task_construct(&service_task_Struct, (Task_FuncPtr)service_Task, &service_taskParams, NULL);
+	stack_monitor_add('S', Task_handle(&service_task_Struct));
+#else
+	/* Construct logging Task  thread */
+	Task_Params_init(&log_taskParams);
+	log_taskParams.stackSize = LOG_TASKSTACKSIZE;
+	log_taskParams.stack = &log_task_Stack;
+	log_taskParams.priority = 4;
+	Task_construct(&log_task_Struct, (Task_FuncPtr)log_Task, &log_taskParams, NULL);
+	stack_monitor_add('L', Task_handle(&log_task_Struct));
 
 	/* Construct battery monitoring Task  thread */
 	Task_Params_init(&bat_taskParams);
@@ -170,6 +206,7 @@ int main(void)
 	bat_taskParams.stack = &bat_task_Stack;
 	bat_taskParams.priority = 5; //most important task, but with low duty cycle
 	Task_construct(&bat_task_Struct, (Task_FuncPtr)battery_Task, &bat_taskParams, NULL);
+	stack_monitor_add('V', Task_handle(&bat_task_Struct));
 
 #if USE_PIR
 	/* Construct battery monitoring Task  thread */
@@ -178,6 +215,8 @@ int main(void)
     pir_taskParams.stack = &pir_task_Stack;
     pir_taskParams.priority = 5; //most important task, but with low duty cycle
     Task_construct(&pir_task_Struct, (Task_FuncPtr)PIR_wakeup_Task, &pir_taskParams, NULL);
+    stack_monitor_add('P', Task_handle(&pir_task_Struct));
+#endif
 #endif
     /* Start BIOS */
     BIOS_start();
@@ -49,6 +49,7 @@
 #include <gpio.h>
 #include <nestbox_init.h>
 #include <pmm.h>
+#include <cs.h>
 #include <wdt_a.h>
 
 #include <ti/drivers/SPI.h>
@@ -361,6 +362,8 @@ const UARTEUSCIA_BaudrateConfig uartEUSCIABaudrates[] = {
         .hwRegUCBRSx = 85,
         .oversampling = 1
     },
+    {230400, 8000000,  2, 2, 187, 1},
+    {460800, 8000000, 17, 0,  74, 0},
     {9600, 8000000, 52, 1, 0, 1},
     {9600,   32768,  3, 0, 3, 0},
 };
@@ -396,6 +399,54 @@ const UART_Config UART_config[] = {
     {NULL, NULL, NULL}
 };
 
+/*
+ *  ======== nbox_uart_baudrate_supported ========
+ */
+int nbox_uart_baudrate_supported(unsigned long baudrate)
+{
+    unsigned int i;
+    unsigned long smclk = CS_getSMCLK();
+
+    for(i = 0; i < sizeof(uartEUSCIABaudrates)/sizeof(UARTEUSCIA_BaudrateConfig); i++)
+    {
+        if(uartEUSCIABaudrates[i].outputBaudrate == baudrate &&
+           uartEUSCIABaudrates[i].inputClockFreq == smclk)
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ *  ======== nbox_uart_tx_pin ========
+ */
+void nbox_uart_tx_pin(nbox_UARTName uart, int enable)
+{
+    // UART0 (ESP): TX on P2.0, UART1 (debug / SD logger): TX on P2.5
+    unsigned char pin = (uart == nbox_UARTA0) ? BIT0 : BIT5;
+
+    if(enable)
+    {
+        P2OUT |= pin;
+        P2SEL1 |= pin;
+    }
+    else
+    {
+        P2OUT &= ~pin;
+        P2SEL1 &= ~pin;
+    }
+}
+
+/*
+ *  ======== nbox_wifi_sense_edge ========
+ */
+void nbox_wifi_sense_edge(int falling)
+{
+    if(falling)
+        P1IES |= BIT0;
+    else
+        P1IES &= ~BIT0;
+}
+
 /*
  *  ======== nbox_initUART ========
  */
@@ -66,6 +66,12 @@ extern "C" {
 
 #define USE_PIR     0 // define as 0 or 1!
 #define USE_LB      0 // define as 0 or 1!
+#ifndef USE_EVENT_LOOP
+#define USE_EVENT_LOOP  0 // define as 0 or 1! 1: battery, log and PIR run in one service task (fw/service_loop.c)
+#endif
+#ifndef USE_DEEP_PAUSE
+#define USE_DEEP_PAUSE  0 // define as 0 or 1! 1: daytime pause in LPM3.5 with warm restart (fw/deep_pause.c)
+#endif
 
 /* LEDs on nestbox_board are active high. */
 #define nbox_LED_OFF (0)
@@ -199,6 +205,30 @@ extern void nbox_initSPI(void);
  */
 extern void nbox_initUART(void);
 
+/*!
+ *  @brief  Check if a UART baudrate can be generated from the current SMCLK
+ *
+ *  Returns 1 if uartEUSCIABaudrates has an entry for the given baudrate and
+ *  the SMCLK frequency the clock system is running at, 0 otherwise.
+ */
+extern int nbox_uart_baudrate_supported(unsigned long baudrate);
+
+/*!
+ *  @brief  Connect or disconnect the TX pin of a UART
+ *
+ *  enable = 1 hands the TX pin to the eUSCI module (idle high), enable = 0
+ *  makes it a low GPIO so no current flows into a powered down peer.
+ */
+extern void nbox_uart_tx_pin(nbox_UARTName uart, int enable);
+
+/*!
+ *  @brief  Select the edge of the wifi sense interrupt
+ *
+ *  falling = 1: interrupt when the wifi module is switched off,
+ *  falling = 0: interrupt when it is switched on.
+ */
+extern void nbox_wifi_sense_edge(int falling);
+
 /*!
  *  @brief  Initialize board specific Watchdog settings
  *